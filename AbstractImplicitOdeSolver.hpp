@@ -0,0 +1,341 @@
+/*
+ * AbstractImplicitOdeSolver.hpp
+ *
+ * Shared machinery for the implicit (stiff) solvers: Jacobians, the Newton iteration and reuse of
+ * the factorised iteration matrix between steps
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef ABSTRACTIMPLICITODESOLVER_HPP_
+#define ABSTRACTIMPLICITODESOLVER_HPP_
+
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+#include "AbstractOdeSolver.hpp"
+#include "Jacobian.hpp"
+
+/** Passed as the Jacobian to the implicit solvers to have them use finite differences */
+struct FiniteDifferenceJacobian {};
+
+/**
+ * AbstractImplicitOdeSolverT adds to AbstractOdeSolverT what the implicit solvers need:
+ *  * An optional analytic Jacobian jacobian(v, t, J), set like the right-hand side.  Without one,
+ *    the Jacobian is approximated by forward differences (DIMENSION+1 right-hand side evaluations)
+ *  * Each Jacobian, and the LU factorisation of I - coefficient*J, is kept for later steps.  It is
+ *    only re-evaluated when it is older than the reuse limit or when the Newton iteration fails
+ *    to converge with it, and only refactorised when the coefficient (i.e. the time-step) changes
+ *  * A Newton iteration for an implicit stage y = a + coefficient*f(t, y)
+ *
+ * The derived classes set the time-stepping formula in TakeStep(rhs, jacobian, t, dt, v).
+ */
+template<class STATE>
+class AbstractImplicitOdeSolverT: public AbstractOdeSolverT<STATE>
+{
+private:
+    /**
+     * Gives the fixed time-step loop a TakeStep(rhs, t, dt, v) that passes the Jacobian through to
+     * the solver's TakeStep(rhs, jacobian, t, dt, v)
+     */
+    template<class SOLVER, class JACOBIAN>
+    struct StepperWithJacobian
+    {
+        SOLVER& rSolver;
+        JACOBIAN& rJacobian;
+
+        template<class RHS>
+        void TakeStep(RHS& rRhs, double t, double dt, STATE& v) const
+        {
+            rSolver.TakeStep(rRhs, rJacobian, t, dt, v);
+        }
+    };
+
+    /** Scaled size of a Newton update: at most one when it is within the tolerance */
+    double NewtonUpdateNorm(const STATE& rUpdate, const STATE& rValues) const;
+
+protected:
+    /** Analytic Jacobian function pointer (or NULL for finite differences) */
+    void (* mpJacobianFunction)(const STATE&, double, JacobianT<STATE>&);
+
+    /** Newton iterations stop when every component of the update is below this (relative to the value) */
+    double mNewtonTolerance;
+    /** Iterations tried by the simplified Newton iteration, and then by the full one */
+    int mMaximumNumberOfNewtonIterations;
+    /** Number of steps a Jacobian is kept for */
+    int mMaximumJacobianAge;
+
+    /** The current Jacobian */
+    JacobianT<STATE> mJacobian;
+    /** Steps taken since mJacobian was evaluated (or -1 if there isn't one) */
+    int mJacobianAge;
+    /** LU factorisation of I - mFactorisedCoefficient*mJacobian */
+    LuFactorisationT<STATE> mIterationMatrix;
+    /** Coefficient in the current factorisation (or 0 if there isn't one) */
+    double mFactorisedCoefficient;
+
+    /** Work counters for the last solve */
+    int mNumberOfJacobianEvaluations;
+    int mNumberOfFactorisations;
+    int mNumberOfNewtonIterations;
+
+    /**
+     * Runs the fixed time-step loop with rSolver.TakeStep(rhs, jacobian, t, dt, v), starting each
+     * solve without a Jacobian
+     */
+    template<class SOLVER, class RHS, class JACOBIAN>
+    void RunImplicitTimeSteps(SOLVER& rSolver, RHS& rRhs, JACOBIAN& rJacobian);
+
+    /** Evaluate mJacobian at (v, t) with the analytic Jacobian */
+    template<class RHS, class JACOBIAN>
+    void EvaluateJacobian(RHS& rRhs, JACOBIAN& rJacobian, double t, const STATE& v);
+
+    /** Evaluate mJacobian at (v, t) by forward differences of the right-hand side */
+    template<class RHS>
+    void EvaluateJacobian(RHS& rRhs, FiniteDifferenceJacobian& rJacobian, double t, const STATE& v);
+
+    /**
+     * Called at the start of each step: evaluates the Jacobian at (v, t) if there isn't one or it
+     * has been used for too many steps
+     */
+    template<class RHS, class JACOBIAN>
+    void UpdateJacobian(RHS& rRhs, JACOBIAN& rJacobian, double t, const STATE& v);
+
+    /** Make sure mIterationMatrix is the factorisation of I - coefficient*mJacobian */
+    void FactoriseIterationMatrix(double coefficient);
+
+    /**
+     * Solve y = rExplicitPart + coefficient*f(t, y) for y, starting from the guess in y.  This is a
+     * simplified Newton iteration with the current Jacobian; if that doesn't converge (or diverges),
+     * it is restarted as a full Newton iteration with the Jacobian re-evaluated at every iterate.
+     * Throws if that doesn't converge either.
+     */
+    template<class RHS, class JACOBIAN>
+    void SolveImplicitStage(RHS& rRhs, JACOBIAN& rJacobian, double t, double coefficient,
+                            const STATE& rExplicitPart, STATE& y);
+
+public:
+    AbstractImplicitOdeSolverT();
+    virtual ~AbstractImplicitOdeSolverT() {}
+
+    /** Set the analytic Jacobian function: J(i, j) = d(dvdt[i])/d(v[j]) */
+    void SetJacobianFunction(void (*pFunctionName)(const STATE&, double, JacobianT<STATE>&));
+
+    /** Set the Newton tolerance (default 1e-10).  Throws unless it is positive */
+    void SetNewtonTolerance(double tolerance);
+
+    /**
+     * Set the iterations tried by the simplified Newton iteration, and then by the full one, before
+     * giving up (default 7).  Throws unless it is positive.
+     */
+    void SetMaximumNumberOfNewtonIterations(int iterations);
+
+    /**
+     * Keep each Jacobian for at most this many steps (default 20; 1 evaluates it at every step).
+     * Throws unless it is positive.
+     */
+    void SetMaximumJacobianAge(int steps);
+
+    /** Number of Jacobian evaluations in the last solve */
+    int GetNumberOfJacobianEvaluations() const;
+
+    /** Number of LU factorisations in the last solve */
+    int GetNumberOfFactorisations() const;
+
+    /** Number of Newton iterations in the last solve (0 for the Rosenbrock method, which has none) */
+    int GetNumberOfNewtonIterations() const;
+};
+
+template<class STATE>
+AbstractImplicitOdeSolverT<STATE>::AbstractImplicitOdeSolverT()
+{
+    mpJacobianFunction = NULL;
+    mNewtonTolerance = 1e-10;
+    mMaximumNumberOfNewtonIterations = 7;
+    mMaximumJacobianAge = 20;
+    mJacobianAge = -1;
+    mFactorisedCoefficient = 0.0;
+    mNumberOfJacobianEvaluations = 0;
+    mNumberOfFactorisations = 0;
+    mNumberOfNewtonIterations = 0;
+}
+
+template<class STATE>
+void AbstractImplicitOdeSolverT<STATE>::SetJacobianFunction(void (*pFunctionName)(const STATE&, double, JacobianT<STATE>&))
+{
+    mpJacobianFunction = pFunctionName;
+}
+
+template<class STATE>
+void AbstractImplicitOdeSolverT<STATE>::SetNewtonTolerance(double tolerance)
+{
+    if (!(tolerance > 0.0))
+    {
+        throw Exception("OdeSetup", "Newton tolerance should be positive");
+    }
+    mNewtonTolerance = tolerance;
+}
+
+template<class STATE>
+void AbstractImplicitOdeSolverT<STATE>::SetMaximumNumberOfNewtonIterations(int iterations)
+{
+    if (iterations <= 0)
+    {
+        throw Exception("OdeSetup", "Maximum number of Newton iterations should be positive");
+    }
+    mMaximumNumberOfNewtonIterations = iterations;
+}
+
+template<class STATE>
+void AbstractImplicitOdeSolverT<STATE>::SetMaximumJacobianAge(int steps)
+{
+    if (steps <= 0)
+    {
+        throw Exception("OdeSetup", "Maximum Jacobian age should be positive");
+    }
+    mMaximumJacobianAge = steps;
+}
+
+template<class STATE>
+int AbstractImplicitOdeSolverT<STATE>::GetNumberOfJacobianEvaluations() const
+{
+    return mNumberOfJacobianEvaluations;
+}
+
+template<class STATE>
+int AbstractImplicitOdeSolverT<STATE>::GetNumberOfFactorisations() const
+{
+    return mNumberOfFactorisations;
+}
+
+template<class STATE>
+int AbstractImplicitOdeSolverT<STATE>::GetNumberOfNewtonIterations() const
+{
+    return mNumberOfNewtonIterations;
+}
+
+template<class STATE>
+double AbstractImplicitOdeSolverT<STATE>::NewtonUpdateNorm(const STATE& rUpdate, const STATE& rValues) const
+{
+    double norm = 0.0;
+    for (int i=0; i<STATE::DIMENSION; i++)
+    {
+        norm = std::max(norm, fabs(rUpdate[i])/(mNewtonTolerance*(1.0 + fabs(rValues[i]))));
+    }
+    return norm;
+}
+
+template<class STATE>
+template<class SOLVER, class RHS, class JACOBIAN>
+void AbstractImplicitOdeSolverT<STATE>::RunImplicitTimeSteps(SOLVER& rSolver, RHS& rRhs, JACOBIAN& rJacobian)
+{
+    mJacobianAge = -1;
+    mFactorisedCoefficient = 0.0;
+    mNumberOfJacobianEvaluations = 0;
+    mNumberOfFactorisations = 0;
+    mNumberOfNewtonIterations = 0;
+
+    StepperWithJacobian<SOLVER, JACOBIAN> stepper = {rSolver, rJacobian};
+    // Jacobians (and BDF2's previous step) are kept between steps, so no checkpoints
+    this->RunFixedTimeSteps(stepper, rRhs, false);
+}
+
+template<class STATE>
+template<class RHS, class JACOBIAN>
+void AbstractImplicitOdeSolverT<STATE>::EvaluateJacobian(RHS& rRhs, JACOBIAN& rJacobian, double t, const STATE& v)
+{
+    rJacobian(v, t, mJacobian);
+}
+
+template<class STATE>
+template<class RHS>
+void AbstractImplicitOdeSolverT<STATE>::EvaluateJacobian(RHS& rRhs, FiniteDifferenceJacobian& rJacobian, double t, const STATE& v)
+{
+    STATE f, f_perturbed;
+    rRhs(v, t, f);
+    for (int j=0; j<STATE::DIMENSION; j++)
+    {
+        // Perturb by about the square root of the rounding error in v[j]
+        STATE v_perturbed = v;
+        v_perturbed[j] += sqrt(DBL_EPSILON)*std::max(1.0, fabs(v[j]));
+        double delta = v_perturbed[j] - v[j];
+        rRhs(v_perturbed, t, f_perturbed);
+        for (int i=0; i<STATE::DIMENSION; i++)
+        {
+            mJacobian(i, j) = (f_perturbed[i] - f[i])/delta;
+        }
+    }
+}
+
+template<class STATE>
+template<class RHS, class JACOBIAN>
+void AbstractImplicitOdeSolverT<STATE>::UpdateJacobian(RHS& rRhs, JACOBIAN& rJacobian, double t, const STATE& v)
+{
+    if (mJacobianAge < 0 || mJacobianAge >= mMaximumJacobianAge)
+    {
+        EvaluateJacobian(rRhs, rJacobian, t, v);
+        mNumberOfJacobianEvaluations++;
+        mJacobianAge = 0;
+        mFactorisedCoefficient = 0.0;
+    }
+    mJacobianAge++;
+}
+
+template<class STATE>
+void AbstractImplicitOdeSolverT<STATE>::FactoriseIterationMatrix(double coefficient)
+{
+    if (coefficient != mFactorisedCoefficient)
+    {
+        mIterationMatrix.Factorise(mJacobian, coefficient);
+        mNumberOfFactorisations++;
+        mFactorisedCoefficient = coefficient;
+    }
+}
+
+template<class STATE>
+template<class RHS, class JACOBIAN>
+void AbstractImplicitOdeSolverT<STATE>::SolveImplicitStage(RHS& rRhs, JACOBIAN& rJacobian, double t, double coefficient,
+                                                          const STATE& rExplicitPart, STATE& y)
+{
+    const STATE initial_guess = y;
+    STATE f, update;
+    // Try the simplified iteration with the current Jacobian first, then the full iteration
+    for (int full_newton=0; full_newton<2; full_newton++)
+    {
+        y = initial_guess;
+        double previous_norm = HUGE_VAL;
+        for (int iteration=0; iteration<mMaximumNumberOfNewtonIterations; iteration++)
+        {
+            if (full_newton)
+            {
+                EvaluateJacobian(rRhs, rJacobian, t, y);
+                mNumberOfJacobianEvaluations++;
+                mJacobianAge = 1;
+                mFactorisedCoefficient = 0.0;
+            }
+            FactoriseIterationMatrix(coefficient);
+
+            // Newton update: (I - coefficient*J) update = a + coefficient*f(t, y) - y
+            rRhs(y, t, f);
+            update = rExplicitPart + f*coefficient - y;
+            mIterationMatrix.Solve(update);
+            y += update;
+            mNumberOfNewtonIterations++;
+
+            double norm = NewtonUpdateNorm(update, y);
+            if (norm <= 1.0)
+            {
+                return;
+            }
+            if (!(norm < previous_norm) && !full_newton)
+            {
+                break; // Diverging (or not a number)
+            }
+            previous_norm = norm;
+        }
+    }
+    throw Exception("OdeSolve", "The Newton iteration did not converge.  Please try a smaller time step");
+}
+
+#endif /* ABSTRACTIMPLICITODESOLVER_HPP_ */
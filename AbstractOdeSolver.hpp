@@ -8,110 +8,275 @@
 
 #include <string>
 #include <cmath>
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdint.h>
 #include <vector> // STL container for arbitrary length traces
 #include "Exception.hpp"
+#include "State.hpp"
+#include "DenseOutput.hpp"
+#include "Checkpoint.hpp"
+#include "OdeObservers.hpp"
+#include "SolverStats.hpp"
+#include "TraceView.hpp"
+#include "TraceFile.hpp"
+#include "PagedTrace.hpp"
 
 #ifndef ABSTRACTODESOLVER_HPP_
 #define ABSTRACTODESOLVER_HPP_
 
 /**
- * Pair is a "struct".  This is just like a class but with just public data items.
- *
- * This is because it's arguably easier to read
- *          dvdt.x = f(v.x, v.y, t)
- * than
- *          dxdt[0] = f(x[0], x[1], t)
+ * The stored traces, handed over by TakeTrace().  The solution is in either solution (the default
+ * array-of-states layout) or components (the structure-of-arrays layout, one vector per component).
  */
-struct Pair
+template<class STATE>
+struct SolutionTraceT
 {
-    double x; ///< named x variable for convenience
-    double y; ///< y
-
-    // ADAM: added operators and constructor to make solver code cleaner
-    Pair(double x=0.0, double y=0.0) : x(x), y(y) {}
-
-    Pair& operator=(const Pair& a) {
-    	x = a.x;
-    	y = a.y;
-    	return *this;
-    }
-
-    Pair operator+(const Pair& a) const {
-    	return Pair(a.x+x, a.y+y);
-    }
-
-    Pair& operator+=(const Pair& a) {
-        x += a.x;
-        y += a.y;
-        return *this;
-    }
-
-    Pair& operator*=(const Pair& a) {
-        x *= a.x;
-        y *= a.y;
-        return *this;
-    }
-
-    Pair operator*(const Pair& a) const {
-    	return Pair(a.x*x, a.y*y);
-    }
-
-    Pair operator/(const Pair& a) const {
-    	return Pair(a.x/x, a.y/y);
-    }
-
-    Pair operator*(const double& a) const {
-    	return Pair(a*x, a*y);
-    }
+    std::vector<double> times;
+    std::vector<STATE> solution;
+    std::vector<typename STATE::ValueType> components[STATE::DIMENSION];
+};
 
-    Pair operator/(const double& a) const {
-    	return Pair(x/a, y/a);
-    }
+/** An event found during a solve: which event function changed sign, when, and the solution then */
+template<class STATE>
+struct EventRecordT
+{
+    int eventIndex;
+    double time;
+    STATE values;
 };
 
 /**
- * AbstractOdeSolver does all the administration work of setting up a 2-D initial value problem ODE.
+ * AbstractOdeSolverT does all the administration work of setting up an initial value problem ODE.
  *  * Sets up initial conditions
  *  * Sets handle to a "right-hand side" function
  *  * Sets time stepper range
  *  * Provides storage and access for output
  *  * DOES NOT solve the ODE
+ *
+ * It is templated over the state type (e.g. State<3>) so that the same solvers work for any number
+ * of variables, and in single or mixed precision (e.g. State<3, float>, see State).  The traces
+ * keep the solution in the state's precision.  AbstractOdeSolver is the original 2-D (Pair) version.
  */
-class AbstractOdeSolver
+template<class STATE>
+class AbstractOdeSolverT
 {
 private:
     void CheckSolution() const;
 
+    /** Number of time-points in the stored traces, whichever way they are stored */
+    uint64_t GetNumberOfStoredPoints() const;
+
+    /** The stored time and solution at time-point i, whichever way they are stored */
+    double GetStoredTime(uint64_t i) const;
+    STATE GetStoredValues(uint64_t i) const;
+
+    /** Throws if the traces are paged, for the post-processing that needs them contiguous */
+    void CheckNotPaged() const;
+
 protected:
     /** Initial conditions for system at start time */
-     Pair mInitialValues;
+     STATE mInitialValues;
 
     /** Time-step or dt or delta t */
     double mTimeStepSize;
     /** Initial time */
     double mStartTime;
     // We don't explicitly store the final time: double mFinalTime
-    /** Number of time steps (of size dt) needed to get us to the final time */
-    int mNumberOfTimeSteps;
+    /** Number of time steps (of size dt) needed to get us to the final time (64-bit, for very long solves) */
+    int64_t mNumberOfTimeSteps;
 
     /** Righthand side function pointer */
-    void (* mpRhsFunction)(const Pair&, double, Pair&);
+    void (* mpRhsFunction)(const STATE&, double, STATE&);
 
     /** Time value for each time-point - calculated during solve */
     std::vector<double> mTimeTrace;
-    /** Solution pair value for each time-point - calculated during solve */
-    std::vector<Pair> mSolutionTrace;
+    /** Solution state value for each time-point - calculated during solve */
+    std::vector<STATE> mSolutionTrace;
+
+    /** Solution for each time-point stored one vector per component - used instead of mSolutionTrace in structure-of-arrays mode */
+    std::vector<typename STATE::ValueType> mComponentTraces[STATE::DIMENSION];
+
+    /**
+     * The traces stored in pages rather than in the vectors above (see SetPagedTrace()).  NULL
+     * unless paged traces have been asked for.
+     */
+    std::unique_ptr<PagedTraceT<double> > mpPagedTimeTrace;
+    std::unique_ptr<PagedTraceT<STATE> > mpPagedSolutionTrace;
+
+    /** Whether Solve() keeps the time and solution traces (otherwise only the observers see the solution) */
+    bool mStoreTrace;
+
+    /** Whether the solution is stored structure-of-arrays (mComponentTraces) rather than as states (mSolutionTrace) */
+    bool mStructureOfArrays;
+
+    /** Whether Solve() keeps an interpolant over every step for Evaluate() */
+    bool mDenseOutput;
+
+    /** The interpolants from the last solve (if mDenseOutput is set and the solver supports it) */
+    DenseOutputT<STATE> mDenseOutputData;
+
+    /** Observers to be told about every step (not owned by the solver) */
+    std::vector<AbstractOdeObserverT<STATE>*> mObservers;
+
+    /** An event function g(v, t), the direction of the crossings that count, and when to stop */
+    struct EventFunction
+    {
+        std::function<double(const STATE&, double)> function;
+        int direction;
+        int terminalCount;
+    };
+    std::vector<EventFunction> mEventFunctions;
+
+    /** Each event function's value at the end of the last step, and its number of events so far */
+    std::vector<double> mEventValues;
+    std::vector<int> mEventCounts;
+
+    /** The events found in the last solve, in time order */
+    std::vector<EventRecordT<STATE> > mEvents;
+
+    /** Whether the last solve was stopped early by a terminal event */
+    bool mStoppedByEvent;
+
+    /** Where to write checkpoints, and every how many steps (zero for never) */
+    std::string mCheckpointFileName;
+    int64_t mCheckpointInterval;
+
+    /** Whether the next solve carries on from a checkpoint, and where from */
+    bool mResuming;
+    int64_t mResumeStepIndex;
+    double mResumeTime;
+    STATE mResumeValues;
+    std::vector<uint64_t> mResumeObserverPositions;
+
+    /** Instrumentation for the last solve (see SolverStats.hpp) */
+    SolverStatsRecorder mStats;
+
+    /** Memory currently held by the trace vectors */
+    std::size_t GetTraceCapacityBytes() const;
+
+    /**
+     * Clears the traces, tells the observers a solve is starting and records the initial values.
+     * Fixed-step solvers (fixedSteps) have room reserved for all their time-steps; for adaptive
+     * solvers the number of steps isn't known, so the traces grow as they go.  When resuming from
+     * a checkpoint t and rValues are the checkpoint's, and the observers are told to carry on from
+     * there instead.  Throws if checkpointing is asked for but the solver doesn't support it.
+     */
+    void BeginRecording(double t, const STATE& rValues, bool supportsCheckpoints=false, bool fixedSteps=true);
+
+    /**
+     * Looks for events in the step from startTime to endTime, over which the solution is given by
+     * the interpolant with numberOfCoefficients coefficients (see DenseOutputT), and rEndValues at
+     * the end.  Sign changes of the event functions are located by Illinois (modified regula falsi)
+     * root-finding on the interpolant, and recorded in time order.  Returns true if a terminal event
+     * has stopped the solve, setting rStopTime and rStopValues to when and where.
+     */
+    bool LocateEvents(double startTime, double endTime, const STATE* pInterpolant, int numberOfCoefficients,
+                      const STATE& rEndValues, double& rStopTime, STATE& rStopValues);
+
+    /** Writes a checkpoint after stepIndex steps, at time t with values rValues */
+    void WriteCheckpoint(int64_t stepIndex, double t, const STATE& rValues);
+
+    /** Appends to a trace, noting the memory held by both blocks if it has to be reallocated */
+    template<class T>
+    void PushToTrace(std::vector<T>& rTrace, const T& rValue)
+    {
+        if (rTrace.size() == rTrace.capacity())
+        {
+            const std::size_t old_bytes = rTrace.capacity()*sizeof(T);
+            rTrace.push_back(rValue);
+            mStats.NoteTraceBytes(GetTraceCapacityBytes() + old_bytes);
+        }
+        else
+        {
+            rTrace.push_back(rValue);
+        }
+    }
+
+    /** Records a time-point in the traces (if they are stored) and passes it to the observers */
+    void RecordStep(double t, const STATE& rValues)
+    {
+        mStats.CountStep(mStoreTrace && !mpPagedTimeTrace && mTimeTrace.size() == mTimeTrace.capacity());
+        if (mStoreTrace)
+        {
+            if (mpPagedTimeTrace)
+            {
+                mpPagedTimeTrace->push_back(t);
+                mpPagedSolutionTrace->push_back(rValues);
+            }
+            else
+            {
+                PushToTrace(mTimeTrace, t);
+                if (mStructureOfArrays)
+                {
+                    for (int j=0; j<STATE::DIMENSION; j++)
+                    {
+                        PushToTrace(mComponentTraces[j], ValueType(rValues[j]));
+                    }
+                }
+                else
+                {
+                    PushToTrace(mSolutionTrace, rValues);
+                }
+            }
+        }
+        for (unsigned i=0; i<mObservers.size(); i++)
+        {
+            mObservers[i]->ObserveStep(t, rValues);
+        }
+    }
+
+    /** Tells the observers the solve is finished */
+    void EndRecording();
+
+    /**
+     * The fixed time-step loop shared by the one-step solvers.  rStepper.TakeStep(rRhs, t, dt, v) must
+     * advance v from time t to t+dt, calling rRhs(v, t, dvdt) for the right-hand side.  Both are
+     * template parameters so that the right-hand side can be inlined into the stages.  With dense
+     * output the right-hand side is also evaluated at the end of every step, for the cubic Hermite
+     * interpolant over the step.  Steppers that keep nothing between steps (so that a solve can
+     * carry on bit-identically from just the time and the values) support checkpoints.
+     */
+    template<class STEPPER, class RHS>
+    void RunFixedTimeSteps(const STEPPER& rStepper, RHS& rRhs, bool supportsCheckpoints=true);
+
+    /**
+     * Time-point stepIndex of the fixed-step solvers, start time + stepIndex*dt, worked out in the
+     * state's time precision.  It is worked out afresh each step rather than accumulated, so even
+     * in single precision the error doesn't grow with the number of steps.
+     */
+    double GetStepTime(int64_t stepIndex) const
+    {
+        typedef typename STATE::TimeType TIME;
+        return TIME(mStartTime) + TIME(stepIndex)*TIME(mTimeStepSize);
+    }
 
 public:
+    /** The type of the solution at each time-point */
+    typedef STATE StateType;
+
+    /** The type of its components (double, or float for single and mixed precision) */
+    typedef typename STATE::ValueType ValueType;
+
     /** Default constructor - makes sure that things are initialised to unset values */
-    AbstractOdeSolver();
+    AbstractOdeSolverT();
+
+    /** Virtual destructor, since we hold derived solvers through base pointers */
+    virtual ~AbstractOdeSolverT() {}
 
     /** Allow testing class to see some internals **/
     friend class TestOdeSolvers;
 
-    /** Initial conditions */
+    /** Initial conditions (2-D systems only) */
     void SetInitialValues(double x, double y);
 
+    /** Initial conditions */
+    void SetInitialValues(const STATE& initialValues);
+
     /** Set the bounds on the times.
      *  The time interval (and the time-step delta) can be negative.
      *  Throws if we can't get to the end time in a whole number of time-steps
@@ -122,13 +287,116 @@ public:
      *  The time interval (and the time-step delta) can be negative.
      *  Throws if there's no time-interval or steps is not positive
      */
-    void SetInitialTimeNumberOfStepsAndFinalTime(double startTime, int steps, double endTime);
+    void SetInitialTimeNumberOfStepsAndFinalTime(double startTime, int64_t steps, double endTime);
 
     /**
      * Set the righthand side (dx/dt) function
      */
-    void SetRhsFunction(void (*pFunctionName)(const Pair&, double, Pair&) );
+    void SetRhsFunction(void (*pFunctionName)(const STATE&, double, STATE&) );
+
+    /**
+     * Choose whether Solve() stores the whole time and solution traces (the default).  Without
+     * them memory use doesn't grow with the number of steps, but the solution is only available
+     * through observers.
+     */
+    void SetStoreTrace(bool storeTrace);
+
+    /**
+     * Add an observer to be called with the initial values and then every accepted step.  The
+     * observer is not copied, so it must outlive the solves.
+     */
+    void AddObserver(AbstractOdeObserverT<STATE>* pObserver);
 
+    /** Remove all the observers */
+    void RemoveAllObservers();
+
+    /**
+     * Right-hand side evaluations, steps, time spent in setup/integration/output and trace memory
+     * for the last solve
+     */
+    SolverStats GetStats() const;
+
+    /**
+     * Store the solution structure-of-arrays: each component in its own contiguous array, so that
+     * GetComponentView() has stride 1 and reductions over it vectorize.  Clears any stored trace.
+     */
+    void SetStructureOfArraysTrace(bool structureOfArrays);
+
+    /**
+     * Store the traces in fixed-size pages (see PagedTrace.hpp) rather than in single vectors, for
+     * very long solves: the traces grow a page at a time without ever being copied, and with a spill
+     * file each full page is written to disk, so that memory use stays at a few pages however many
+     * steps there are.  GetTimeTrace(), Get*Trace(), DumpToFile() and DumpToBinaryFile() work as
+     * usual, but the views and TakeTrace() need contiguous traces, so they throw.  The solution is
+     * paged as states, so this can't be combined with SetStructureOfArraysTrace().  Clears any
+     * stored trace.
+     */
+    void SetPagedTrace(bool pagedTrace, const std::string& spillFileName="");
+
+    /**
+     * Choose whether Solve() keeps an interpolant over every step, so that Evaluate() can give the
+     * solution at any time in the solved interval.  This is independent of the stored traces, so
+     * large steps can still give output on a fine grid.  The fixed-step solvers use cubic Hermite
+     * interpolation (one more right-hand side evaluation a step) and Dormand-Prince its own 4th
+     * order continuous extension.  Off by default.
+     */
+    void SetDenseOutput(bool denseOutput);
+
+    /**
+     * Post-processing method : the solution at time t from the dense output of the last solve.
+     * Throws if there is no dense output or t is outside the solved interval.
+     */
+    STATE Evaluate(double t) const;
+
+    /**
+     * Post-processing method : the solution at each of the times from the dense output of the last
+     * solve.  Sorted times are the quickest.
+     */
+    std::vector<STATE> Evaluate(const std::vector<double>& rTimes) const;
+
+    /**
+     * Add an event function g(v, t): an event happens whenever g changes sign, and is located to
+     * within rounding error by root-finding on the step's interpolant (cubic Hermite for the
+     * fixed-step solvers, which costs one more right-hand side evaluation a step, or Dormand-Prince's
+     * continuous extension).  A positive direction only counts rising crossings (- to +), a
+     * negative one only falling crossings, and zero both.  With a positive terminalCount the solve
+     * stops at that many events, so the trace ends at the event.  Returns the event function's index.
+     */
+    int AddEventFunction(const std::function<double(const STATE&, double)>& rFunction, int direction=0,
+                         int terminalCount=0);
+
+    /** Remove all the event functions */
+    void RemoveAllEventFunctions();
+
+    /** The events found in the last solve, in time order */
+    const std::vector<EventRecordT<STATE> >& GetEvents() const;
+
+    /** Times of the events of one event function in the last solve */
+    std::vector<double> GetEventTimes(int eventIndex) const;
+
+    /** Whether the last solve was stopped by a terminal event before the final time */
+    bool WasStoppedByEvent() const;
+
+    /**
+     * Write a checkpoint to fileName every interval steps, holding the time, the values, the step
+     * index, the solver's name and the time set-up.  Each checkpoint replaces the last atomically
+     * (see WriteCheckpointFile()).  Streaming observers are flushed at each checkpoint.  An interval
+     * of zero switches checkpointing off.  Only the fixed-step explicit solvers support it: the
+     * others throw from Solve().
+     */
+    void SetCheckpointing(const std::string& fileName, int64_t interval);
+
+    /**
+     * Make the next Solve() carry on from a checkpoint, giving bit-identical results to a solve
+     * that was never interrupted.  The time set-up is taken from the checkpoint.  The stored traces
+     * start from the checkpoint, and a FileStreamObserverT appends to the file it was writing.  The
+     * observers must be the same as when the checkpoint was written.  Throws if the checkpoint is
+     * for a different solver or number of variables.
+     */
+    void LoadCheckpoint(const std::string& fileName);
+
+    /** LoadCheckpoint() then Solve() with the function pointer set by SetRhsFunction() */
+    void Resume(const std::string& fileName);
 
     /**
      * Post-processing method : get out cached time trace
@@ -136,12 +404,32 @@ public:
     std::vector<double> GetTimeTrace() const;
 
     /**
-     * Post-processing method : get out all calculated x-values
+     * Post-processing methods : views of the stored traces without copying them.  These are only
+     * valid until the next solve.  Not available for paged traces.
+     */
+    TraceView GetTimeView() const;
+    TraceViewT<ValueType> GetComponentView(int component) const;
+    TraceViewT<ValueType> GetXView() const;
+    TraceViewT<ValueType> GetYView() const;
+
+    /**
+     * Post-processing method : hand the stored traces over to the caller without copying them.
+     * The solver's traces are left empty.  Not available for paged traces.
+     */
+    SolutionTraceT<STATE> TakeTrace();
+
+    /**
+     * Post-processing method : get out all calculated values of one component of the state
+     */
+    std::vector<double> GetComponentTrace(int component);
+
+    /**
+     * Post-processing method : get out all calculated x-values (component 0)
      */
     std::vector<double> GetXTrace();
 
     /**
-     * Post-processing method : get out all calculated y-values
+     * Post-processing method : get out all calculated y-values (component 1)
      */
     std::vector<double> GetYTrace();
 
@@ -149,9 +437,21 @@ public:
      * Post-processing method : dump to named file or path
      *
      * This is column data:
-     * time     x-value     y-value
+     * time     x-value     y-value ...
      */
     void DumpToFile(const std::string& fileName);
+
+    /**
+     * Post-processing method : dump to named file or path in the binary trace format (see
+     * TraceFile.hpp), which keeps full precision and can be mapped back in with LoadTrace()
+     */
+    void DumpToBinaryFile(const std::string& fileName);
+
+    /** Name of the method, recorded in binary trace files */
+    virtual std::string GetSolverName() const
+    {
+        return "AbstractOdeSolver";
+    }
     /**
      * Here is the method which makes this class "abstract".  It's not implemented here: only in the
      * derived class/classes so we can't actually make an instance of this base class.
@@ -159,4 +459,857 @@ public:
     virtual void Solve() = 0;
 };
 
+template<class STATE>
+AbstractOdeSolverT<STATE>::AbstractOdeSolverT()
+{
+    mInitialValues = STATE();
+    mpRhsFunction = NULL;
+    mNumberOfTimeSteps = -1;
+    mStoreTrace = true;
+    mStructureOfArrays = false;
+    mDenseOutput = false;
+    mStoppedByEvent = false;
+    mCheckpointInterval = 0;
+    mResuming = false;
+    mResumeStepIndex = 0;
+    mResumeTime = 0.0;
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::CheckSolution() const
+{
+    if (GetNumberOfStoredPoints() == 0 && !mStoreTrace)
+    {
+        throw Exception("OdePost", "The trace was not stored.  Please use an observer or SetStoreTrace(true)");
+    }
+    if (GetNumberOfStoredPoints() == 0)
+    {
+        throw Exception("OdePost", "There no solution.  Please run the Solve() method");
+    }
+    // More serious error:
+    assert (!mpPagedTimeTrace || mpPagedSolutionTrace->size() == mpPagedTimeTrace->size());
+    assert (mpPagedTimeTrace || mStructureOfArrays || mSolutionTrace.size() == mTimeTrace.size());
+    assert (mpPagedTimeTrace || !mStructureOfArrays || mComponentTraces[0].size() == mTimeTrace.size());
+    // Last lines trip if solution and time vectors have different size.  The Solve() method should update both
+}
+
+template<class STATE>
+uint64_t AbstractOdeSolverT<STATE>::GetNumberOfStoredPoints() const
+{
+    return mpPagedTimeTrace ? mpPagedTimeTrace->size() : mTimeTrace.size();
+}
+
+template<class STATE>
+double AbstractOdeSolverT<STATE>::GetStoredTime(uint64_t i) const
+{
+    return mpPagedTimeTrace ? (*mpPagedTimeTrace)[i] : mTimeTrace[i];
+}
+
+template<class STATE>
+STATE AbstractOdeSolverT<STATE>::GetStoredValues(uint64_t i) const
+{
+    if (mpPagedSolutionTrace)
+    {
+        return (*mpPagedSolutionTrace)[i];
+    }
+    if (!mStructureOfArrays)
+    {
+        return mSolutionTrace[i];
+    }
+    STATE values;
+    for (int j=0; j<STATE::DIMENSION; j++)
+    {
+        values[j] = mComponentTraces[j][i];
+    }
+    return values;
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::CheckNotPaged() const
+{
+    if (mpPagedTimeTrace)
+    {
+        throw Exception("OdePost", "Paged traces are not contiguous.  Please use the Get*Trace() methods");
+    }
+}
+
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::SetInitialValues(double x, double y)
+{
+    // Only compiles for 2-D states
+    mInitialValues = STATE(x, y);
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::SetInitialValues(const STATE& initialValues)
+{
+    mInitialValues = initialValues;
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::SetInitialTimeDeltaTimeAndFinalTime(double startTime, double delta, double endTime)
+{
+    double approximate_number_of_steps = (endTime - startTime)/delta;
+    int64_t num_steps = int64_t ( round(approximate_number_of_steps) );
+
+    // Check that we are stepping in the correct direction
+    if (num_steps <= 0)
+    {
+        throw Exception("OdeSetup", "Time step has the wrong sign");
+    }
+
+    // Check that constant time step divides the interval
+    double expected_end_time_difference = startTime + delta*num_steps - endTime;
+    if (expected_end_time_difference*expected_end_time_difference > 1e-15)
+    {
+        throw Exception("OdeSetup", "Time step does not divide the time interval");
+    }
+
+    // Set member variables
+    mStartTime = startTime;
+    mTimeStepSize = delta;
+    mNumberOfTimeSteps = num_steps;
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::SetInitialTimeNumberOfStepsAndFinalTime(double startTime, int64_t steps, double endTime)
+{
+    // Check that we are stepping in the correct direction
+    if (steps <= 0)
+    {
+        throw Exception("OdeSetup", "Number of time steps should be positive");
+    }
+    double time_step = (endTime-startTime)/steps;
+    if (time_step == 0)
+    {
+        throw Exception("OdeSetup", "Time interval is empty");
+    }
+    // Set member variables
+    mStartTime = startTime;
+    mTimeStepSize = time_step;
+    mNumberOfTimeSteps = steps;
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::SetRhsFunction(void (*pFunctionName)(const STATE&, double, STATE&))
+{
+    mpRhsFunction = pFunctionName;
+}
+
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::SetStoreTrace(bool storeTrace)
+{
+    mStoreTrace = storeTrace;
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::SetDenseOutput(bool denseOutput)
+{
+    mDenseOutput = denseOutput;
+}
+
+template<class STATE>
+int AbstractOdeSolverT<STATE>::AddEventFunction(const std::function<double(const STATE&, double)>& rFunction,
+                                                int direction, int terminalCount)
+{
+    if (!rFunction)
+    {
+        throw Exception("OdeSetup", "Event function is missing");
+    }
+    if (terminalCount < 0)
+    {
+        throw Exception("OdeSetup", "Number of events to stop at should not be negative");
+    }
+    EventFunction event_function = {rFunction, (direction > 0) - (direction < 0), terminalCount};
+    mEventFunctions.push_back(event_function);
+    return mEventFunctions.size() - 1;
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::RemoveAllEventFunctions()
+{
+    mEventFunctions.clear();
+}
+
+template<class STATE>
+const std::vector<EventRecordT<STATE> >& AbstractOdeSolverT<STATE>::GetEvents() const
+{
+    return mEvents;
+}
+
+template<class STATE>
+std::vector<double> AbstractOdeSolverT<STATE>::GetEventTimes(int eventIndex) const
+{
+    if (eventIndex < 0 || eventIndex >= int(mEventFunctions.size()))
+    {
+        throw Exception("OdePost", "No such event function");
+    }
+    std::vector<double> times;
+    for (std::size_t i=0; i<mEvents.size(); i++)
+    {
+        if (mEvents[i].eventIndex == eventIndex)
+        {
+            times.push_back(mEvents[i].time);
+        }
+    }
+    return times;
+}
+
+template<class STATE>
+bool AbstractOdeSolverT<STATE>::WasStoppedByEvent() const
+{
+    return mStoppedByEvent;
+}
+
+template<class STATE>
+bool AbstractOdeSolverT<STATE>::LocateEvents(double startTime, double endTime, const STATE* pInterpolant,
+                                             int numberOfCoefficients, const STATE& rEndValues,
+                                             double& rStopTime, STATE& rStopValues)
+{
+    const double h = endTime - startTime;
+    // Position (theta) of each event in this step
+    std::vector<std::pair<double, int> > found;
+    for (unsigned i=0; i<mEventFunctions.size(); i++)
+    {
+        const EventFunction& r_event = mEventFunctions[i];
+        double g_low = mEventValues[i];
+        double g_high = r_event.function(rEndValues, endTime);
+        mEventValues[i] = g_high;
+        bool rising = (g_low < 0.0 && g_high >= 0.0);
+        bool falling = (g_low > 0.0 && g_high <= 0.0);
+        if (!((rising && r_event.direction >= 0) || (falling && r_event.direction <= 0)))
+        {
+            continue;
+        }
+
+        // Illinois: regula falsi, halving the value kept at an end that doesn't move twice running
+        double theta_low = 0.0, theta_high = 1.0;
+        int side = 0;
+        for (int iteration=0; iteration<100 && g_high != 0.0; iteration++)
+        {
+            double theta = (theta_low*g_high - theta_high*g_low)/(g_high - g_low);
+            if ((theta_high - theta_low)*fabs(h) <= 4.0*DBL_EPSILON*std::max(fabs(endTime), fabs(h)))
+            {
+                break;
+            }
+            double g = r_event.function(DenseOutputT<STATE>::EvaluateInterpolant(pInterpolant, numberOfCoefficients, theta),
+                                        startTime + theta*h);
+            if (g == 0.0 || (g > 0.0) == (g_high > 0.0))
+            {
+                theta_high = theta;
+                g_high = g;
+                if (side == 1)
+                {
+                    g_low *= 0.5;
+                }
+                side = 1;
+            }
+            else
+            {
+                theta_low = theta;
+                g_low = g;
+                if (side == -1)
+                {
+                    g_high *= 0.5;
+                }
+                side = -1;
+            }
+        }
+        // The end past the crossing, so that the event isn't found again from the next step
+        found.push_back(std::make_pair(theta_high, int(i)));
+    }
+    std::sort(found.begin(), found.end());
+
+    for (std::size_t k=0; k<found.size(); k++)
+    {
+        const int index = found[k].second;
+        EventRecordT<STATE> event;
+        event.eventIndex = index;
+        event.time = (found[k].first == 1.0) ? endTime : startTime + found[k].first*h;
+        event.values = (found[k].first == 1.0) ? rEndValues
+                : DenseOutputT<STATE>::EvaluateInterpolant(pInterpolant, numberOfCoefficients, found[k].first);
+        mEvents.push_back(event);
+        mEventCounts[index]++;
+        if (mEventCounts[index] == mEventFunctions[index].terminalCount)
+        {
+            // Later events in the step never happen
+            mStoppedByEvent = true;
+            rStopTime = event.time;
+            rStopValues = event.values;
+            return true;
+        }
+    }
+    return false;
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::SetCheckpointing(const std::string& fileName, int64_t interval)
+{
+    if (interval < 0)
+    {
+        throw Exception("OdeSetup", "Checkpoint interval should not be negative");
+    }
+    if (interval > 0 && fileName.empty())
+    {
+        throw Exception("OdeSetup", "Checkpoint file name is missing");
+    }
+    mCheckpointFileName = fileName;
+    mCheckpointInterval = interval;
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::LoadCheckpoint(const std::string& fileName)
+{
+    CheckpointHeader header;
+    std::vector<double> values;
+    std::vector<uint64_t> observer_positions;
+    ReadCheckpointFile(fileName, header, values, observer_positions);
+    if (std::string(header.solverName) != GetSolverName() || header.dimension != unsigned(STATE::DIMENSION))
+    {
+        throw Exception("OdeSetup", "The checkpoint was written by a different solver or system");
+    }
+    if (header.numberOfTimeSteps <= 0 || header.stepIndex < 0 || header.stepIndex > header.numberOfTimeSteps)
+    {
+        throw Exception("OdeSetup", "The checkpoint's time set-up is invalid");
+    }
+    mStartTime = header.startTime;
+    mTimeStepSize = header.timeStepSize;
+    mNumberOfTimeSteps = header.numberOfTimeSteps;
+    mResumeStepIndex = header.stepIndex;
+    mResumeTime = header.time;
+    for (int j=0; j<STATE::DIMENSION; j++)
+    {
+        mResumeValues[j] = values[j];
+    }
+    mResumeObserverPositions.swap(observer_positions);
+    mResuming = true;
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::Resume(const std::string& fileName)
+{
+    LoadCheckpoint(fileName);
+    Solve();
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::WriteCheckpoint(int64_t stepIndex, double t, const STATE& rValues)
+{
+    std::vector<uint64_t> observer_positions(mObservers.size());
+    for (unsigned i=0; i<mObservers.size(); i++)
+    {
+        observer_positions[i] = mObservers[i]->Checkpoint();
+    }
+    double values[STATE::DIMENSION];
+    for (int j=0; j<STATE::DIMENSION; j++)
+    {
+        values[j] = rValues[j];
+    }
+    CheckpointHeader header = MakeCheckpointHeader(STATE::DIMENSION, GetSolverName(), mStartTime, mTimeStepSize,
+                                                   mNumberOfTimeSteps, stepIndex, t, mObservers.size());
+    WriteCheckpointFile(mCheckpointFileName, header, values, observer_positions.data());
+}
+
+template<class STATE>
+STATE AbstractOdeSolverT<STATE>::Evaluate(double t) const
+{
+    return mDenseOutputData.Evaluate(t);
+}
+
+template<class STATE>
+std::vector<STATE> AbstractOdeSolverT<STATE>::Evaluate(const std::vector<double>& rTimes) const
+{
+    return mDenseOutputData.Evaluate(rTimes);
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::AddObserver(AbstractOdeObserverT<STATE>* pObserver)
+{
+    if (pObserver == NULL)
+    {
+        throw Exception("OdeSetup", "Observer is missing");
+    }
+    mObservers.push_back(pObserver);
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::RemoveAllObservers()
+{
+    mObservers.clear();
+}
+
+template<class STATE>
+SolverStats AbstractOdeSolverT<STATE>::GetStats() const
+{
+    return mStats.GetStats();
+}
+
+template<class STATE>
+std::size_t AbstractOdeSolverT<STATE>::GetTraceCapacityBytes() const
+{
+    std::size_t bytes = mTimeTrace.capacity()*sizeof(double) + mSolutionTrace.capacity()*sizeof(STATE);
+    for (int j=0; j<STATE::DIMENSION; j++)
+    {
+        bytes += mComponentTraces[j].capacity()*sizeof(ValueType);
+    }
+    if (mpPagedTimeTrace)
+    {
+        bytes += mpPagedTimeTrace->GetCapacityBytes() + mpPagedSolutionTrace->GetCapacityBytes();
+    }
+    return bytes + mDenseOutputData.GetCapacityBytes();
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::SetStructureOfArraysTrace(bool structureOfArrays)
+{
+    if (structureOfArrays && mpPagedTimeTrace)
+    {
+        throw Exception("OdeSetup", "Paged traces are stored as states, not structure-of-arrays");
+    }
+    mStructureOfArrays = structureOfArrays;
+    mTimeTrace.clear();
+    mSolutionTrace.clear();
+    for (int j=0; j<STATE::DIMENSION; j++)
+    {
+        mComponentTraces[j].clear();
+    }
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::SetPagedTrace(bool pagedTrace, const std::string& spillFileName)
+{
+    if (pagedTrace && mStructureOfArrays)
+    {
+        throw Exception("OdeSetup", "Paged traces are stored as states, not structure-of-arrays");
+    }
+    if (!pagedTrace)
+    {
+        mpPagedTimeTrace.reset();
+        mpPagedSolutionTrace.reset();
+        return;
+    }
+    // Give back the memory of the vector traces
+    std::vector<double>().swap(mTimeTrace);
+    std::vector<STATE>().swap(mSolutionTrace);
+    for (int j=0; j<STATE::DIMENSION; j++)
+    {
+        std::vector<ValueType>().swap(mComponentTraces[j]);
+    }
+    mpPagedTimeTrace.reset(new PagedTraceT<double>());
+    mpPagedSolutionTrace.reset(new PagedTraceT<STATE>());
+    if (!spillFileName.empty())
+    {
+        // The two traces go to two files
+        mpPagedTimeTrace->SetSpillFile(spillFileName + ".time");
+        mpPagedSolutionTrace->SetSpillFile(spillFileName);
+    }
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::BeginRecording(double t, const STATE& rValues, bool supportsCheckpoints, bool fixedSteps)
+{
+    if (!supportsCheckpoints && (mResuming || mCheckpointInterval > 0))
+    {
+        mResuming = false;
+        throw Exception("OdeSolve", "This solver does not support checkpoints");
+    }
+    if (mResuming && mResumeObserverPositions.size() != mObservers.size())
+    {
+        mResuming = false;
+        throw Exception("OdeSolve", "The observers are not the ones the checkpoint was written with");
+    }
+    if (!mEventFunctions.empty() && (mResuming || mCheckpointInterval > 0))
+    {
+        // The events found so far are not kept in the checkpoints
+        mResuming = false;
+        throw Exception("OdeSolve", "Event functions can't be used with checkpoints");
+    }
+    mStats.BeginSolve();
+
+    // Events start from the initial values
+    mEvents.clear();
+    mStoppedByEvent = false;
+    mEventCounts.assign(mEventFunctions.size(), 0);
+    mEventValues.resize(mEventFunctions.size());
+    for (unsigned i=0; i<mEventFunctions.size(); i++)
+    {
+        mEventValues[i] = mEventFunctions[i].function(rValues, t);
+    }
+    // Clear the traces if the code has been previously run
+    mSolutionTrace.clear();
+    mTimeTrace.clear();
+    for (int j=0; j<STATE::DIMENSION; j++)
+    {
+        mComponentTraces[j].clear();
+    }
+    if (mpPagedTimeTrace)
+    {
+        mpPagedTimeTrace->Clear();
+        mpPagedSolutionTrace->Clear();
+    }
+
+    // Without stored traces, give back any memory held from earlier solves
+    if (!mStoreTrace)
+    {
+        std::vector<double>().swap(mTimeTrace);
+        std::vector<STATE>().swap(mSolutionTrace);
+        for (int j=0; j<STATE::DIMENSION; j++)
+        {
+            std::vector<ValueType>().swap(mComponentTraces[j]);
+        }
+        if (mpPagedTimeTrace)
+        {
+            mpPagedTimeTrace->ReleaseMemory();
+            mpPagedSolutionTrace->ReleaseMemory();
+        }
+    }
+    // Solvers which support dense output start it themselves
+    mDenseOutputData.Clear(!mDenseOutput);
+
+    // Make room for the whole solve up front.  Paged traces only make room in their lists of pages:
+    // the pages come as they are needed
+    if (mStoreTrace && fixedSteps && mNumberOfTimeSteps > 0)
+    {
+        std::size_t size = std::size_t(mNumberOfTimeSteps - (mResuming ? mResumeStepIndex : 0)) + 1;
+        if (mpPagedTimeTrace)
+        {
+            mpPagedTimeTrace->reserve(size);
+            mpPagedSolutionTrace->reserve(size);
+        }
+        else if (mStructureOfArrays)
+        {
+            mTimeTrace.reserve(size);
+            for (int j=0; j<STATE::DIMENSION; j++)
+            {
+                mComponentTraces[j].reserve(size);
+            }
+        }
+        else
+        {
+            mTimeTrace.reserve(size);
+            mSolutionTrace.reserve(size);
+        }
+    }
+    if (mResuming)
+    {
+        // The observers have already seen the values at the checkpoint
+        for (unsigned i=0; i<mObservers.size(); i++)
+        {
+            mObservers[i]->BeginResume(mResumeObserverPositions[i]);
+        }
+        std::vector<AbstractOdeObserverT<STATE>*> observers;
+        observers.swap(mObservers);
+        RecordStep(t, rValues);
+        observers.swap(mObservers);
+        mResuming = false;
+    }
+    else
+    {
+        for (unsigned i=0; i<mObservers.size(); i++)
+        {
+            mObservers[i]->BeginSolve();
+        }
+        RecordStep(t, rValues);
+    }
+    mStats.BeginIntegration();
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::EndRecording()
+{
+    for (unsigned i=0; i<mObservers.size(); i++)
+    {
+        mObservers[i]->EndSolve();
+    }
+    mStats.EndIntegration(GetTraceCapacityBytes());
+}
+
+template<class STATE>
+std::vector<double> AbstractOdeSolverT<STATE>::GetTimeTrace() const
+{
+    // Sanity check
+    CheckSolution();
+    if (mpPagedTimeTrace)
+    {
+        return std::vector<double>(mpPagedTimeTrace->begin(), mpPagedTimeTrace->end());
+    }
+    // Copy the values into a new vector
+    return mTimeTrace;
+}
+
+template<class STATE>
+TraceView AbstractOdeSolverT<STATE>::GetTimeView() const
+{
+    // Sanity check
+    CheckSolution();
+    CheckNotPaged();
+    return TraceView(&mTimeTrace[0], mTimeTrace.size());
+}
+
+template<class STATE>
+TraceViewT<typename STATE::ValueType> AbstractOdeSolverT<STATE>::GetComponentView(int component) const
+{
+    // Sanity check
+    CheckSolution();
+    if (component < 0 || component >= STATE::DIMENSION)
+    {
+        throw Exception("OdePost", "No such component in the state");
+    }
+    CheckNotPaged();
+    if (mStructureOfArrays)
+    {
+        return TraceViewT<ValueType>(&mComponentTraces[component][0], mTimeTrace.size());
+    }
+    // Walk through the states one component at a time: the states must be plain arrays of numbers
+    static_assert(sizeof(STATE) == STATE::DIMENSION*sizeof(ValueType), "State must be packed numbers");
+    return TraceViewT<ValueType>(&mSolutionTrace[0][component], mTimeTrace.size(), STATE::DIMENSION);
+}
+
+template<class STATE>
+TraceViewT<typename STATE::ValueType> AbstractOdeSolverT<STATE>::GetXView() const
+{
+    return GetComponentView(0);
+}
+
+template<class STATE>
+TraceViewT<typename STATE::ValueType> AbstractOdeSolverT<STATE>::GetYView() const
+{
+    return GetComponentView(1);
+}
+
+template<class STATE>
+SolutionTraceT<STATE> AbstractOdeSolverT<STATE>::TakeTrace()
+{
+    // Sanity check
+    CheckSolution();
+    CheckNotPaged();
+    SolutionTraceT<STATE> trace;
+    trace.times.swap(mTimeTrace);
+    trace.solution.swap(mSolutionTrace);
+    for (int j=0; j<STATE::DIMENSION; j++)
+    {
+        trace.components[j].swap(mComponentTraces[j]);
+    }
+    return trace;
+}
+
+template<class STATE>
+std::vector<double> AbstractOdeSolverT<STATE>::GetComponentTrace(int component)
+{
+    if (mpPagedSolutionTrace)
+    {
+        // Sanity check
+        CheckSolution();
+        if (component < 0 || component >= STATE::DIMENSION)
+        {
+            throw Exception("OdePost", "No such component in the state");
+        }
+        std::vector<double> temp;
+        temp.reserve(mpPagedSolutionTrace->size());
+        for (const STATE& r_values : *mpPagedSolutionTrace)
+        {
+            temp.push_back( r_values[component] );
+        }
+        return temp;
+    }
+    // Copy out values
+    TraceViewT<ValueType> values = GetComponentView(component);
+    std::vector<double> temp;
+    temp.reserve(values.size());
+    for (std::size_t i=0; i<values.size(); i++)
+    {
+        temp.push_back( values[i] );
+    }
+    return temp;
+}
+
+template<class STATE>
+std::vector<double> AbstractOdeSolverT<STATE>::GetXTrace()
+{
+    return GetComponentTrace(0);
+}
+
+template<class STATE>
+std::vector<double> AbstractOdeSolverT<STATE>::GetYTrace()
+{
+    return GetComponentTrace(1);
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::DumpToFile(const std::string& fileName)
+{
+    // Sanity check
+    CheckSolution();
+    mStats.BeginOutput();
+    TextTraceWriter write_output(fileName, STATE::DIMENSION + 1);
+    const uint64_t size = GetNumberOfStoredPoints();
+    for (uint64_t i=0; i<size; i++)
+    {
+        WriteTraceRow(write_output, GetStoredTime(i), GetStoredValues(i));
+    }
+
+    write_output.Close();
+    mStats.EndOutput();
+}
+
+template<class STATE>
+template<class STEPPER, class RHS>
+void AbstractOdeSolverT<STATE>::RunFixedTimeSteps(const STEPPER& rStepper, RHS& rRhs, bool supportsCheckpoints)
+{
+    // Defensive programming to prevent bad inputs
+    if (mNumberOfTimeSteps < 0)
+    {
+        throw Exception("OdeSolve", "The number of time steps is negative");
+    }
+
+    // Count the right-hand side evaluations (unless the stats are compiled out)
+    auto&& rhs = CountRhsEvaluations(rRhs, mStats);
+
+    // Start the trace with the initial values and start times (or carry on from a checkpoint)
+    STATE v = mInitialValues;
+    double time = mStartTime;
+    int64_t first_step = 1;
+    if (mResuming)
+    {
+        v = mResumeValues;
+        time = mResumeTime;
+        first_step = mResumeStepIndex + 1;
+    }
+    BeginRecording(time, v, supportsCheckpoints);
+    // Step index of the next checkpoint (past the end if there are none)
+    int64_t next_checkpoint = mNumberOfTimeSteps + 1;
+    if (mCheckpointInterval > 0)
+    {
+        next_checkpoint = first_step + mCheckpointInterval - 1;
+    }
+    if (mDenseOutput || !mEventFunctions.empty())
+    {
+        // Derivatives at both ends of each step for the Hermite interpolants (for dense output and events)
+        STATE start, start_derivative, end_derivative, interpolant[4], event_values;
+        double start_time, event_time;
+        if (mDenseOutput)
+        {
+            mDenseOutputData.Begin(time, 4, mNumberOfTimeSteps - first_step + 1);
+        }
+        rhs(v, time, end_derivative);
+        for (int64_t t = first_step; t <= mNumberOfTimeSteps; t++)
+        {
+            start = v;
+            start_time = time;
+            start_derivative = end_derivative;
+            rStepper.TakeStep(rhs, time, mTimeStepSize, v);
+            time = GetStepTime(t);
+            rhs(v, time, end_derivative);
+            DenseOutputT<STATE>::MakeHermiteInterpolant(time - start_time, start, start_derivative, v, end_derivative,
+                                                        interpolant);
+            if (mDenseOutput)
+            {
+                mDenseOutputData.AddStep(time, interpolant);
+            }
+            if (!mEventFunctions.empty() && LocateEvents(start_time, time, interpolant, 4, v, event_time, event_values))
+            {
+                // Stopped by an event: the solution finishes there
+                mDenseOutputData.Truncate(event_time);
+                RecordStep(event_time, event_values);
+                break;
+            }
+            RecordStep(time, v);
+            if (t == next_checkpoint)
+            {
+                WriteCheckpoint(t, time, v);
+                next_checkpoint += mCheckpointInterval;
+            }
+        }
+        EndRecording();
+        return;
+    }
+    for (int64_t t = first_step; t <= mNumberOfTimeSteps; t++)
+    {
+        // Progress over the current timestep
+        rStepper.TakeStep(rhs, time, mTimeStepSize, v);
+        time = GetStepTime(t);
+
+        // Append the results to the traces
+        RecordStep(time, v);
+        if (t == next_checkpoint)
+        {
+            WriteCheckpoint(t, time, v);
+            next_checkpoint += mCheckpointInterval;
+        }
+    }
+    EndRecording();
+}
+
+template<class STATE>
+void AbstractOdeSolverT<STATE>::DumpToBinaryFile(const std::string& fileName)
+{
+    // Sanity check
+    CheckSolution();
+    mStats.BeginOutput();
+    const std::size_t size = GetNumberOfStoredPoints();
+    BinaryTraceHeader header = MakeBinaryTraceHeader(STATE::DIMENSION, size, mTimeStepSize, GetSolverName());
+
+    std::ofstream write_output(fileName.c_str(), std::ios::out | std::ios::binary);
+    if (write_output.is_open() == false)
+    {
+        throw Exception("OdePost", "Can't open output file");
+    }
+    write_output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (mpPagedTimeTrace)
+    {
+        for (uint64_t p=0; p<mpPagedTimeTrace->GetNumberOfPages(); p++)
+        {
+            write_output.write(reinterpret_cast<const char*>(mpPagedTimeTrace->GetPage(p)),
+                               mpPagedTimeTrace->GetPageLength(p)*sizeof(double));
+        }
+    }
+    else
+    {
+        write_output.write(reinterpret_cast<const char*>(&mTimeTrace[0]), size*sizeof(double));
+    }
+    for (int j=0; j<STATE::DIMENSION; j++)
+    {
+        if (mStructureOfArrays && sizeof(ValueType) == sizeof(double))
+        {
+            write_output.write(reinterpret_cast<const char*>(&mComponentTraces[j][0]), size*sizeof(double));
+            continue;
+        }
+        // Gather the component (as doubles, which is what the file holds) into a buffer and write it out in large blocks
+        const std::size_t block_size = 65536;
+        std::vector<double> buffer(std::min(size, block_size));
+        for (std::size_t start=0; start<size; start+=block_size)
+        {
+            std::size_t end = std::min(size, start + block_size);
+            if (mpPagedSolutionTrace)
+            {
+                for (std::size_t i=start; i<end; i++)
+                {
+                    buffer[i - start] = (*mpPagedSolutionTrace)[i][j];
+                }
+            }
+            else
+            {
+                for (std::size_t i=start; i<end; i++)
+                {
+                    buffer[i - start] = mStructureOfArrays ? mComponentTraces[j][i] : mSolutionTrace[i][j];
+                }
+            }
+            write_output.write(reinterpret_cast<const char*>(&buffer[0]), (end - start)*sizeof(double));
+        }
+    }
+    write_output.close();
+    if (write_output.fail())
+    {
+        throw Exception("OdePost", "Failed writing output file");
+    }
+    mStats.EndOutput();
+}
+
+/** The original 2-D solver interface */
+typedef AbstractOdeSolverT<Pair> AbstractOdeSolver;
+// Compiled once in AbstractOdeSolver.cpp
+extern template class AbstractOdeSolverT<Pair>;
+
 #endif /* ABSTRACTODESOLVER_HPP_ */
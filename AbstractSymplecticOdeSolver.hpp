@@ -0,0 +1,162 @@
+/*
+ * AbstractSymplecticOdeSolver.hpp
+ *
+ * Shared machinery for the symplectic solvers: split position/velocity right-hand sides and
+ * kick-drift-kick compositions
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef ABSTRACTSYMPLECTICODESOLVER_HPP_
+#define ABSTRACTSYMPLECTICODESOLVER_HPP_
+
+#include "AbstractOdeSolver.hpp"
+
+/**
+ * AbstractSymplecticOdeSolverT is for separable Hamiltonian systems.  The state is split in half:
+ * components [0, N) are the positions q and [N, 2N) the velocities (or momenta) p, with
+ *     q' = positionRhs(p)     p' = force(q, t)
+ * Both are called like any right-hand side, f(v, t, dvdt), but the solver only reads the position
+ * half of dvdt from the position right-hand side and the velocity half from the force.  So a single
+ * right-hand side for the whole system can be used for both, as long as the system is separable
+ * (e.g. RhsCircle, with x as the position and y as the velocity).
+ *
+ * A step is a composition of "kicks" p += b*dt*force(q) and "drifts" q += a*dt*positionRhs(p),
+ * starting and finishing with a kick.  The force at the end of a step is kept for the first kick
+ * of the next, so each step costs one force evaluation per drift.  The solver's statistics count
+ * force evaluations as right-hand side evaluations.
+ */
+template<class STATE>
+class AbstractSymplecticOdeSolverT: public AbstractOdeSolverT<STATE>
+{
+private:
+    static_assert(STATE::DIMENSION % 2 == 0, "The state must be positions followed by velocities");
+
+    /**
+     * Gives the fixed time-step loop a TakeStep(force, t, dt, v) that passes the position
+     * right-hand side through to the solver's TakeStep(positionRhs, force, t, dt, v)
+     */
+    template<class SOLVER, class POSITION_RHS>
+    struct StepperWithPositionRhs
+    {
+        SOLVER& rSolver;
+        POSITION_RHS& rPositionRhs;
+
+        template<class FORCE>
+        void TakeStep(FORCE& rForce, double t, double dt, STATE& v) const
+        {
+            rSolver.TakeStep(rPositionRhs, rForce, t, dt, v);
+        }
+    };
+
+protected:
+    /** Number of positions (and of velocities) */
+    static const int HALF_DIMENSION = STATE::DIMENSION/2;
+
+    /** Split right-hand side function pointers (or NULL to use the whole right-hand side for both) */
+    void (* mpPositionRhsFunction)(const STATE&, double, STATE&);
+    void (* mpForceFunction)(const STATE&, double, STATE&);
+
+    /** The last force evaluation (the velocity half), at the current positions */
+    STATE mForce;
+    /** Whether mForce is up to date */
+    bool mHaveForce;
+
+    /** Runs the fixed time-step loop with rSolver.TakeStep(positionRhs, force, t, dt, v) */
+    template<class SOLVER, class POSITION_RHS, class FORCE>
+    void RunSymplecticTimeSteps(SOLVER& rSolver, POSITION_RHS& rPositionRhs, FORCE& rForce);
+
+    /**
+     * Advance v over one step from time t to t+dt with the kick-drift-...-drift-kick composition:
+     * kicks by pKicks[0], ..., pKicks[numberOfDrifts] and drifts by pDrifts[0], ...,
+     * pDrifts[numberOfDrifts-1] (fractions of dt, with the drifts adding up to one)
+     */
+    template<class POSITION_RHS, class FORCE>
+    void TakeCompositionStep(POSITION_RHS& rPositionRhs, FORCE& rForce, double t, double dt, STATE& v,
+                             const double* pKicks, const double* pDrifts, int numberOfDrifts);
+
+public:
+    AbstractSymplecticOdeSolverT();
+    virtual ~AbstractSymplecticOdeSolverT() {}
+
+    /**
+     * Set separate right-hand sides for the positions, q' = positionRhs(p), and the velocities,
+     * p' = force(q, t).  Each only needs to fill in its half of dvdt.
+     */
+    void SetSplitRhsFunctions(void (*pPositionRhsFunction)(const STATE&, double, STATE&),
+                              void (*pForceFunction)(const STATE&, double, STATE&));
+};
+
+template<class STATE>
+AbstractSymplecticOdeSolverT<STATE>::AbstractSymplecticOdeSolverT()
+{
+    mpPositionRhsFunction = NULL;
+    mpForceFunction = NULL;
+    mHaveForce = false;
+}
+
+template<class STATE>
+void AbstractSymplecticOdeSolverT<STATE>::SetSplitRhsFunctions(void (*pPositionRhsFunction)(const STATE&, double, STATE&),
+                                                               void (*pForceFunction)(const STATE&, double, STATE&))
+{
+    if (pPositionRhsFunction == NULL || pForceFunction == NULL)
+    {
+        throw Exception("OdeSetup", "Please give both the position and the force functions");
+    }
+    mpPositionRhsFunction = pPositionRhsFunction;
+    mpForceFunction = pForceFunction;
+}
+
+template<class STATE>
+template<class SOLVER, class POSITION_RHS, class FORCE>
+void AbstractSymplecticOdeSolverT<STATE>::RunSymplecticTimeSteps(SOLVER& rSolver, POSITION_RHS& rPositionRhs, FORCE& rForce)
+{
+    if (this->mDenseOutput || !this->mEventFunctions.empty())
+    {
+        // The Hermite interpolant would need the whole right-hand side, not just the force
+        throw Exception("OdeSolve", "Dense output and events are not available for the symplectic solvers");
+    }
+    mHaveForce = false;
+    StepperWithPositionRhs<SOLVER, POSITION_RHS> stepper = {rSolver, rPositionRhs};
+    // The force is kept between steps, so no checkpoints
+    this->RunFixedTimeSteps(stepper, rForce, false);
+}
+
+template<class STATE>
+template<class POSITION_RHS, class FORCE>
+void AbstractSymplecticOdeSolverT<STATE>::TakeCompositionStep(POSITION_RHS& rPositionRhs, FORCE& rForce, double t,
+                                                              double dt, STATE& v, const double* pKicks,
+                                                              const double* pDrifts, int numberOfDrifts)
+{
+    const int N = HALF_DIMENSION;
+    if (!mHaveForce)
+    {
+        rForce(v, t, mForce);
+        mHaveForce = true;
+    }
+    STATE position_derivative;
+    double time = t;
+    for (int i=0; i<numberOfDrifts; i++)
+    {
+        // Kick the velocities with the force at the current positions
+        for (int j=N; j<2*N; j++)
+        {
+            v[j] += pKicks[i]*dt*mForce[j];
+        }
+        // Drift the positions with the new velocities
+        rPositionRhs(v, time, position_derivative);
+        for (int j=0; j<N; j++)
+        {
+            v[j] += pDrifts[i]*dt*position_derivative[j];
+        }
+        time += pDrifts[i]*dt;
+        rForce(v, time, mForce);
+    }
+    for (int j=N; j<2*N; j++)
+    {
+        v[j] += pKicks[numberOfDrifts]*dt*mForce[j];
+    }
+}
+
+#endif /* ABSTRACTSYMPLECTICODESOLVER_HPP_ */
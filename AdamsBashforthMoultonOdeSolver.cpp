@@ -0,0 +1,13 @@
+/*
+ * AdamsBashforthMoultonOdeSolver.cpp
+ *
+ * Implements the Adams-Bashforth-Moulton predictor-corrector solvers of orders 2 to 5
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include "AdamsBashforthMoultonOdeSolver.hpp"
+
+// The methods are templates defined in the header.  The 2-D (Pair) version is compiled here once.
+template class AdamsBashforthMoultonOdeSolverT<Pair>;
@@ -0,0 +1,327 @@
+/*
+ * AdamsBashforthMoultonOdeSolver.hpp
+ *
+ * Implements the Adams-Bashforth-Moulton predictor-corrector solvers of orders 2 to 5
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef ADAMSBASHFORTHMOULTONODESOLVER_HPP_
+#define ADAMSBASHFORTHMOULTONODESOLVER_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "AbstractOdeSolver.hpp"
+
+/*
+ * Adams coefficients.  Row p is the order p formula: the Adams-Bashforth weights are for f_n, f_{n-1}, ...
+ * and the Adams-Moulton ones for f_{n+1}, f_n, ...  In backward difference form the order p
+ * Adams-Moulton formula leaves a local error of about dt*ERROR[p]*del^p f.
+ */
+struct AdamsCoefficients
+{
+    static constexpr double BASHFORTH[6][5] = {{0.0},
+                                               {1.0},
+                                               {3.0/2.0, -1.0/2.0},
+                                               {23.0/12.0, -16.0/12.0, 5.0/12.0},
+                                               {55.0/24.0, -59.0/24.0, 37.0/24.0, -9.0/24.0},
+                                               {1901.0/720.0, -2774.0/720.0, 2616.0/720.0, -1274.0/720.0, 251.0/720.0}};
+    static constexpr double MOULTON[6][5] = {{0.0},
+                                             {1.0},
+                                             {1.0/2.0, 1.0/2.0},
+                                             {5.0/12.0, 8.0/12.0, -1.0/12.0},
+                                             {9.0/24.0, 19.0/24.0, -5.0/24.0, 1.0/24.0},
+                                             {251.0/720.0, 646.0/720.0, -264.0/720.0, 106.0/720.0, -19.0/720.0}};
+    static constexpr double ERROR[6] = {1.0, -1.0/2.0, -1.0/12.0, -1.0/24.0, -19.0/720.0, -3.0/160.0};
+};
+
+/**
+ * Fixed time-step Adams-Bashforth-Moulton predictor-corrector of order 2 to 5 (default 4).  The
+ * derivatives at the last few time-points are kept, so that each step costs one right-hand side
+ * evaluation rather than RK4's four:
+ *
+ *  * Predict v_{n+1} with the explicit Adams-Bashforth formula of the order, from f_n, f_{n-1}, ...
+ *  * Evaluate f at the prediction
+ *  * Correct with the implicit Adams-Moulton formula of the same order, using that f for f_{n+1}
+ *
+ * This is the PEC mode: the next step uses the derivative at the prediction.  With
+ * SetEvaluateAfterCorrection(true) the derivative is evaluated again at the corrected values (PECE),
+ * for two evaluations per step and a larger stability region.  The first order-1 steps, before there
+ * are enough derivatives, are RK4 steps.
+ *
+ * With SetVariableOrder(true) the order set by SetOrder() is the largest used.  After each step the
+ * local error of the neighbouring orders is estimated from the backward differences of the
+ * derivatives, and the order moves (by one) to whichever has the smallest estimate.  Smooth
+ * problems stay at the highest order; where the high differences are just noise, a lower order is
+ * used.
+ *
+ * The derivative history is kept between steps, so checkpoints aren't supported.
+ */
+template<class STATE>
+class AdamsBashforthMoultonOdeSolverT: public AbstractOdeSolverT<STATE> {
+public:
+	/** Lowest and highest orders available */
+	static constexpr int MIN_ORDER = 2;
+	static constexpr int MAX_ORDER = 5;
+
+private:
+	/** Gives the fixed time-step loop a TakeStep(rhs, t, dt, v) that updates the solver's history */
+	struct Stepper {
+		AdamsBashforthMoultonOdeSolverT& rSolver;
+
+		template<class RHS>
+		void TakeStep(RHS& rRhs, double t, double dt, STATE& v) const {
+			rSolver.TakeStep(rRhs, t, dt, v);
+		}
+	};
+
+	/** Number of derivatives kept: one more than the highest order, for the error estimates */
+	static constexpr int HISTORY = MAX_ORDER + 1;
+
+	/** Order (or highest order, with variable order) */
+	int mOrder;
+	/** Whether the order is chosen step by step */
+	bool mVariableOrder;
+	/** Whether the derivative is evaluated again at the corrected values (PECE) */
+	bool mEvaluateAfterCorrection;
+
+	/** Ring buffer of the derivatives at the last time-points, mDerivatives[mNewest] being the latest */
+	STATE mDerivatives[HISTORY];
+	/** Position of the latest derivative in mDerivatives */
+	int mNewest;
+	/** Number of derivatives in mDerivatives (up to HISTORY) */
+	int mNumberOfDerivatives;
+	/** Order of the next step */
+	int mCurrentOrder;
+
+	/** Number of RK4 starting steps (in the last solve) */
+	int64_t mNumberOfStartingSteps;
+	/** Number of steps at each order (in the last solve) */
+	int64_t mStepsAtOrder[MAX_ORDER + 1];
+
+	/** The derivative at time-point n - age, where n is the latest */
+	const STATE& GetDerivative(int age) const {
+		return mDerivatives[(mNewest - age + HISTORY) % HISTORY];
+	}
+
+	/** Add the derivative at the new time-point, forgetting the oldest if the history is full */
+	void AddDerivative(const STATE& rDerivative);
+
+	/** Move the current order to the neighbour with the smallest local error estimate */
+	void ChooseOrder();
+
+public:
+	AdamsBashforthMoultonOdeSolverT();
+	virtual ~AdamsBashforthMoultonOdeSolverT();
+
+	/** "AdamsBashforthMoulton4", say, or "AdamsBashforthMoulton2to4" with variable order */
+	std::string GetSolverName() const;
+
+	/** Set the order (the highest order, with variable order).  Throws unless it is from 2 to 5 */
+	void SetOrder(int order);
+
+	int GetOrder() const;
+
+	/** Choose the order step by step, from 2 up to the order set by SetOrder() (default false) */
+	void SetVariableOrder(bool variableOrder);
+
+	/** Evaluate the derivative at the corrected values too (PECE rather than PEC, default false) */
+	void SetEvaluateAfterCorrection(bool evaluateAfterCorrection);
+
+	/** Number of RK4 steps taken to start the last solve */
+	int64_t GetNumberOfStartingSteps() const;
+
+	/** Number of steps taken at the order in the last solve (not counting the starting steps) */
+	int64_t GetNumberOfStepsAtOrder(int order) const;
+
+	/** Solve with the function pointer set by SetRhsFunction() */
+	void Solve();
+
+	/** Solve with any callable right-hand side rhs(v, t, dvdt) */
+	template<class RHS>
+	void Solve(RHS rhs);
+
+	/** Advance v over one time step from time t to t+dt, and add the derivative at t+dt to the history */
+	template<class RHS>
+	void TakeStep(RHS& rRhs, double t, double dt, STATE& v);
+};
+
+template<class STATE>
+AdamsBashforthMoultonOdeSolverT<STATE>::AdamsBashforthMoultonOdeSolverT() {
+	mOrder = 4;
+	mVariableOrder = false;
+	mEvaluateAfterCorrection = false;
+	mNewest = 0;
+	mNumberOfDerivatives = 0;
+	mCurrentOrder = mOrder;
+	mNumberOfStartingSteps = 0;
+	for (int order = 0; order <= MAX_ORDER; order++) {
+		mStepsAtOrder[order] = 0;
+	}
+}
+
+template<class STATE>
+AdamsBashforthMoultonOdeSolverT<STATE>::~AdamsBashforthMoultonOdeSolverT() {
+}
+
+template<class STATE>
+std::string AdamsBashforthMoultonOdeSolverT<STATE>::GetSolverName() const {
+	if (mVariableOrder) {
+		return "AdamsBashforthMoulton2to" + std::to_string(mOrder);
+	}
+	return "AdamsBashforthMoulton" + std::to_string(mOrder);
+}
+
+template<class STATE>
+void AdamsBashforthMoultonOdeSolverT<STATE>::SetOrder(int order) {
+	if (order < MIN_ORDER || order > MAX_ORDER) {
+		throw Exception("OdeSetup", "The Adams-Bashforth-Moulton order should be from 2 to 5");
+	}
+	mOrder = order;
+}
+
+template<class STATE>
+int AdamsBashforthMoultonOdeSolverT<STATE>::GetOrder() const {
+	return mOrder;
+}
+
+template<class STATE>
+void AdamsBashforthMoultonOdeSolverT<STATE>::SetVariableOrder(bool variableOrder) {
+	mVariableOrder = variableOrder;
+}
+
+template<class STATE>
+void AdamsBashforthMoultonOdeSolverT<STATE>::SetEvaluateAfterCorrection(bool evaluateAfterCorrection) {
+	mEvaluateAfterCorrection = evaluateAfterCorrection;
+}
+
+template<class STATE>
+int64_t AdamsBashforthMoultonOdeSolverT<STATE>::GetNumberOfStartingSteps() const {
+	return mNumberOfStartingSteps;
+}
+
+template<class STATE>
+int64_t AdamsBashforthMoultonOdeSolverT<STATE>::GetNumberOfStepsAtOrder(int order) const {
+	if (order < MIN_ORDER || order > MAX_ORDER) {
+		throw Exception("OdePost", "The Adams-Bashforth-Moulton order should be from 2 to 5");
+	}
+	return mStepsAtOrder[order];
+}
+
+template<class STATE>
+void AdamsBashforthMoultonOdeSolverT<STATE>::AddDerivative(const STATE& rDerivative) {
+	mNewest = (mNewest + 1) % HISTORY;
+	mDerivatives[mNewest] = rDerivative;
+	if (mNumberOfDerivatives < HISTORY) {
+		mNumberOfDerivatives++;
+	}
+}
+
+template<class STATE>
+void AdamsBashforthMoultonOdeSolverT<STATE>::ChooseOrder() {
+	// Backward differences of the latest derivative, del^k f_{n+1}, up to the order above the current one
+	const int highest = std::min(mCurrentOrder + 1, mNumberOfDerivatives - 1);
+	STATE differences[HISTORY];
+	for (int i = 0; i <= highest; i++) {
+		differences[i] = GetDerivative(i);
+	}
+	for (int k = 1; k <= highest; k++) {
+		for (int i = highest; i >= k; i--) {
+			differences[i] = differences[i - 1] - differences[i];
+		}
+	}
+	// Square of the estimated local error (over dt) of order p, for the neighbouring orders
+	double error[MAX_ORDER + 2];
+	for (int p = std::max(mCurrentOrder - 1, MIN_ORDER); p <= highest; p++) {
+		double sum = 0.0;
+		for (int j = 0; j < STATE::DIMENSION; j++) {
+			sum += double(differences[p][j])*double(differences[p][j]);
+		}
+		error[p] = AdamsCoefficients::ERROR[p]*AdamsCoefficients::ERROR[p]*sum;
+	}
+	if (mCurrentOrder > MIN_ORDER && error[mCurrentOrder - 1] <= error[mCurrentOrder]) {
+		mCurrentOrder--;
+	}
+	else if (mCurrentOrder < mOrder && highest > mCurrentOrder && error[mCurrentOrder + 1] < error[mCurrentOrder]) {
+		mCurrentOrder++;
+	}
+}
+
+template<class STATE>
+void AdamsBashforthMoultonOdeSolverT<STATE>::Solve() {
+	if (this->mpRhsFunction == NULL) {
+		throw Exception("OdeSolve", "Please define the right hand side function");
+	}
+	Solve(this->mpRhsFunction);
+}
+
+template<class STATE>
+template<class RHS>
+void AdamsBashforthMoultonOdeSolverT<STATE>::Solve(RHS rhs) {
+	mNewest = 0;
+	mNumberOfDerivatives = 0;
+	mCurrentOrder = mOrder;
+	mNumberOfStartingSteps = 0;
+	for (int order = 0; order <= MAX_ORDER; order++) {
+		mStepsAtOrder[order] = 0;
+	}
+	Stepper stepper = {*this};
+	// The derivative history is kept between steps, so no checkpoints
+	this->RunFixedTimeSteps(stepper, rhs, false);
+}
+
+template<class STATE>
+template<class RHS>
+void AdamsBashforthMoultonOdeSolverT<STATE>::TakeStep(RHS& rRhs, double t, double dt, STATE& v) {
+	STATE f;
+	if (mNumberOfDerivatives == 0) {
+		rRhs(v, t, f);
+		AddDerivative(f);
+	}
+	if (mNumberOfDerivatives < mCurrentOrder) {
+		// Start with RK4, whose first stage is the derivative already in the history
+		const STATE& k1 = GetDerivative(0);
+		STATE k2, k3, k4;
+		rRhs(STATE(v + k1*(0.5*dt)), t + 0.5*dt, k2);
+		rRhs(STATE(v + k2*(0.5*dt)), t + 0.5*dt, k3);
+		rRhs(STATE(v + k3*dt), t + dt, k4);
+		v += (k1 + (k2 + k3)*2.0 + k4)*(dt/6.0);
+		rRhs(v, t + dt, f);
+		AddDerivative(f);
+		mNumberOfStartingSteps++;
+		return;
+	}
+
+	// Predict
+	const int order = mCurrentOrder;
+	STATE increment = GetDerivative(0)*AdamsCoefficients::BASHFORTH[order][0];
+	for (int j = 1; j < order; j++) {
+		increment += GetDerivative(j)*AdamsCoefficients::BASHFORTH[order][j];
+	}
+	rRhs(STATE(v + increment*dt), t + dt, f);
+
+	// Correct
+	increment = f*AdamsCoefficients::MOULTON[order][0];
+	for (int j = 1; j < order; j++) {
+		increment += GetDerivative(j - 1)*AdamsCoefficients::MOULTON[order][j];
+	}
+	v += increment*dt;
+	if (mEvaluateAfterCorrection) {
+		rRhs(v, t + dt, f);
+	}
+	AddDerivative(f);
+	mStepsAtOrder[order]++;
+
+	if (mVariableOrder) {
+		ChooseOrder();
+	}
+}
+
+/** The 2-D solver */
+typedef AdamsBashforthMoultonOdeSolverT<Pair> AdamsBashforthMoultonOdeSolver;
+// Compiled once in AdamsBashforthMoultonOdeSolver.cpp
+extern template class AdamsBashforthMoultonOdeSolverT<Pair>;
+
+#endif /* ADAMSBASHFORTHMOULTONODESOLVER_HPP_ */
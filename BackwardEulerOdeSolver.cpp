@@ -0,0 +1,13 @@
+/*
+ * BackwardEulerOdeSolver.cpp
+ *
+ * Implements the implicit (backward) Euler solver for stiff problems
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include "BackwardEulerOdeSolver.hpp"
+
+// The methods are templates defined in the header.  The 2-D (Pair) version is compiled here once.
+template class BackwardEulerOdeSolverT<Pair>;
@@ -0,0 +1,99 @@
+/*
+ * BackwardEulerOdeSolver.hpp
+ *
+ * Implements the implicit (backward) Euler solver for stiff problems
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef BACKWARDEULERODESOLVER_HPP_
+#define BACKWARDEULERODESOLVER_HPP_
+
+#include "AbstractImplicitOdeSolver.hpp"
+
+/**
+ * Backward (implicit) Euler: v_{n+1} = v_n + dt*f(t_{n+1}, v_{n+1}), solved by Newton iteration.
+ * First order, but L-stable, so the time-step is limited by accuracy and not by stiffness.
+ */
+template<class STATE>
+class BackwardEulerOdeSolverT: public AbstractImplicitOdeSolverT<STATE> {
+public:
+	BackwardEulerOdeSolverT();
+	virtual ~BackwardEulerOdeSolverT();
+
+	std::string GetSolverName() const {
+		return "BackwardEuler";
+	}
+
+	/**
+	 * Solve with the function pointers set by SetRhsFunction() and (if it was called)
+	 * SetJacobianFunction().  Without a Jacobian function, finite differences are used.
+	 */
+	void Solve();
+
+	/** Solve with any callable right-hand side rhs(v, t, dvdt), using a finite difference Jacobian */
+	template<class RHS>
+	void Solve(RHS rhs);
+
+	/**
+	 * Solve with any callable right-hand side and Jacobian jacobian(v, t, J).  Pass
+	 * FiniteDifferenceJacobian() as the Jacobian to use finite differences.
+	 */
+	template<class RHS, class JACOBIAN>
+	void Solve(RHS rhs, JACOBIAN jacobian);
+
+	/** Advance v over one time step from time t to t+dt */
+	template<class RHS, class JACOBIAN>
+	void TakeStep(RHS& rRhs, JACOBIAN& rJacobian, double t, double dt, STATE& v);
+};
+
+template<class STATE>
+BackwardEulerOdeSolverT<STATE>::BackwardEulerOdeSolverT() {
+}
+
+template<class STATE>
+BackwardEulerOdeSolverT<STATE>::~BackwardEulerOdeSolverT() {
+}
+
+template<class STATE>
+void BackwardEulerOdeSolverT<STATE>::Solve() {
+	if (this->mpRhsFunction == NULL) {
+		throw Exception("OdeSolve", "Please define the right hand side function");
+	}
+	if (this->mpJacobianFunction != NULL) {
+		Solve(this->mpRhsFunction, this->mpJacobianFunction);
+	}
+	else {
+		Solve(this->mpRhsFunction);
+	}
+}
+
+template<class STATE>
+template<class RHS>
+void BackwardEulerOdeSolverT<STATE>::Solve(RHS rhs) {
+	Solve(rhs, FiniteDifferenceJacobian());
+}
+
+template<class STATE>
+template<class RHS, class JACOBIAN>
+void BackwardEulerOdeSolverT<STATE>::Solve(RHS rhs, JACOBIAN jacobian) {
+	this->RunImplicitTimeSteps(*this, rhs, jacobian);
+}
+
+template<class STATE>
+template<class RHS, class JACOBIAN>
+void BackwardEulerOdeSolverT<STATE>::TakeStep(RHS& rRhs, JACOBIAN& rJacobian, double t, double dt, STATE& v) {
+	this->UpdateJacobian(rRhs, rJacobian, t, v);
+	// Start the Newton iteration from the old values
+	STATE v_new = v;
+	this->SolveImplicitStage(rRhs, rJacobian, t + dt, dt, v, v_new);
+	v = v_new;
+}
+
+/** The 2-D solver */
+typedef BackwardEulerOdeSolverT<Pair> BackwardEulerOdeSolver;
+// Compiled once in BackwardEulerOdeSolver.cpp
+extern template class BackwardEulerOdeSolverT<Pair>;
+
+#endif /* BACKWARDEULERODESOLVER_HPP_ */
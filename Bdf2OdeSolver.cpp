@@ -0,0 +1,13 @@
+/*
+ * Bdf2OdeSolver.cpp
+ *
+ * Implements the second order backward differentiation formula (BDF2) solver for stiff problems
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include "Bdf2OdeSolver.hpp"
+
+// The methods are templates defined in the header.  The 2-D (Pair) version is compiled here once.
+template class Bdf2OdeSolverT<Pair>;
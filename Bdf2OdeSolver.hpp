@@ -0,0 +1,117 @@
+/*
+ * Bdf2OdeSolver.hpp
+ *
+ * Implements the second order backward differentiation formula (BDF2) solver for stiff problems
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef BDF2ODESOLVER_HPP_
+#define BDF2ODESOLVER_HPP_
+
+#include "AbstractImplicitOdeSolver.hpp"
+
+/**
+ * Second order backward differentiation formula:
+ *     v_{n+1} - 4/3 v_n + 1/3 v_{n-1} = 2/3 dt f(t_{n+1}, v_{n+1})
+ * solved by Newton iteration.  A-stable.  The first step, which has no v_{n-1}, is backward Euler.
+ */
+template<class STATE>
+class Bdf2OdeSolverT: public AbstractImplicitOdeSolverT<STATE> {
+private:
+	/** Values at the start of the previous step */
+	STATE mPreviousValues;
+	/** Whether mPreviousValues has been set in this solve */
+	bool mHavePreviousValues;
+
+public:
+	Bdf2OdeSolverT();
+	virtual ~Bdf2OdeSolverT();
+
+	std::string GetSolverName() const {
+		return "BDF2";
+	}
+
+	/**
+	 * Solve with the function pointers set by SetRhsFunction() and (if it was called)
+	 * SetJacobianFunction().  Without a Jacobian function, finite differences are used.
+	 */
+	void Solve();
+
+	/** Solve with any callable right-hand side rhs(v, t, dvdt), using a finite difference Jacobian */
+	template<class RHS>
+	void Solve(RHS rhs);
+
+	/**
+	 * Solve with any callable right-hand side and Jacobian jacobian(v, t, J).  Pass
+	 * FiniteDifferenceJacobian() as the Jacobian to use finite differences.
+	 */
+	template<class RHS, class JACOBIAN>
+	void Solve(RHS rhs, JACOBIAN jacobian);
+
+	/** Advance v over one time step from time t to t+dt */
+	template<class RHS, class JACOBIAN>
+	void TakeStep(RHS& rRhs, JACOBIAN& rJacobian, double t, double dt, STATE& v);
+};
+
+template<class STATE>
+Bdf2OdeSolverT<STATE>::Bdf2OdeSolverT() {
+	mHavePreviousValues = false;
+}
+
+template<class STATE>
+Bdf2OdeSolverT<STATE>::~Bdf2OdeSolverT() {
+}
+
+template<class STATE>
+void Bdf2OdeSolverT<STATE>::Solve() {
+	if (this->mpRhsFunction == NULL) {
+		throw Exception("OdeSolve", "Please define the right hand side function");
+	}
+	if (this->mpJacobianFunction != NULL) {
+		Solve(this->mpRhsFunction, this->mpJacobianFunction);
+	}
+	else {
+		Solve(this->mpRhsFunction);
+	}
+}
+
+template<class STATE>
+template<class RHS>
+void Bdf2OdeSolverT<STATE>::Solve(RHS rhs) {
+	Solve(rhs, FiniteDifferenceJacobian());
+}
+
+template<class STATE>
+template<class RHS, class JACOBIAN>
+void Bdf2OdeSolverT<STATE>::Solve(RHS rhs, JACOBIAN jacobian) {
+	mHavePreviousValues = false;
+	this->RunImplicitTimeSteps(*this, rhs, jacobian);
+}
+
+template<class STATE>
+template<class RHS, class JACOBIAN>
+void Bdf2OdeSolverT<STATE>::TakeStep(RHS& rRhs, JACOBIAN& rJacobian, double t, double dt, STATE& v) {
+	this->UpdateJacobian(rRhs, rJacobian, t, v);
+	STATE v_new;
+	if (!mHavePreviousValues) {
+		v_new = v;
+		this->SolveImplicitStage(rRhs, rJacobian, t + dt, dt, v, v_new);
+	}
+	else {
+		// Start the Newton iteration from the linear extrapolation of the last two steps
+		v_new = v*2.0 - mPreviousValues;
+		this->SolveImplicitStage(rRhs, rJacobian, t + dt, dt*2.0/3.0, v*(4.0/3.0) - mPreviousValues/3.0, v_new);
+	}
+	mPreviousValues = v;
+	mHavePreviousValues = true;
+	v = v_new;
+}
+
+/** The 2-D solver */
+typedef Bdf2OdeSolverT<Pair> Bdf2OdeSolver;
+// Compiled once in Bdf2OdeSolver.cpp
+extern template class Bdf2OdeSolverT<Pair>;
+
+#endif /* BDF2ODESOLVER_HPP_ */
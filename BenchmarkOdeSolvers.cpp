@@ -0,0 +1,1234 @@
+/*
+ * BenchmarkOdeSolvers.cpp
+ *
+ * Timings for the ODE solvers.  Build and run with "make bench".
+ * The results are written to standard output as one JSON document:
+ *     {"compiler": "...", "benchmarks": [{"name": "...", ...}, ...]}
+ * An optional argument limits the largest number of steps (default 10^8), e.g. "make bench BENCH_ARGS=1e6".
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AbstractOdeSolver.hpp"
+#include "ForwardEulerOdeSolver.hpp"
+#include "HigherOrderOdeSolver.hpp"
+#include "RK4Solver.hpp"
+#include "ExplicitRungeKuttaOdeSolver.hpp"
+#include "EnsembleOdeSolver.hpp"
+#include "LargeSystemOdeSolver.hpp"
+#include "DormandPrinceOdeSolver.hpp"
+#include "AdamsBashforthMoultonOdeSolver.hpp"
+#include "BackwardEulerOdeSolver.hpp"
+#include "Bdf2OdeSolver.hpp"
+#include "RosenbrockOdeSolver.hpp"
+#include "StormerVerletOdeSolver.hpp"
+#include "Yoshida4OdeSolver.hpp"
+#include "ThreadPool.hpp"
+
+/*
+ * Every heap allocation in the program goes through these, so that each benchmark can report the
+ * bytes it allocated
+ */
+std::atomic<unsigned long long> gBytesAllocated(0);
+std::atomic<unsigned long long> gNumberOfAllocations(0);
+
+void* operator new(std::size_t size)
+{
+    gBytesAllocated += size;
+    gNumberOfAllocations++;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+/* Unit circle, as in the test suites */
+void RhsCircle(const Pair& v, double t, Pair& dvdt)
+{
+    dvdt.x = -v.y;
+    dvdt.y =  v.x;
+}
+
+/* Van der Pol oscillator with mu=7, as in TestRK4Solver.hpp */
+void RhsVanderPol(const Pair& v, double t, Pair& dvdt)
+{
+    double mu = 7;
+    dvdt.x = mu * (v.x - pow(v.x, 3) / 3.0 - v.y);
+    dvdt.y = v.x / mu;
+}
+
+/* Van der Pol with any mu, for the stiff runs */
+struct VanderPolRhs
+{
+    double mu;
+
+    void operator()(const Pair& v, double t, Pair& dvdt) const
+    {
+        dvdt.x = mu * (v.x - pow(v.x, 3) / 3.0 - v.y);
+        dvdt.y = v.x / mu;
+    }
+};
+
+void BatchRhsVanderPol(const double* x, const double* y, double t, double* dxdt, double* dydt, unsigned size)
+{
+    double mu = 7;
+    for (unsigned i=0; i<size; i++)
+    {
+        dxdt[i] = mu * (x[i] - x[i]*x[i]*x[i] / 3.0 - y[i]);
+        dydt[i] = x[i] / mu;
+    }
+}
+
+/* The circle in any precision, for BenchmarkPrecision() */
+struct CircleRhs
+{
+    template<class STATE>
+    void operator()(const STATE& v, double t, STATE& dvdt) const
+    {
+        dvdt.x = -v.y;
+        dvdt.y =  v.x;
+    }
+};
+
+/* Van der Pol with mu=7 in any precision: the arithmetic is done in the state's precision */
+struct PrecisionVanderPolRhs
+{
+    template<class STATE>
+    void operator()(const STATE& v, double t, STATE& dvdt) const
+    {
+        typedef typename STATE::ValueType S;
+        const S mu = 7;
+        dvdt.x = mu * (v.x - v.x*v.x*v.x / S(3) - v.y);
+        dvdt.y = v.x / mu;
+    }
+};
+
+template<class T>
+void BatchRhsCircleT(const T* x, const T* y, double t, T* dxdt, T* dydt, unsigned size)
+{
+    for (unsigned i=0; i<size; i++)
+    {
+        dxdt[i] = -y[i];
+        dydt[i] =  x[i];
+    }
+}
+
+template<class T>
+void BatchRhsVanderPolT(const T* x, const T* y, double t, T* dxdt, T* dydt, unsigned size)
+{
+    const T mu = 7;
+    for (unsigned i=0; i<size; i++)
+    {
+        dxdt[i] = mu * (x[i] - x[i]*x[i]*x[i] / T(3) - y[i]);
+        dydt[i] = x[i] / mu;
+    }
+}
+
+/* The 1-D heat equation by central differences, with zero boundary values, for BenchmarkLargeSystem() */
+struct HeatEquationRhs
+{
+    void operator()(const double* v, double t, double* dvdt, std::size_t begin, std::size_t end, std::size_t size) const
+    {
+        const double scale = (size + 1.0)*(size + 1.0);
+        std::size_t i = begin;
+        if (i == 0 && i < end)
+        {
+            dvdt[0] = scale*(-2.0*v[0] + v[1]);
+            i++;
+        }
+        const std::size_t interior_end = std::min(end, size - 1);
+        for (; i < interior_end; i++)
+        {
+            dvdt[i] = scale*(v[i - 1] - 2.0*v[i] + v[i + 1]);
+        }
+        if (i < end)
+        {
+            dvdt[i] = scale*(v[i - 1] - 2.0*v[i]);
+        }
+    }
+};
+
+/** Wall-clock seconds since an arbitrary starting point */
+double WallTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * One benchmark result: a JSON object built up one field at a time
+ */
+class JsonRecord
+{
+private:
+    std::string mText;
+
+public:
+    JsonRecord(const std::string& name)
+        : mText("{\"name\": \"" + name + "\"")
+    {}
+
+    void Add(const std::string& key, const std::string& value)
+    {
+        mText += ", \"" + key + "\": \"" + value + "\"";
+    }
+
+    void Add(const std::string& key, bool value)
+    {
+        mText += ", \"" + key + "\": " + (value ? "true" : "false");
+    }
+
+    /** Numbers that aren't finite (e.g. from an unmeasurably short time) are written as null */
+    void Add(const std::string& key, double value)
+    {
+        std::ostringstream number;
+        number.precision(6);
+        if (std::isfinite(value))
+        {
+            number << value;
+        }
+        else
+        {
+            number << "null";
+        }
+        mText += ", \"" + key + "\": " + number.str();
+    }
+
+    std::string GetText() const
+    {
+        return mText + "}";
+    }
+};
+
+/** All of the results, written out by main() */
+std::vector<JsonRecord> gRecords;
+
+/**
+ * One solver on one problem: steps/s, right-hand side evaluations/s (from the solver's stats), ns/step
+ * and heap use.
+ * Short solves are repeated until they have taken at least a tenth of a second, and the figures are
+ * per solve.  Each solve uses a new solver, so allocating the trace is part of the cost.
+ */
+template<class SOLVER>
+void BenchmarkSolver(const std::string& solverName, const std::string& problem,
+                     void (*pRhs)(const Pair&, double, Pair&), int64_t numSteps, bool storeTrace)
+{
+    unsigned long long rhs_evaluations = 0;
+    const unsigned long long bytes_before = gBytesAllocated;
+    const unsigned long long allocations_before = gNumberOfAllocations;
+    double checksum = 0.0;
+    int repetitions = 0;
+    const double start = WallTime();
+    double elapsed = 0.0;
+    do
+    {
+        SOLVER solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetRhsFunction(pRhs);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, numSteps, 10.0);
+        solver.SetStoreTrace(storeTrace);
+        FinalStateObserverT<Pair> final_state;
+        if (!storeTrace)
+        {
+            solver.AddObserver(&final_state);
+        }
+        solver.Solve();
+        checksum += storeTrace ? solver.GetXView().back() : final_state.GetFinalValues().x;
+        rhs_evaluations += solver.GetStats().rhsEvaluations;
+        repetitions++;
+        elapsed = WallTime() - start;
+    }
+    while (elapsed < 0.1);
+
+    const double time = elapsed/repetitions;
+    JsonRecord record("solver");
+    record.Add("solver", solverName);
+    record.Add("problem", problem);
+    record.Add("store_trace", storeTrace);
+    record.Add("steps", (double) numSteps);
+    record.Add("repetitions", (double) repetitions);
+    record.Add("seconds_per_solve", time);
+    record.Add("steps_per_s", numSteps/time);
+    record.Add("rhs_evaluations_per_s", (rhs_evaluations/(double) repetitions)/time);
+    record.Add("rhs_evaluations_per_step", rhs_evaluations/((double) repetitions*numSteps));
+    record.Add("ns_per_step", 1e9*time/numSteps);
+    record.Add("bytes_allocated", (gBytesAllocated - bytes_before)/(double) repetitions);
+    record.Add("allocations", (gNumberOfAllocations - allocations_before)/(double) repetitions);
+    record.Add("final_x", checksum/repetitions);
+    gRecords.push_back(record);
+}
+
+/**
+ * Every fixed-step solver on both problems at 10^3, 10^4, ..., maxSteps steps.  Traces of 10^8 points
+ * need 2.4 GB, so the runs that store the trace stop at 10^7 steps
+ */
+void BenchmarkSolvers(int64_t maxSteps)
+{
+    const std::string problems[] = {"circle", "vanderpol"};
+    void (*rhs_functions[])(const Pair&, double, Pair&) = {&RhsCircle, &RhsVanderPol};
+    for (int p=0; p<2; p++)
+    {
+        for (int64_t num_steps=1000; num_steps<=maxSteps; num_steps*=10)
+        {
+            for (int store=1; store>=0; store--)
+            {
+                if (store && num_steps > 10000000)
+                {
+                    continue;
+                }
+                BenchmarkSolver<ForwardEulerOdeSolver>("ForwardEuler", problems[p], rhs_functions[p], num_steps, store);
+                BenchmarkSolver<HigherOrderOdeSolver>("RungeKutta2", problems[p], rhs_functions[p], num_steps, store);
+                BenchmarkSolver<RK4Solver>("RungeKutta4", problems[p], rhs_functions[p], num_steps, store);
+                BenchmarkSolver<HeunOdeSolver>("Heun", problems[p], rhs_functions[p], num_steps, store);
+                BenchmarkSolver<RalstonOdeSolver>("Ralston", problems[p], rhs_functions[p], num_steps, store);
+                BenchmarkSolver<SspRungeKutta3OdeSolver>("SspRungeKutta3", problems[p], rhs_functions[p], num_steps, store);
+                BenchmarkSolver<RungeKutta38OdeSolver>("RungeKutta38", problems[p], rhs_functions[p], num_steps, store);
+            }
+        }
+    }
+}
+
+/**
+ * Pulling the steps from a stepper one at a time, N at a time and as a range, against Solve()
+ * without a trace.  The allocations are those made while stepping (after the stepper is made).
+ */
+template<class SOLVER>
+void BenchmarkStepper(const std::string& solverName, const std::string& problem,
+                      void (*pRhs)(const Pair&, double, Pair&), int64_t numSteps)
+{
+    SOLVER solver;
+    solver.SetInitialValues(1.0, 0.0);
+    solver.SetRhsFunction(pRhs);
+    solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, numSteps, 10.0);
+    solver.SetStoreTrace(false);
+    const std::string modes[] = {"solve", "step", "advance", "range"};
+    for (int mode=0; mode<4; mode++)
+    {
+        auto stepper = solver.GetStepper();
+        const unsigned long long allocations_before = gNumberOfAllocations;
+        double checksum = 0.0;
+        const double start = WallTime();
+        if (mode == 0)
+        {
+            FinalStateObserverT<Pair> final_state;
+            solver.AddObserver(&final_state);
+            solver.Solve();
+            solver.RemoveAllObservers();
+            checksum = final_state.GetFinalValues().x;
+        }
+        else if (mode == 1)
+        {
+            while (stepper.Step())
+            {
+            }
+            checksum = stepper.GetValues().x;
+        }
+        else if (mode == 2)
+        {
+            // Blocks of 1000 steps, as a pipeline might take them
+            while (stepper.Advance(1000) > 0)
+            {
+            }
+            checksum = stepper.GetValues().x;
+        }
+        else
+        {
+            for (const auto& point : stepper)
+            {
+                checksum = point.values.x;
+            }
+        }
+        const double time = WallTime() - start;
+        const unsigned long long allocations = gNumberOfAllocations - allocations_before;
+
+        JsonRecord record("stepper");
+        record.Add("solver", solverName);
+        record.Add("problem", problem);
+        record.Add("mode", modes[mode]);
+        record.Add("steps", (double) numSteps);
+        record.Add("seconds", time);
+        record.Add("ns_per_step", 1e9*time/numSteps);
+        record.Add("allocations", (double) allocations);
+        record.Add("final_x", checksum);
+        gRecords.push_back(record);
+    }
+}
+
+/**
+ * N separate RK4Solver::Solve() calls against one EnsembleOdeSolver::Solve() over the same N initial conditions
+ */
+void BenchmarkEnsemble(unsigned ensembleSize, int64_t numSteps)
+{
+    std::vector<double> x0, y0;
+    for (unsigned i=0; i<ensembleSize; i++)
+    {
+        x0.push_back(-2.0 + 4.0*i/ensembleSize);
+        y0.push_back(0.5);
+    }
+
+    double start = WallTime();
+    double checksum_scalar = 0.0;
+    RK4Solver scalar_solver;
+    scalar_solver.SetRhsFunction(&RhsVanderPol);
+    scalar_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, numSteps, 10.0);
+    for (unsigned i=0; i<ensembleSize; i++)
+    {
+        scalar_solver.SetInitialValues(x0[i], y0[i]);
+        scalar_solver.Solve();
+        checksum_scalar += scalar_solver.GetXTrace().back();
+    }
+    double scalar_time = WallTime() - start;
+
+    start = WallTime();
+    EnsembleOdeSolver ensemble_solver;
+    ensemble_solver.SetBatchRhsFunction(&BatchRhsVanderPol);
+    ensemble_solver.SetEnsembleInitialValues(x0, y0);
+    ensemble_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, numSteps, 10.0);
+    ensemble_solver.Solve();
+    std::vector<double> x = ensemble_solver.GetFinalXValues();
+    double checksum_ensemble = 0.0;
+    for (unsigned i=0; i<ensembleSize; i++)
+    {
+        checksum_ensemble += x[i];
+    }
+    double ensemble_time = WallTime() - start;
+
+    JsonRecord record("ensemble_rk4");
+    record.Add("problem", std::string("vanderpol"));
+    record.Add("members", (double) ensembleSize);
+    record.Add("steps", (double) numSteps);
+    record.Add("scalar_s", scalar_time);
+    record.Add("ensemble_s", ensemble_time);
+    record.Add("speedup", scalar_time/ensemble_time);
+    record.Add("checksum_difference", checksum_scalar - checksum_ensemble);
+    gRecords.push_back(record);
+}
+
+/**
+ * Allocates on 64-byte boundaries, so that the arrays timed by BenchmarkStateArithmetic() all start
+ * at the same place in a cache line (otherwise the 512-bit loads of whichever arrays malloc()
+ * happened to misalign are split over two lines, which costs more than the arithmetic being timed)
+ */
+template<class T>
+struct CacheLineAllocator
+{
+    typedef T value_type;
+
+    CacheLineAllocator()
+    {
+    }
+
+    template<class U>
+    CacheLineAllocator(const CacheLineAllocator<U>&)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(::operator new(n*sizeof(T), std::align_val_t(64)));
+    }
+
+    void deallocate(T* p, std::size_t)
+    {
+        ::operator delete(p, std::align_val_t(64));
+    }
+
+    template<class U>
+    bool operator==(const CacheLineAllocator<U>&) const
+    {
+        return true;
+    }
+
+    template<class U>
+    bool operator!=(const CacheLineAllocator<U>&) const
+    {
+        return false;
+    }
+};
+
+template<class T>
+using CacheLineVector = std::vector<T, CacheLineAllocator<T> >;
+
+/*
+ * The state arithmetic as it was before the expression templates in State.hpp, for
+ * BenchmarkStateArithmetic(): every operator works out and returns a whole new state
+ */
+template<int N>
+struct TemporaryState
+{
+    double values[N];
+};
+
+template<int N>
+TemporaryState<N> operator+(const TemporaryState<N>& a, const TemporaryState<N>& b)
+{
+    TemporaryState<N> result;
+    ForEachComponent<N>([&](int i) { result.values[i] = a.values[i] + b.values[i]; });
+    return result;
+}
+
+template<int N>
+TemporaryState<N> operator*(const TemporaryState<N>& a, double b)
+{
+    TemporaryState<N> result;
+    ForEachComponent<N>([&](int i) { result.values[i] = a.values[i] * b; });
+    return result;
+}
+
+template<int N>
+TemporaryState<N> operator/(const TemporaryState<N>& a, double b)
+{
+    TemporaryState<N> result;
+    ForEachComponent<N>([&](int i) { result.values[i] = a.values[i] / b; });
+    return result;
+}
+
+/**
+ * Seconds per RK4 update of every state in rV, written as v + (k1/6 + k2/3 + k3/3 + k4/6)*dt (the
+ * original RK4Solver's expression) or with multiplications only, as the solvers now do it.  It is
+ * never inlined, so that both kinds of state are timed in the same surroundings: otherwise GCC inlines
+ * some instantiations into the caller, where it can see that the vectors don't overlap, and not others
+ */
+template<bool DIVIDE, class STATE>
+__attribute__((noinline)) double TimeRk4Update(CacheLineVector<STATE>& rV, const CacheLineVector<STATE>& rK1, const CacheLineVector<STATE>& rK2,
+                     const CacheLineVector<STATE>& rK3, const CacheLineVector<STATE>& rK4)
+{
+    const double dt = 1e-3;
+    long updates = 0;
+    const double start = WallTime();
+    double elapsed = 0.0;
+    do
+    {
+        for (int repetition=0; repetition<100; repetition++)
+        {
+            for (unsigned i=0; i<rV.size(); i++)
+            {
+                if (DIVIDE)
+                {
+                    rV[i] = rV[i] + (rK1[i]/6.0 + rK2[i]/3.0 + rK3[i]/3.0 + rK4[i]/6.0)*dt;
+                }
+                else
+                {
+                    rV[i] = rV[i] + (rK1[i]*(dt/6.0) + rK2[i]*(dt/3.0) + rK3[i]*(dt/3.0) + rK4[i]*(dt/6.0));
+                }
+            }
+        }
+        updates += 100*rV.size();
+        elapsed = WallTime() - start;
+    }
+    while (elapsed < 0.1);
+    return elapsed/updates;
+}
+
+/**
+ * The RK4 update of an N-variable state with the expression templates against the same expression
+ * with an operator per temporary state, over enough states to fill about 64 KB of each array
+ */
+template<int N>
+void BenchmarkStateArithmetic()
+{
+    const unsigned num_states = std::max(1, 1024/N);
+    CacheLineVector<State<N> > v(num_states), k[4];
+    CacheLineVector<TemporaryState<N> > temporary_v(num_states), temporary_k[4];
+    for (int s=0; s<4; s++)
+    {
+        k[s].resize(num_states);
+        temporary_k[s].resize(num_states);
+    }
+    for (unsigned i=0; i<num_states; i++)
+    {
+        for (int j=0; j<N; j++)
+        {
+            v[i][j] = temporary_v[i].values[j] = 1.0 + j;
+            for (int s=0; s<4; s++)
+            {
+                k[s][i][j] = temporary_k[s][i].values[j] = cos(0.1*(i + j + s));
+            }
+        }
+    }
+
+    for (int divide=1; divide>=0; divide--)
+    {
+        const double temporary_time = divide ? TimeRk4Update<true>(temporary_v, temporary_k[0], temporary_k[1], temporary_k[2], temporary_k[3])
+                                             : TimeRk4Update<false>(temporary_v, temporary_k[0], temporary_k[1], temporary_k[2], temporary_k[3]);
+        const double expression_time = divide ? TimeRk4Update<true>(v, k[0], k[1], k[2], k[3])
+                                              : TimeRk4Update<false>(v, k[0], k[1], k[2], k[3]);
+
+        JsonRecord record("state_arithmetic");
+        record.Add("expression", std::string(divide ? "v + (k1/6 + k2/3 + k3/3 + k4/6)*dt"
+                                                    : "v + (k1*(dt/6) + k2*(dt/3) + k3*(dt/3) + k4*(dt/6))"));
+        record.Add("dimension", (double) N);
+        record.Add("states", (double) num_states);
+        record.Add("temporaries_ns_per_update", 1e9*temporary_time);
+        record.Add("expression_templates_ns_per_update", 1e9*expression_time);
+        record.Add("speedup", temporary_time/expression_time);
+        gRecords.push_back(record);
+    }
+}
+
+/**
+ * RK4 with the right-hand side as a function pointer against the same right-hand side as a lambda.
+ * Neither counts its calls (the solvers' stats count both the same way), so only the call differs.
+ */
+template<class RHS>
+void BenchmarkRhsPaths(const std::string& problem, void (*pRhs)(const Pair&, double, Pair&), RHS rhs, int64_t numSteps)
+{
+    RK4Solver solver;
+    solver.SetInitialValues(1.0, 0.0);
+    solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, numSteps, 2*M_PI);
+
+    solver.SetRhsFunction(pRhs);
+    solver.Solve(); // Warm-up, so that both timed runs reuse the trace storage
+    double start = WallTime();
+    solver.Solve();
+    double pointer_time = WallTime() - start;
+    double pointer_x = solver.GetXTrace().back();
+
+    start = WallTime();
+    solver.Solve(rhs);
+    double lambda_time = WallTime() - start;
+
+    JsonRecord record("rk4_rhs_paths");
+    record.Add("problem", problem);
+    record.Add("steps", (double) numSteps);
+    record.Add("pointer_ns_per_step", 1e9*pointer_time/numSteps);
+    record.Add("lambda_ns_per_step", 1e9*lambda_time/numSteps);
+    record.Add("speedup", pointer_time/lambda_time);
+    record.Add("x_difference", pointer_x - solver.GetXTrace().back());
+    gRecords.push_back(record);
+}
+
+/** Final values after one solve, with the right-hand side evaluations and time it took, for BenchmarkMultistep() */
+void RecordAccuracyPerEvaluation(AbstractOdeSolver& rSolver, const std::string& solverName, const std::string& problem,
+                                 void (*pRhs)(const Pair&, double, Pair&), int64_t numSteps, const Pair& rReference)
+{
+    rSolver.SetRhsFunction(pRhs);
+    rSolver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, numSteps, 10.0);
+    rSolver.SetStoreTrace(false);
+    FinalStateObserverT<Pair> final_state;
+    rSolver.AddObserver(&final_state);
+    const double start = WallTime();
+    rSolver.Solve();
+    const double time = WallTime() - start;
+    const Pair error = final_state.GetFinalValues() - rReference;
+
+    JsonRecord record("multistep");
+    record.Add("solver", solverName);
+    record.Add("problem", problem);
+    record.Add("steps", (double) numSteps);
+    record.Add("rhs_evaluations", (double) rSolver.GetStats().rhsEvaluations);
+    record.Add("ns_per_step", 1e9*time/numSteps);
+    record.Add("final_error", std::max(fabs(error.x), fabs(error.y)));
+    gRecords.push_back(record);
+}
+
+/**
+ * Accuracy against right-hand side evaluations: RK4 (four a step) and the Adams-Bashforth-Moulton
+ * solvers (one a step, two with PECE) of each order, and with variable order, at 10^2 to 10^5 steps
+ * over 0 <= t <= 10.  The reference for Van der Pol is RK4 with 10^6 steps.
+ */
+void BenchmarkMultistep(const std::string& problem, void (*pRhs)(const Pair&, double, Pair&))
+{
+    RK4Solver reference_solver;
+    reference_solver.SetInitialValues(1.0, 0.0);
+    reference_solver.SetRhsFunction(pRhs);
+    reference_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000000, 10.0);
+    reference_solver.Solve();
+    Pair reference(reference_solver.GetXView().back(), reference_solver.GetYView().back());
+    if (problem == "circle")
+    {
+        reference = Pair(cos(10.0), sin(10.0));
+    }
+
+    for (int64_t num_steps=100; num_steps<=100000; num_steps*=10)
+    {
+        RK4Solver rk4_solver;
+        rk4_solver.SetInitialValues(1.0, 0.0);
+        RecordAccuracyPerEvaluation(rk4_solver, "RungeKutta4", problem, pRhs, num_steps, reference);
+        for (int order=AdamsBashforthMoultonOdeSolver::MIN_ORDER; order<=AdamsBashforthMoultonOdeSolver::MAX_ORDER; order++)
+        {
+            for (int pece=0; pece<2; pece++)
+            {
+                AdamsBashforthMoultonOdeSolver solver;
+                solver.SetInitialValues(1.0, 0.0);
+                solver.SetOrder(order);
+                solver.SetEvaluateAfterCorrection(pece);
+                RecordAccuracyPerEvaluation(solver, solver.GetSolverName() + (pece ? "PECE" : ""), problem, pRhs,
+                                            num_steps, reference);
+            }
+        }
+        AdamsBashforthMoultonOdeSolver variable_solver;
+        variable_solver.SetInitialValues(1.0, 0.0);
+        variable_solver.SetOrder(AdamsBashforthMoultonOdeSolver::MAX_ORDER);
+        variable_solver.SetVariableOrder(true);
+        RecordAccuracyPerEvaluation(variable_solver, variable_solver.GetSolverName(), problem, pRhs, num_steps, reference);
+    }
+}
+
+/** One precision's result in BenchmarkPrecision(): the time and errors are against the double precision run */
+void AddPrecisionRecord(const std::string& solverName, const std::string& problem, const std::string& precision,
+                        double numSteps, double time, double doubleTime, double maxError, double finalError,
+                        double traceBytes)
+{
+    JsonRecord record("precision");
+    record.Add("solver", solverName);
+    record.Add("problem", problem);
+    record.Add("precision", precision);
+    record.Add("steps", numSteps);
+    record.Add("ns_per_step", 1e9*time/numSteps);
+    record.Add("speedup", doubleTime/time);
+    record.Add("max_error", maxError);
+    record.Add("final_error", finalError);
+    record.Add("trace_bytes", traceBytes);
+    gRecords.push_back(record);
+}
+
+/** Time one RK4 solve (after a warm-up solve, so that the trace storage is reused) */
+template<class STATE, class RHS>
+double TimePrecisionSolve(RK4SolverT<STATE>& rSolver, RHS rhs, int64_t numSteps)
+{
+    rSolver.SetInitialValues(1.0, 0.0);
+    rSolver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, numSteps, 10.0);
+    rSolver.Solve(rhs);
+    const double start = WallTime();
+    rSolver.Solve(rhs);
+    return WallTime() - start;
+}
+
+/** Largest difference over the whole trace, and at the end time, from the double precision solution */
+template<class STATE>
+void TraceDifferences(const RK4SolverT<STATE>& rSolver, const RK4Solver& rReference, double& rMax, double& rFinal)
+{
+    TraceViewT<typename STATE::ValueType> x = rSolver.GetXView(), y = rSolver.GetYView();
+    TraceView x_reference = rReference.GetXView(), y_reference = rReference.GetYView();
+    rMax = 0.0;
+    for (std::size_t i=0; i<x.size(); i++)
+    {
+        rMax = std::max(rMax, std::max(fabs(x[i] - x_reference[i]), fabs(y[i] - y_reference[i])));
+    }
+    rFinal = std::max(fabs(x.back() - x_reference.back()), fabs(y.back() - y_reference.back()));
+}
+
+/** Time an ensemble solve, returning the final values (x-values then y-values) in double */
+template<class STATE>
+double TimePrecisionEnsemble(void (*pBatchRhs)(const typename STATE::ValueType*, const typename STATE::ValueType*,
+                                                double, typename STATE::ValueType*, typename STATE::ValueType*, unsigned),
+                             unsigned ensembleSize, int64_t numSteps, std::vector<double>& rFinalValues)
+{
+    typedef typename STATE::ValueType S;
+    std::vector<S> x0, y0;
+    for (unsigned i=0; i<ensembleSize; i++)
+    {
+        x0.push_back(S(-2.0 + 4.0*i/ensembleSize));
+        y0.push_back(S(0.5));
+    }
+    EnsembleOdeSolverT<STATE> solver;
+    solver.SetBatchRhsFunction(pBatchRhs);
+    solver.SetEnsembleInitialValues(x0, y0);
+    solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, numSteps, 10.0);
+    const double start = WallTime();
+    solver.Solve();
+    const double time = WallTime() - start;
+    std::vector<S> x = solver.GetFinalXValues(), y = solver.GetFinalYValues();
+    rFinalValues.assign(x.begin(), x.end());
+    rFinalValues.insert(rFinalValues.end(), y.begin(), y.end());
+    return time;
+}
+
+/** Largest difference between two ensembles' final values */
+double MaxDifference(const std::vector<double>& rValues, const std::vector<double>& rReference)
+{
+    double max_difference = 0.0;
+    for (std::size_t i=0; i<rValues.size(); i++)
+    {
+        max_difference = std::max(max_difference, fabs(rValues[i] - rReference[i]));
+    }
+    return max_difference;
+}
+
+/**
+ * Accuracy lost against speed gained by solving in single precision: double, mixed (float state,
+ * double time) and float (float state and time) for RK4 with its trace at 10^5, 10^7, ... up to
+ * maxSteps steps, and for the ensemble solver, whose vector kernels do twice as many members at a
+ * time in float
+ */
+template<class RHS>
+void BenchmarkPrecision(const std::string& problem, RHS rhs,
+                        void (*pDoubleBatchRhs)(const double*, const double*, double, double*, double*, unsigned),
+                        void (*pFloatBatchRhs)(const float*, const float*, double, float*, float*, unsigned),
+                        int64_t maxSteps, unsigned ensembleSize, int64_t ensembleSteps)
+{
+    // Rounding errors build up with the number of steps, so try a short and a long solve
+    for (int64_t num_steps=100000; num_steps<=maxSteps; num_steps*=100)
+    {
+        double max_error, final_error;
+        RK4Solver double_solver;
+        const double double_time = TimePrecisionSolve(double_solver, rhs, num_steps);
+        AddPrecisionRecord("RungeKutta4", problem, "double", num_steps, double_time, double_time, 0.0, 0.0,
+                           (num_steps + 1.0)*(sizeof(double) + sizeof(Pair)));
+
+        RK4SolverT<MixedPair> mixed_solver;
+        const double mixed_time = TimePrecisionSolve(mixed_solver, rhs, num_steps);
+        TraceDifferences(mixed_solver, double_solver, max_error, final_error);
+        AddPrecisionRecord("RungeKutta4", problem, "mixed", num_steps, mixed_time, double_time, max_error, final_error,
+                           (num_steps + 1.0)*(sizeof(double) + sizeof(MixedPair)));
+
+        RK4SolverT<FloatPair> float_solver;
+        const double float_time = TimePrecisionSolve(float_solver, rhs, num_steps);
+        TraceDifferences(float_solver, double_solver, max_error, final_error);
+        AddPrecisionRecord("RungeKutta4", problem, "float", num_steps, float_time, double_time, max_error, final_error,
+                           (num_steps + 1.0)*(sizeof(double) + sizeof(FloatPair)));
+    }
+
+    // The ensemble traces only the first member, so compare all the final values
+    std::vector<double> double_values, mixed_values, float_values;
+    const double steps = (double) ensembleSize*ensembleSteps;
+    const double double_ensemble_time = TimePrecisionEnsemble<Pair>(pDoubleBatchRhs, ensembleSize, ensembleSteps, double_values);
+    const double mixed_ensemble_time = TimePrecisionEnsemble<MixedPair>(pFloatBatchRhs, ensembleSize, ensembleSteps, mixed_values);
+    const double float_ensemble_time = TimePrecisionEnsemble<FloatPair>(pFloatBatchRhs, ensembleSize, ensembleSteps, float_values);
+    AddPrecisionRecord("EnsembleRungeKutta4", problem, "double", steps, double_ensemble_time, double_ensemble_time,
+                       0.0, 0.0, (ensembleSteps + 1.0)*(sizeof(double) + sizeof(Pair)));
+    AddPrecisionRecord("EnsembleRungeKutta4", problem, "mixed", steps, mixed_ensemble_time, double_ensemble_time,
+                       MaxDifference(mixed_values, double_values), MaxDifference(mixed_values, double_values),
+                       (ensembleSteps + 1.0)*(sizeof(double) + sizeof(MixedPair)));
+    AddPrecisionRecord("EnsembleRungeKutta4", problem, "float", steps, float_ensemble_time, double_ensemble_time,
+                       MaxDifference(float_values, double_values), MaxDifference(float_values, double_values),
+                       (ensembleSteps + 1.0)*(sizeof(double) + sizeof(FloatPair)));
+}
+
+/**
+ * Memory bandwidth a plain loop reaches with numberOfThreads threads: the STREAM triad a = b + s*c
+ * over three arrays of the given size, split into one block per thread
+ */
+double TriadBandwidth(std::size_t size, unsigned numberOfThreads)
+{
+    std::vector<double> a(size, 0.0), b(size, 1.0), c(size, 2.0);
+    WorkStealingThreadPool pool(numberOfThreads);
+    const std::function<void(std::size_t)> triad = [&](std::size_t block)
+    {
+        const std::size_t end = (size*(block + 1))/numberOfThreads;
+        for (std::size_t i=(size*block)/numberOfThreads; i<end; i++)
+        {
+            a[i] = b[i] + 3.0*c[i];
+        }
+    };
+    pool.ParallelFor(numberOfThreads, triad);
+    int repetitions = 0;
+    const double start = WallTime();
+    double elapsed = 0.0;
+    do
+    {
+        pool.ParallelFor(numberOfThreads, triad);
+        repetitions++;
+        elapsed = WallTime() - start;
+    }
+    while (elapsed < 0.1);
+    return 3.0*sizeof(double)*size*repetitions/elapsed/1e9;
+}
+
+/**
+ * LargeSystemOdeSolver on the method-of-lines heat equation with the given number of unknowns, on
+ * 1, 2, 4, ... threads up to one per core.  A step is four fused passes over the system, which move
+ * 19 arrays' worth of data to or from memory between them (each of the first three stages reads its
+ * input and v and writes its derivative and the next stage's values; the last reads its input, v
+ * and k1 to k3 and writes k4 and v).  The effective bandwidth that gives is reported next to the
+ * triad's.
+ */
+void BenchmarkLargeSystem(std::size_t size, int64_t numSteps)
+{
+    const double bytes_per_step = 19.0*sizeof(double)*size;
+    std::vector<double> initial(size);
+    for (std::size_t i=0; i<size; i++)
+    {
+        initial[i] = sin(M_PI*(i + 1.0)/(size + 1.0));
+    }
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> thread_counts;
+    for (unsigned threads=1; threads<cores; threads*=2)
+    {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(cores);
+    for (unsigned t=0; t<thread_counts.size(); t++)
+    {
+        const unsigned threads = thread_counts[t];
+        LargeSystemOdeSolver solver;
+        solver.SetSystemInitialValues(initial);
+        solver.SetSystemRhsFunction(HeatEquationRhs());
+        solver.SetNumberOfThreads(threads);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, numSteps, numSteps*0.4/((size + 1.0)*(size + 1.0)));
+        solver.SetStoreTrace(false);
+
+        // The first solve allocates and first-touches the workspace and starts the threads
+        solver.Solve();
+        int repetitions = 0;
+        const double start = WallTime();
+        double elapsed = 0.0;
+        do
+        {
+            solver.Solve();
+            repetitions++;
+            elapsed = WallTime() - start;
+        }
+        while (elapsed < 0.1);
+        const double time_per_step = elapsed/((double) repetitions*numSteps);
+        const double triad = TriadBandwidth(size, threads);
+
+        JsonRecord record("large_system");
+        record.Add("solver", solver.GetSolverName());
+        record.Add("problem", std::string("heat1d"));
+        record.Add("unknowns", (double) size);
+        record.Add("threads", (double) threads);
+        record.Add("steps", (double) numSteps);
+        record.Add("repetitions", (double) repetitions);
+        record.Add("workspace_bytes", (double) solver.GetWorkspaceBytes());
+        record.Add("ns_per_step", 1e9*time_per_step);
+        record.Add("ns_per_unknown_step", 1e9*time_per_step/size);
+        record.Add("effective_gb_per_s", bytes_per_step/time_per_step/1e9);
+        record.Add("triad_gb_per_s", triad);
+        record.Add("fraction_of_triad", bytes_per_step/time_per_step/1e9/triad);
+        gRecords.push_back(record);
+    }
+}
+
+/** What a solver needed to reach the accuracy in BenchmarkStiffVanderPol() */
+struct StepsToAccuracy
+{
+    int64_t steps; ///< 0 if it never got there
+    double rhsEvaluations;
+    double jacobianEvaluations;
+    double seconds;
+    double error;
+};
+
+double NumberOfJacobianEvaluations(const AbstractOdeSolver& rSolver)
+{
+    return 0.0;
+}
+
+double NumberOfJacobianEvaluations(const AbstractImplicitOdeSolverT<Pair>& rSolver)
+{
+    return rSolver.GetNumberOfJacobianEvaluations();
+}
+
+/**
+ * The fewest steps (doubling from 10, up to 10^7) for which the solver's final values are within
+ * the tolerance of the reference.  Step sizes where the Newton iteration fails are skipped.
+ */
+template<class SOLVER>
+StepsToAccuracy FindStepsToAccuracy(double mu, const Pair& rInitialValues, double endTime,
+                                    const Pair& rReference, double tolerance)
+{
+    VanderPolRhs rhs = {mu};
+    StepsToAccuracy result = {0, 0.0, 0.0, 0.0, 0.0};
+    for (int64_t num_steps=10; num_steps<=10000000; num_steps*=2)
+    {
+        SOLVER solver;
+        solver.SetInitialValues(rInitialValues);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, endTime);
+        solver.SetStoreTrace(false);
+        FinalStateObserverT<Pair> final_state;
+        solver.AddObserver(&final_state);
+        double start = WallTime();
+        try
+        {
+            solver.Solve(rhs);
+        }
+        catch (Exception&)
+        {
+            continue;
+        }
+        double time = WallTime() - start;
+        Pair v = final_state.GetFinalValues();
+        double error = std::max(fabs(v.x - rReference.x), fabs(v.y - rReference.y));
+        if (error <= tolerance)
+        {
+            result.steps = num_steps;
+            result.rhsEvaluations = solver.GetStats().rhsEvaluations;
+            result.jacobianEvaluations = NumberOfJacobianEvaluations(solver);
+            result.seconds = time;
+            result.error = error;
+            break;
+        }
+    }
+    return result;
+}
+
+/**
+ * Steps and right-hand side evaluations (including those for the finite difference Jacobians) that
+ * RK4 and the implicit solvers need to get the final values of Van der Pol within the tolerance
+ */
+void BenchmarkStiffVanderPol(double mu, const Pair& rInitialValues, double endTime, double tolerance)
+{
+    DormandPrinceOdeSolver reference_solver;
+    reference_solver.SetInitialValues(rInitialValues);
+    reference_solver.SetTolerances(1e-12, 1e-12);
+    reference_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1, endTime);
+    reference_solver.SetStoreTrace(false);
+    FinalStateObserverT<Pair> reference;
+    reference_solver.AddObserver(&reference);
+    VanderPolRhs rhs = {mu};
+    reference_solver.Solve(rhs);
+
+    const std::string names[] = {"RungeKutta4", "BackwardEuler", "BDF2", "Rosenbrock2"};
+    StepsToAccuracy results[] = {
+        FindStepsToAccuracy<RK4Solver>(mu, rInitialValues, endTime, reference.GetFinalValues(), tolerance),
+        FindStepsToAccuracy<BackwardEulerOdeSolver>(mu, rInitialValues, endTime, reference.GetFinalValues(), tolerance),
+        FindStepsToAccuracy<Bdf2OdeSolver>(mu, rInitialValues, endTime, reference.GetFinalValues(), tolerance),
+        FindStepsToAccuracy<RosenbrockOdeSolver>(mu, rInitialValues, endTime, reference.GetFinalValues(), tolerance)
+    };
+    for (int i=0; i<4; i++)
+    {
+        JsonRecord record("stiff_vanderpol");
+        record.Add("solver", names[i]);
+        record.Add("mu", mu);
+        record.Add("end_time", endTime);
+        record.Add("tolerance", tolerance);
+        // Missing (not finite) if the solver never reached the tolerance
+        const double not_reached = results[i].steps > 0 ? 1.0 : NAN;
+        record.Add("steps", not_reached*results[i].steps);
+        record.Add("rhs_evaluations", not_reached*results[i].rhsEvaluations);
+        record.Add("jacobian_evaluations", not_reached*results[i].jacobianEvaluations);
+        record.Add("seconds", not_reached*results[i].seconds);
+        record.Add("error", not_reached*results[i].error);
+        // How many times more RK4 needed
+        const double compared = (results[0].steps > 0) ? not_reached : NAN;
+        record.Add("rk4_steps_ratio", compared*results[0].steps/results[i].steps);
+        record.Add("rk4_rhs_evaluations_ratio", compared*results[0].rhsEvaluations/results[i].rhsEvaluations);
+        gRecords.push_back(record);
+    }
+}
+
+/**
+ * Follows the error in the circle's energy x^2 + y^2 (which should stay at 1)
+ */
+class CircleEnergyObserver: public AbstractOdeObserverT<Pair>
+{
+private:
+    double mMaximumError;
+    double mFinalError;
+
+public:
+    CircleEnergyObserver() : mMaximumError(0.0), mFinalError(0.0) {}
+
+    void BeginSolve()
+    {
+        mMaximumError = 0.0;
+    }
+
+    void ObserveStep(double t, const Pair& rValues)
+    {
+        mFinalError = fabs(rValues.x*rValues.x + rValues.y*rValues.y - 1.0);
+        mMaximumError = std::max(mMaximumError, mFinalError);
+    }
+
+    double GetMaximumError() const
+    {
+        return mMaximumError;
+    }
+
+    double GetFinalError() const
+    {
+        return mFinalError;
+    }
+};
+
+/**
+ * Energy error on the circle after many circuits against the cost: force (right-hand side)
+ * evaluations and time per circuit
+ */
+template<class SOLVER>
+void BenchmarkEnergyDrift(const std::string& solverName, int stepsPerCircuit, int64_t circuits)
+{
+    SOLVER solver;
+    solver.SetInitialValues(1.0, 0.0);
+    solver.SetRhsFunction(&RhsCircle);
+    solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, stepsPerCircuit*circuits, 2*M_PI*circuits);
+    solver.SetStoreTrace(false);
+    CircleEnergyObserver energy;
+    solver.AddObserver(&energy);
+    double start = WallTime();
+    solver.Solve();
+    double time = WallTime() - start;
+
+    JsonRecord record("energy_drift");
+    record.Add("solver", solverName);
+    record.Add("problem", std::string("circle"));
+    record.Add("circuits", (double) circuits);
+    record.Add("steps_per_circuit", (double) stepsPerCircuit);
+    record.Add("rhs_evaluations_per_circuit", solver.GetStats().rhsEvaluations/(double) circuits);
+    record.Add("ns_per_circuit", 1e9*time/circuits);
+    record.Add("max_energy_error", energy.GetMaximumError());
+    record.Add("final_energy_error", energy.GetFinalError());
+    gRecords.push_back(record);
+}
+
+/**
+ * Text output rows/s: the original std::ofstream << double (precision 10) loop against DumpToFile,
+ * and the cost of streaming the text while solving, in the foreground and in the background
+ */
+void BenchmarkTextOutput(int64_t numSteps)
+{
+    RK4Solver solver;
+    solver.SetInitialValues(1.0, 0.0);
+    solver.SetRhsFunction(&RhsCircle);
+    solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, numSteps, 2*M_PI);
+    solver.Solve();
+    const double rows = numSteps + 1.0;
+
+    double start = WallTime();
+    {
+        std::vector<double> times = solver.GetTimeTrace();
+        std::vector<double> x = solver.GetXTrace();
+        std::vector<double> y = solver.GetYTrace();
+        std::ofstream write_output("bench_dump.txt");
+        write_output.precision(10);
+        for (std::size_t i=0; i<times.size(); i++)
+        {
+            write_output << times[i] << "\t" << x[i] << "\t" << y[i] << "\n";
+        }
+    }
+    double ostream_time = WallTime() - start;
+
+    start = WallTime();
+    solver.DumpToFile("bench_dump.txt");
+    double dump_time = WallTime() - start;
+
+    solver.SetStoreTrace(false);
+    start = WallTime();
+    solver.Solve();
+    double solve_time = WallTime() - start;
+
+    FileStreamObserverT<Pair> foreground_observer("bench_dump.txt");
+    solver.AddObserver(&foreground_observer);
+    start = WallTime();
+    solver.Solve();
+    double foreground_time = WallTime() - start;
+
+    solver.RemoveAllObservers();
+    FileStreamObserverT<Pair> background_observer("bench_dump.txt", true);
+    solver.AddObserver(&background_observer);
+    start = WallTime();
+    solver.Solve();
+    double background_time = WallTime() - start;
+    std::remove("bench_dump.txt");
+
+    JsonRecord record("text_output");
+    record.Add("rows", rows);
+    record.Add("ostream_rows_per_s", rows/ostream_time);
+    record.Add("dump_to_file_rows_per_s", rows/dump_time);
+    record.Add("speedup", ostream_time/dump_time);
+    record.Add("solve_only_s", solve_time);
+    record.Add("solve_streaming_foreground_s", foreground_time);
+    record.Add("solve_streaming_background_s", background_time);
+    gRecords.push_back(record);
+}
+
+int main(int argc, char* argv[])
+{
+    int64_t max_steps = 100000000;
+    if (argc > 1)
+    {
+        max_steps = (int64_t) std::atof(argv[1]);
+    }
+    BenchmarkSolvers(max_steps);
+    const int64_t stepper_steps = std::min<int64_t>(10000000, max_steps);
+    BenchmarkStepper<ForwardEulerOdeSolver>("ForwardEuler", "vanderpol", &RhsVanderPol, stepper_steps);
+    BenchmarkStepper<HigherOrderOdeSolver>("RungeKutta2", "vanderpol", &RhsVanderPol, stepper_steps);
+    BenchmarkStepper<RK4Solver>("RungeKutta4", "vanderpol", &RhsVanderPol, stepper_steps);
+    BenchmarkTextOutput(2000000);
+    BenchmarkRhsPaths("circle", &RhsCircle, [](const Pair& v, double t, Pair& dvdt) {
+        dvdt.x = -v.y;
+        dvdt.y =  v.x;
+    }, 10000000);
+    double mu = 7;
+    BenchmarkRhsPaths("vanderpol", &RhsVanderPol, [mu](const Pair& v, double t, Pair& dvdt) {
+        dvdt.x = mu * (v.x - pow(v.x, 3) / 3.0 - v.y);
+        dvdt.y = v.x / mu;
+    }, 10000000);
+
+    BenchmarkStateArithmetic<2>();
+    BenchmarkStateArithmetic<3>();
+    BenchmarkStateArithmetic<8>();
+    BenchmarkStateArithmetic<32>();
+    BenchmarkStateArithmetic<128>();
+
+    BenchmarkEnsemble(64, 10000);
+    BenchmarkEnsemble(4096, 1000);
+
+    BenchmarkMultistep("circle", &RhsCircle);
+    BenchmarkMultistep("vanderpol", &RhsVanderPol);
+
+    // RK4 with 10^5 and 10^7 steps, unless the number of steps is limited
+    const int64_t precision_steps = std::min<int64_t>(10000000, max_steps);
+    BenchmarkPrecision("circle", CircleRhs(), &BatchRhsCircleT<double>, &BatchRhsCircleT<float>, precision_steps, 4096, 1000);
+    BenchmarkPrecision("vanderpol", PrecisionVanderPolRhs(), &BatchRhsVanderPolT<double>, &BatchRhsVanderPolT<float>,
+                       precision_steps, 4096, 1000);
+
+    // Method-of-lines systems from cache-sized to well beyond the last-level cache
+    for (std::size_t size=100000; size<=10000000; size*=10)
+    {
+        BenchmarkLargeSystem(size, std::max(5, (int) (20000000/size)));
+    }
+
+    // 10^6 circuits of the circle, unless the number of steps is limited
+    const int64_t circuits = std::min<int64_t>(1000000, max_steps/100);
+    for (int steps_per_circuit=8; steps_per_circuit<=64; steps_per_circuit*=2)
+    {
+        BenchmarkEnergyDrift<RK4Solver>("RungeKutta4", steps_per_circuit, circuits);
+        BenchmarkEnergyDrift<StormerVerletOdeSolver>("StormerVerlet", steps_per_circuit, circuits);
+        BenchmarkEnergyDrift<Yoshida4OdeSolver>("Yoshida4", steps_per_circuit, circuits);
+    }
+
+    // Van der Pol as in the tests, and stiff, starting on the slow manifold and stopping before the first jump
+    BenchmarkStiffVanderPol(7.0, Pair(1.0, 0.0), 10.0, 1e-4);
+    BenchmarkStiffVanderPol(1000.0, Pair(2.0, -2.0/3.0), 700.0, 1e-4);
+
+    std::cout << "{\"compiler\": \"" << __VERSION__ << "\",\n \"benchmarks\": [\n";
+    for (unsigned i=0; i<gRecords.size(); i++)
+    {
+        std::cout << "  " << gRecords[i].GetText() << (i + 1 < gRecords.size() ? ",\n" : "\n");
+    }
+    std::cout << "]}\n";
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * Checkpoint.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Exception.hpp"
+#include "Checkpoint.hpp"
+
+static_assert(sizeof(CheckpointHeader) == 96, "Checkpoint header should be 96 bytes");
+
+CheckpointHeader MakeCheckpointHeader(unsigned dimension, const std::string& solverName, double startTime,
+                                      double timeStepSize, int64_t numberOfTimeSteps, int64_t stepIndex, double time,
+                                      unsigned numberOfObservers)
+{
+    const uint32_t one = 1;
+    if (*reinterpret_cast<const unsigned char*>(&one) != 1)
+    {
+        throw Exception("OdeSolve", "Checkpoints can only be written on little-endian machines");
+    }
+
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "ODECHKPT", 8);
+    header.version = CHECKPOINT_VERSION;
+    header.dimension = dimension;
+    std::strncpy(header.solverName, solverName.c_str(), sizeof(header.solverName) - 1);
+    header.startTime = startTime;
+    header.timeStepSize = timeStepSize;
+    header.numberOfTimeSteps = numberOfTimeSteps;
+    header.stepIndex = stepIndex;
+    header.time = time;
+    header.numberOfObservers = numberOfObservers;
+    return header;
+}
+
+/** Writes all of the bytes, carrying on after partial writes.  Returns false on failure */
+static bool WriteAll(int file, const void* pData, std::size_t size)
+{
+    const char* p_data = static_cast<const char*>(pData);
+    while (size > 0)
+    {
+        ssize_t written = write(file, p_data, size);
+        if (written <= 0)
+        {
+            return false;
+        }
+        p_data += written;
+        size -= written;
+    }
+    return true;
+}
+
+void WriteCheckpointFile(const std::string& fileName, const CheckpointHeader& rHeader, const double* pValues,
+                         const uint64_t* pObserverPositions)
+{
+    const std::string temporary_name = fileName + ".tmp";
+    int file = open(temporary_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file < 0)
+    {
+        throw Exception("OdeSolve", "Can't open checkpoint file");
+    }
+    bool written = WriteAll(file, &rHeader, sizeof(rHeader))
+            && WriteAll(file, pValues, rHeader.dimension*sizeof(double))
+            && WriteAll(file, pObserverPositions, rHeader.numberOfObservers*sizeof(uint64_t))
+            && fsync(file) == 0;
+    written = (close(file) == 0) && written;
+    if (!written || std::rename(temporary_name.c_str(), fileName.c_str()) != 0)
+    {
+        std::remove(temporary_name.c_str());
+        throw Exception("OdeSolve", "Failed writing checkpoint file");
+    }
+}
+
+void ReadCheckpointFile(const std::string& fileName, CheckpointHeader& rHeader, std::vector<double>& rValues,
+                        std::vector<uint64_t>& rObserverPositions)
+{
+    std::FILE* p_file = std::fopen(fileName.c_str(), "rb");
+    if (p_file == NULL)
+    {
+        throw Exception("OdeLoad", "Can't open checkpoint file");
+    }
+    bool valid = std::fread(&rHeader, sizeof(rHeader), 1, p_file) == 1
+            && std::memcmp(rHeader.magic, "ODECHKPT", 8) == 0
+            && rHeader.version == CHECKPOINT_VERSION;
+    if (valid)
+    {
+        rHeader.solverName[sizeof(rHeader.solverName) - 1] = '\0';
+        rValues.resize(rHeader.dimension);
+        rObserverPositions.resize(rHeader.numberOfObservers);
+        valid = std::fread(rValues.data(), sizeof(double), rValues.size(), p_file) == rValues.size()
+                && std::fread(rObserverPositions.data(), sizeof(uint64_t), rObserverPositions.size(), p_file)
+                        == rObserverPositions.size()
+                && std::fgetc(p_file) == EOF;
+    }
+    std::fclose(p_file);
+    if (!valid)
+    {
+        throw Exception("OdeLoad", "Not a checkpoint file (or it is truncated)");
+    }
+}
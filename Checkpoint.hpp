@@ -0,0 +1,58 @@
+/*
+ * Checkpoint.hpp
+ *
+ * Checkpoint files: the state of a solve part way through, written by the solvers every so many
+ * steps (see AbstractOdeSolverT::SetCheckpointing()) so that a long run can be resumed
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef CHECKPOINT_HPP_
+#define CHECKPOINT_HPP_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * The file starts with this 96 byte header.  All numbers are little-endian.  It is followed by the
+ * dimension values of the state, as doubles, and then one uint64 for each observer (where it had
+ * got to, e.g. the length of a streamed trace file).
+ */
+struct CheckpointHeader
+{
+    char magic[8];               ///< "ODECHKPT"
+    uint32_t version;            ///< Format version (1)
+    uint32_t dimension;          ///< Number of components in the state
+    char solverName[32];         ///< Name of the solver that wrote the checkpoint (null-terminated)
+    double startTime;            ///< The solve's time set-up
+    double timeStepSize;
+    int64_t numberOfTimeSteps;
+    int64_t stepIndex;           ///< Number of steps taken when the checkpoint was written
+    double time;                 ///< Time reached
+    uint32_t numberOfObservers;  ///< Number of observer positions after the state
+    uint32_t reserved;           ///< Zero
+};
+
+/** Version of the format written by this code */
+const uint32_t CHECKPOINT_VERSION = 1;
+
+/** Fills in a header, checking that the host is little-endian so that the data can be written directly */
+CheckpointHeader MakeCheckpointHeader(unsigned dimension, const std::string& solverName, double startTime,
+                                      double timeStepSize, int64_t numberOfTimeSteps, int64_t stepIndex, double time,
+                                      unsigned numberOfObservers);
+
+/**
+ * Writes a checkpoint atomically: to fileName.tmp first, which is synced to disk and then renamed
+ * over fileName.  A crash part way through leaves the previous checkpoint as it was.  Throws if
+ * anything fails.
+ */
+void WriteCheckpointFile(const std::string& fileName, const CheckpointHeader& rHeader, const double* pValues,
+                         const uint64_t* pObserverPositions);
+
+/** Reads a checkpoint file.  Throws if it can't be read or isn't a checkpoint */
+void ReadCheckpointFile(const std::string& fileName, CheckpointHeader& rHeader, std::vector<double>& rValues,
+                        std::vector<uint64_t>& rObserverPositions);
+
+#endif /* CHECKPOINT_HPP_ */
@@ -0,0 +1,359 @@
+/*
+ * ConvergenceStudy.hpp
+ *
+ * Measures how a solver's error falls as the time-step is refined (the errors_*.txt tables)
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef CONVERGENCESTUDY_HPP_
+#define CONVERGENCESTUDY_HPP_
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "AbstractOdeSolver.hpp"
+#include "TextTraceWriter.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * Accumulates the error against a reference solution as the solve goes, so that no trace is needed.
+ * The reference is given the index of the time-point (0 for the initial values) and its time.
+ */
+template<class STATE>
+class ErrorNormObserverT: public AbstractOdeObserverT<STATE>
+{
+private:
+    std::function<STATE(int64_t, double)> mReference;
+    int64_t mNumberOfObservations;
+    double mSumSquareError;
+    double mMaxError;
+    STATE mFinalValues;
+    STATE mFinalReference;
+
+public:
+    ErrorNormObserverT(const std::function<STATE(int64_t, double)>& rReference)
+        : mReference(rReference),
+          mNumberOfObservations(0),
+          mSumSquareError(0.0),
+          mMaxError(0.0)
+    {}
+
+    void BeginSolve()
+    {
+        mNumberOfObservations = 0;
+        mSumSquareError = 0.0;
+        mMaxError = 0.0;
+    }
+
+    void ObserveStep(double t, const STATE& rValues)
+    {
+        mFinalReference = mReference(mNumberOfObservations, t);
+        mFinalValues = rValues;
+        for (int j=0; j<STATE::DIMENSION; j++)
+        {
+            const double error = rValues[j] - mFinalReference[j];
+            mSumSquareError += error*error;
+            mMaxError = std::max(mMaxError, std::fabs(error));
+        }
+        mNumberOfObservations++;
+    }
+
+    /** Root of the summed (over components) square error, averaged over the time-points */
+    double GetL2Error() const
+    {
+        CheckObservations();
+        return std::sqrt(mSumSquareError/mNumberOfObservations);
+    }
+
+    /** Largest error in any component at any time-point */
+    double GetMaxError() const
+    {
+        CheckObservations();
+        return mMaxError;
+    }
+
+    const STATE& GetFinalValues() const
+    {
+        CheckObservations();
+        return mFinalValues;
+    }
+
+    /** The reference solution at the final time-point */
+    const STATE& GetFinalReference() const
+    {
+        CheckObservations();
+        return mFinalReference;
+    }
+
+private:
+    void CheckObservations() const
+    {
+        if (mNumberOfObservations == 0)
+        {
+            throw Exception("OdePost", "No solution has been observed");
+        }
+    }
+};
+
+/** One row of a convergence study */
+struct ConvergenceResult
+{
+    int64_t numberOfSteps;
+    double stepSize;
+    double l2Error;
+    double maxError;
+    /** Order implied by this row's L2 error and the previous row's (NaN for the first row) */
+    double observedOrder;
+    /**
+     * Largest component error of the final values after Richardson extrapolation with the
+     * previous row (NaN for the first row, or when there's no positive order to extrapolate with)
+     */
+    double richardsonError;
+};
+
+/**
+ * Solves one problem with a list of step sizes, in parallel, and reports the error for each one.
+ * The error is measured against either an analytic solution or a high-resolution run of the same
+ * solver, and accumulated while solving, so no traces are stored.
+ *
+ * For each refinement the observed order is log(e_coarse/e_fine)/log(h_coarse/h_fine).  The final
+ * values of each consecutive pair are Richardson-extrapolated,
+ *     v_fine + (v_fine - v_coarse)/(r^p - 1),  r = h_coarse/h_fine,
+ * with p the solver's formal order if SetOrder() was called and the observed order otherwise.
+ */
+template<class SOLVER>
+class ConvergenceStudy
+{
+public:
+    typedef typename SOLVER::StateType STATE;
+
+private:
+    STATE mInitialValues;
+    double mStartTime;
+    double mEndTime;
+    std::vector<double> mStepSizes;
+
+    std::function<STATE(double)> mAnalyticSolution;
+    /** Number of steps for the reference run (zero if the reference is analytic) */
+    int64_t mReferenceNumberOfSteps;
+
+    /** Formal order of the solver (zero for unknown) */
+    double mOrder;
+    unsigned mNumberOfThreads;
+
+    std::vector<ConvergenceResult> mResults;
+
+public:
+    ConvergenceStudy()
+        : mStartTime(0.0),
+          mEndTime(0.0),
+          mReferenceNumberOfSteps(0),
+          mOrder(0.0),
+          mNumberOfThreads(0)
+    {}
+
+    void SetInitialValues(const STATE& rInitialValues)
+    {
+        mInitialValues = rInitialValues;
+    }
+
+    void SetInitialAndFinalTime(double startTime, double endTime)
+    {
+        if (startTime == endTime)
+        {
+            throw Exception("OdeSetup", "The start and end times are the same");
+        }
+        mStartTime = startTime;
+        mEndTime = endTime;
+    }
+
+    /** Each step size is rounded so that a whole number of steps fits the time interval */
+    void SetStepSizes(const std::vector<double>& rStepSizes)
+    {
+        mStepSizes = rStepSizes;
+    }
+
+    /** Measure errors against a known solution */
+    void SetAnalyticSolution(const std::function<STATE(double)>& rSolution)
+    {
+        mAnalyticSolution = rSolution;
+        mReferenceNumberOfSteps = 0;
+    }
+
+    /**
+     * Measure errors against a run of the same solver with this many steps.  Every refinement must
+     * have a number of steps which divides it, so that its time-points are all in the reference run.
+     */
+    void SetReferenceRun(int64_t numberOfSteps)
+    {
+        if (numberOfSteps <= 0)
+        {
+            throw Exception("OdeSetup", "Number of time steps should be positive");
+        }
+        mReferenceNumberOfSteps = numberOfSteps;
+        mAnalyticSolution = nullptr;
+    }
+
+    /** The solver's formal order, used for Richardson extrapolation (by default the observed order is used) */
+    void SetOrder(double order)
+    {
+        mOrder = order;
+    }
+
+    /** Zero (the default) means one thread per core */
+    void SetNumberOfThreads(unsigned numberOfThreads)
+    {
+        mNumberOfThreads = numberOfThreads;
+    }
+
+    /** Runs every refinement of rhs(v, t, dvdt), which may be called from several threads at once */
+    template<class RHS>
+    void Run(const RHS& rRhs);
+
+    /** One result per step size, in the order given */
+    const std::vector<ConvergenceResult>& GetResults() const
+    {
+        return mResults;
+    }
+
+    /**
+     * Writes a table with a row per step size:
+     * step-size    L2-error    observed-order    Richardson-error
+     * (the first two columns are the format of the old errors_*.txt files)
+     */
+    void WriteErrorTable(const std::string& fileName) const;
+
+private:
+    int64_t NumberOfStepsFor(double stepSize) const
+    {
+        const double steps = std::round(std::fabs(mEndTime - mStartTime)/stepSize);
+        return steps < 1.0 ? 1 : (int64_t) steps;
+    }
+};
+
+template<class SOLVER>
+template<class RHS>
+void ConvergenceStudy<SOLVER>::Run(const RHS& rRhs)
+{
+    if (mStepSizes.empty())
+    {
+        throw Exception("OdeSetup", "There are no step sizes to study");
+    }
+    if (mStartTime == mEndTime)
+    {
+        throw Exception("OdeSetup", "Please set the time interval");
+    }
+    if (!mAnalyticSolution && mReferenceNumberOfSteps == 0)
+    {
+        throw Exception("OdeSetup", "Please set a reference solution");
+    }
+    std::vector<int64_t> steps(mStepSizes.size());
+    for (unsigned i=0; i<steps.size(); i++)
+    {
+        if (!(mStepSizes[i] > 0.0))
+        {
+            throw Exception("OdeSetup", "Step sizes should be positive");
+        }
+        steps[i] = NumberOfStepsFor(mStepSizes[i]);
+        if (mReferenceNumberOfSteps > 0 && mReferenceNumberOfSteps % steps[i] != 0)
+        {
+            throw Exception("OdeSetup", "Every number of steps should divide the reference run's");
+        }
+    }
+
+    // The high-resolution reference has to be stored, but only the solution at each time-point
+    std::vector<STATE> reference;
+    if (mReferenceNumberOfSteps > 0)
+    {
+        SOLVER solver;
+        solver.SetInitialValues(mInitialValues);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(mStartTime, mReferenceNumberOfSteps, mEndTime);
+        solver.Solve(rRhs);
+        reference = solver.TakeTrace().solution;
+    }
+
+    std::vector<ConvergenceResult> results(steps.size());
+    std::vector<STATE> final_values(steps.size());
+    std::vector<STATE> final_references(steps.size());
+    WorkStealingThreadPool pool(mNumberOfThreads);
+    pool.ParallelFor(steps.size(), [&](std::size_t i)
+    {
+        std::function<STATE(int64_t, double)> reference_at;
+        if (mReferenceNumberOfSteps > 0)
+        {
+            const int64_t stride = mReferenceNumberOfSteps/steps[i];
+            reference_at = [&reference, stride](int64_t index, double t) { return reference[index*stride]; };
+        }
+        else
+        {
+            reference_at = [this](int64_t index, double t) { return mAnalyticSolution(t); };
+        }
+        ErrorNormObserverT<STATE> errors(reference_at);
+
+        SOLVER solver;
+        solver.SetInitialValues(mInitialValues);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(mStartTime, steps[i], mEndTime);
+        solver.SetStoreTrace(false);
+        solver.AddObserver(&errors);
+        solver.Solve(rRhs);
+
+        results[i].numberOfSteps = steps[i];
+        results[i].stepSize = std::fabs(mEndTime - mStartTime)/steps[i];
+        results[i].l2Error = errors.GetL2Error();
+        results[i].maxError = errors.GetMaxError();
+        final_values[i] = errors.GetFinalValues();
+        final_references[i] = errors.GetFinalReference();
+    });
+
+    // Orders and extrapolation compare each refinement with the one before
+    const double not_a_number = std::numeric_limits<double>::quiet_NaN();
+    for (unsigned i=0; i<results.size(); i++)
+    {
+        results[i].observedOrder = not_a_number;
+        results[i].richardsonError = not_a_number;
+        if (i == 0 || steps[i] == steps[i-1])
+        {
+            continue;
+        }
+        const double ratio = results[i-1].stepSize/results[i].stepSize;
+        results[i].observedOrder = std::log(results[i-1].l2Error/results[i].l2Error)/std::log(ratio);
+
+        const double order = (mOrder > 0.0) ? mOrder : results[i].observedOrder;
+        if (order > 0.0)
+        {
+            const double factor = 1.0/(std::pow(ratio, order) - 1.0);
+            double error = 0.0;
+            for (int j=0; j<STATE::DIMENSION; j++)
+            {
+                const double extrapolated = final_values[i][j] + (final_values[i][j] - final_values[i-1][j])*factor;
+                error = std::max(error, std::fabs(extrapolated - final_references[i][j]));
+            }
+            results[i].richardsonError = error;
+        }
+    }
+    mResults.swap(results);
+}
+
+template<class SOLVER>
+void ConvergenceStudy<SOLVER>::WriteErrorTable(const std::string& fileName) const
+{
+    if (mResults.empty())
+    {
+        throw Exception("OdePost", "There are no results to write");
+    }
+    TextTraceWriter write_output(fileName, 4);
+    for (unsigned i=0; i<mResults.size(); i++)
+    {
+        const double row[4] = {mResults[i].stepSize, mResults[i].l2Error,
+                               mResults[i].observedOrder, mResults[i].richardsonError};
+        write_output.WriteRow(row);
+    }
+    write_output.Close();
+}
+
+#endif /* CONVERGENCESTUDY_HPP_ */
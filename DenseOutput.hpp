@@ -0,0 +1,203 @@
+/*
+ * DenseOutput.hpp
+ *
+ * Continuous (dense) output: an interpolating polynomial over every step of a solve, so that the
+ * solution can be evaluated at any time without taking small steps
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef DENSEOUTPUT_HPP_
+#define DENSEOUTPUT_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+#include "Exception.hpp"
+
+/**
+ * The interpolants for the steps of one solve.  Over the step from t0 to t0 + h, with
+ * theta = (t - t0)/h in [0, 1], the solution is
+ *     y(theta) = c0 + theta*(c1 + (1-theta)*(c2 + theta*(c3 + (1-theta)*c4)))
+ * (the form used by Hairer and Wanner's DOPRI5).  With four coefficients (no c4) this is the cubic
+ * Hermite interpolant through the values and derivatives at both ends of the step, which any
+ * one-step method can supply.  Dormand-Prince adds c4 for its own 4th order continuous extension.
+ */
+template<class STATE>
+class DenseOutputT
+{
+private:
+    /** Start time of each step, followed by the end time of the last step */
+    std::vector<double> mTimes;
+    /** Coefficients c0, c1, ... for each step in turn */
+    std::vector<STATE> mCoefficients;
+    /** Number of coefficients stored for each step (4 or 5) */
+    int mCoefficientsPerStep;
+    /** End of the interval covered, which is inside the last step if the solve stopped part way through it */
+    double mEndTime;
+
+    /** Index of the step containing time t (which must be in the solved interval) */
+    std::size_t FindStep(double t) const
+    {
+        std::vector<double>::const_iterator it;
+        if (mTimes.back() > mTimes.front())
+        {
+            it = std::upper_bound(mTimes.begin(), mTimes.end(), t);
+        }
+        else
+        {
+            it = std::upper_bound(mTimes.begin(), mTimes.end(), t, std::greater<double>());
+        }
+        std::size_t step = (it == mTimes.begin()) ? 0 : std::size_t(it - mTimes.begin()) - 1;
+        return std::min(step, GetNumberOfSteps() - 1);
+    }
+
+    /** The interpolant of one step at time t */
+    STATE EvaluateInStep(double t, std::size_t step) const
+    {
+        const double theta = (t - mTimes[step])/(mTimes[step + 1] - mTimes[step]);
+        return EvaluateInterpolant(&mCoefficients[step*mCoefficientsPerStep], mCoefficientsPerStep, theta);
+    }
+
+    /** Whether time t is in the step (allowing for rounding at the ends of the interval) */
+    bool IsInStep(double t, std::size_t step) const
+    {
+        double theta = (t - mTimes[step])/(mTimes[step + 1] - mTimes[step]);
+        return theta >= 0.0 && theta <= 1.0;
+    }
+
+public:
+    DenseOutputT() : mCoefficientsPerStep(4), mEndTime(0.0) {}
+
+    /** One step's interpolant, from its numberOfCoefficients (4 or 5) coefficients, at theta in [0, 1] */
+    static STATE EvaluateInterpolant(const STATE* pCoefficients, int numberOfCoefficients, double theta)
+    {
+        const STATE* c = pCoefficients;
+        STATE inner = c[3];
+        if (numberOfCoefficients == 5)
+        {
+            inner += c[4]*(1.0 - theta);
+        }
+        return c[0] + (c[1] + (c[2] + inner*theta)*(1.0 - theta))*theta;
+    }
+
+    /**
+     * The four coefficients of the cubic Hermite interpolant over a step of size h from the values
+     * and derivatives at its ends
+     */
+    static void MakeHermiteInterpolant(double h, const STATE& rStart, const STATE& rStartDerivative,
+                                       const STATE& rEnd, const STATE& rEndDerivative, STATE* pCoefficients)
+    {
+        pCoefficients[0] = rStart;
+        pCoefficients[1] = rEnd - rStart;
+        pCoefficients[2] = rStartDerivative*h - pCoefficients[1];
+        pCoefficients[3] = pCoefficients[1] - rEndDerivative*h - pCoefficients[2];
+    }
+
+    /** Forget the last solve, and give back its memory if releaseMemory is set */
+    void Clear(bool releaseMemory)
+    {
+        mTimes.clear();
+        mCoefficients.clear();
+        if (releaseMemory)
+        {
+            std::vector<double>().swap(mTimes);
+            std::vector<STATE>().swap(mCoefficients);
+        }
+    }
+
+    /**
+     * Start a solve at startTime, with coefficientsPerStep (4 or 5) coefficients for each step and
+     * room for expectedSteps steps (just a first guess for the adaptive solvers)
+     */
+    void Begin(double startTime, int coefficientsPerStep, std::size_t expectedSteps)
+    {
+        Clear(false);
+        mCoefficientsPerStep = coefficientsPerStep;
+        mTimes.reserve(expectedSteps + 1);
+        mCoefficients.reserve(expectedSteps*coefficientsPerStep);
+        mTimes.push_back(startTime);
+        mEndTime = startTime;
+    }
+
+    /** Add the interpolant of the step to endTime from its coefficients (coefficientsPerStep of them) */
+    void AddStep(double endTime, const STATE* pCoefficients)
+    {
+        mCoefficients.insert(mCoefficients.end(), pCoefficients, pCoefficients + mCoefficientsPerStep);
+        mTimes.push_back(endTime);
+        mEndTime = endTime;
+    }
+
+    /** Stop the covered interval at endTime, part way through the last step (when a solve stops at an event) */
+    void Truncate(double endTime)
+    {
+        mEndTime = endTime;
+    }
+
+    /** Number of steps stored */
+    std::size_t GetNumberOfSteps() const
+    {
+        return mTimes.empty() ? 0 : mTimes.size() - 1;
+    }
+
+    /** Memory currently held */
+    std::size_t GetCapacityBytes() const
+    {
+        return mTimes.capacity()*sizeof(double) + mCoefficients.capacity()*sizeof(STATE);
+    }
+
+    /** The solution at time t.  Throws if t is outside the solved interval */
+    STATE Evaluate(double t) const
+    {
+        CheckTime(t);
+        return EvaluateInStep(t, FindStep(t));
+    }
+
+    /**
+     * The solution at each of the times.  Sorted times (in the direction of the solve) are found
+     * by walking along the steps rather than searching for each one.
+     */
+    std::vector<STATE> Evaluate(const std::vector<double>& rTimes) const
+    {
+        std::vector<STATE> values;
+        values.reserve(rTimes.size());
+        std::size_t step = 0;
+        for (std::size_t i=0; i<rTimes.size(); i++)
+        {
+            const double t = rTimes[i];
+            CheckTime(t);
+            if (!IsInStep(t, step))
+            {
+                if (step + 1 < GetNumberOfSteps() && IsInStep(t, step + 1))
+                {
+                    step++;
+                }
+                else
+                {
+                    step = FindStep(t);
+                }
+            }
+            values.push_back(EvaluateInStep(t, step));
+        }
+        return values;
+    }
+
+    /** Throws unless there is dense output covering time t */
+    void CheckTime(double t) const
+    {
+        if (GetNumberOfSteps() == 0)
+        {
+            throw Exception("OdePost", "There is no dense output.  Please use SetDenseOutput(true) and run the Solve() method");
+        }
+        const double start = mTimes.front(), end = mEndTime;
+        const double tolerance = 1e-12*std::max(std::max(fabs(start), fabs(end)), fabs(end - start));
+        if (std::min(start, end) - t > tolerance || t - std::max(start, end) > tolerance)
+        {
+            throw Exception("OdePost", "The time is outside the solved interval");
+        }
+    }
+};
+
+#endif /* DENSEOUTPUT_HPP_ */
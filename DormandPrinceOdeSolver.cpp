@@ -0,0 +1,13 @@
+/*
+ * DormandPrinceOdeSolver.cpp
+ *
+ * Implements the adaptive Dormand-Prince 5(4) embedded Runge-Kutta solver
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include "DormandPrinceOdeSolver.hpp"
+
+// The methods are templates defined in the header.  The 2-D (Pair) version is compiled here once.
+template class DormandPrinceOdeSolverT<Pair>;
@@ -0,0 +1,251 @@
+/*
+ * DormandPrinceOdeSolver.hpp
+ *
+ * Implements the adaptive Dormand-Prince 5(4) embedded Runge-Kutta solver
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef DORMANDPRINCEODESOLVER_HPP_
+#define DORMANDPRINCEODESOLVER_HPP_
+
+#include <algorithm>
+#include "AbstractOdeSolver.hpp"
+
+/**
+ * Adaptive step solver.  The time set-up methods give the start and end times as usual, but the
+ * time-step there is only the first step tried: after that the step size is chosen so that the
+ * estimated local error stays within the tolerances.  The time trace is therefore non-uniform.
+ *
+ *  * 5th order solution with an embedded 4th order error estimate
+ *  * First-same-as-last: the last stage of an accepted step is the first stage of the next,
+ *    so each step costs 6 right-hand side evaluations
+ *  * PI step-size controller
+ */
+template<class STATE>
+class DormandPrinceOdeSolverT: public AbstractOdeSolverT<STATE> {
+private:
+	/** Tolerance on the absolute error in each component */
+	double mAbsoluteTolerance;
+	/** Tolerance on the error in each component relative to its size */
+	double mRelativeTolerance;
+
+	/** Number of steps kept in the trace (in the last solve) */
+	int64_t mNumberOfAcceptedSteps;
+	/** Number of steps thrown away because the error was too big (in the last solve) */
+	int64_t mNumberOfRejectedSteps;
+
+	/** Scaled RMS norm of the error estimate: the step is accepted if this is at most one */
+	double ErrorNorm(const STATE& rError, const STATE& rOld, const STATE& rNew) const;
+
+public:
+	DormandPrinceOdeSolverT();
+	virtual ~DormandPrinceOdeSolverT();
+
+	std::string GetSolverName() const {
+		return "DormandPrince54";
+	}
+
+	/** Set the error tolerances.  Throws unless both are non-negative and one is positive */
+	void SetTolerances(double absoluteTolerance, double relativeTolerance);
+
+	/** Number of accepted steps in the last solve (the trace has one more entry than this) */
+	int64_t GetNumberOfAcceptedSteps() const;
+
+	/** Number of rejected (and retried) steps in the last solve */
+	int64_t GetNumberOfRejectedSteps() const;
+
+	/** Solve with the function pointer set by SetRhsFunction() */
+	void Solve();
+
+	/** Solve with any callable right-hand side rhs(v, t, dvdt) */
+	template<class RHS>
+	void Solve(RHS rhs);
+};
+
+template<class STATE>
+DormandPrinceOdeSolverT<STATE>::DormandPrinceOdeSolverT() {
+	mAbsoluteTolerance = 1e-6;
+	mRelativeTolerance = 1e-6;
+	mNumberOfAcceptedSteps = 0;
+	mNumberOfRejectedSteps = 0;
+}
+
+template<class STATE>
+DormandPrinceOdeSolverT<STATE>::~DormandPrinceOdeSolverT() {
+}
+
+template<class STATE>
+void DormandPrinceOdeSolverT<STATE>::SetTolerances(double absoluteTolerance, double relativeTolerance) {
+	if (absoluteTolerance < 0.0 || relativeTolerance < 0.0 || absoluteTolerance + relativeTolerance <= 0.0) {
+		throw Exception("OdeSetup", "Tolerances should be non-negative and not both zero");
+	}
+	mAbsoluteTolerance = absoluteTolerance;
+	mRelativeTolerance = relativeTolerance;
+}
+
+template<class STATE>
+int64_t DormandPrinceOdeSolverT<STATE>::GetNumberOfAcceptedSteps() const {
+	return mNumberOfAcceptedSteps;
+}
+
+template<class STATE>
+int64_t DormandPrinceOdeSolverT<STATE>::GetNumberOfRejectedSteps() const {
+	return mNumberOfRejectedSteps;
+}
+
+template<class STATE>
+double DormandPrinceOdeSolverT<STATE>::ErrorNorm(const STATE& rError, const STATE& rOld, const STATE& rNew) const {
+	double sum = 0.0;
+	for (int i = 0; i < STATE::DIMENSION; i++) {
+		double scale = mAbsoluteTolerance + mRelativeTolerance*std::max(fabs(rOld[i]), fabs(rNew[i]));
+		sum += (rError[i]/scale)*(rError[i]/scale);
+	}
+	return sqrt(sum/STATE::DIMENSION);
+}
+
+template<class STATE>
+void DormandPrinceOdeSolverT<STATE>::Solve() {
+	if (this->mpRhsFunction == NULL) {
+		throw Exception("OdeSolve", "Please define the right hand side function");
+	}
+	Solve(this->mpRhsFunction);
+}
+
+template<class STATE>
+template<class RHS>
+void DormandPrinceOdeSolverT<STATE>::Solve(RHS uncountedRhs) {
+	// Defensive programming to prevent bad inputs
+	if (this->mNumberOfTimeSteps < 0) {
+		throw Exception("OdeSolve", "The time interval has not been set");
+	}
+
+	// Butcher tableau: nodes, stage coefficients and (5th order solution - 4th order solution) weights
+	const double c2 = 1.0/5.0, c3 = 3.0/10.0, c4 = 4.0/5.0, c5 = 8.0/9.0;
+	const double a21 = 1.0/5.0;
+	const double a31 = 3.0/40.0, a32 = 9.0/40.0;
+	const double a41 = 44.0/45.0, a42 = -56.0/15.0, a43 = 32.0/9.0;
+	const double a51 = 19372.0/6561.0, a52 = -25360.0/2187.0, a53 = 64448.0/6561.0, a54 = -212.0/729.0;
+	const double a61 = 9017.0/3168.0, a62 = -355.0/33.0, a63 = 46732.0/5247.0, a64 = 49.0/176.0, a65 = -5103.0/18656.0;
+	const double b1 = 35.0/384.0, b3 = 500.0/1113.0, b4 = 125.0/192.0, b5 = -2187.0/6784.0, b6 = 11.0/84.0;
+	const double e1 = 71.0/57600.0, e3 = -71.0/16695.0, e4 = 71.0/1920.0, e5 = -17253.0/339200.0,
+	             e6 = 22.0/525.0, e7 = -1.0/40.0;
+	// Continuous extension (Hairer, Norsett & Wanner's DOPRI5)
+	const double d1 = -12715105075.0/11282082432.0, d3 = 87487479700.0/32700410799.0,
+	             d4 = -10690763975.0/1880347072.0, d5 = 701980252875.0/199316789632.0,
+	             d6 = -1453857185.0/822651844.0, d7 = 69997945.0/29380423.0;
+
+	// PI controller constants (Hairer, Norsett & Wanner)
+	const double safety = 0.9, beta = 0.04, alpha = 0.2 - 0.75*beta;
+	const double min_factor = 0.2, max_factor = 10.0;
+
+	// The time is accumulated in the state's time precision
+	typedef typename STATE::TimeType TIME;
+	const double end_time = this->GetStepTime(this->mNumberOfTimeSteps);
+	const double direction = (this->mTimeStepSize > 0.0) ? 1.0 : -1.0;
+	double h = this->mTimeStepSize;
+	double t = this->mStartTime;
+	double previous_error = 1e-4;
+	bool last_step_rejected = false;
+
+	STATE v = this->mInitialValues;
+	STATE v_new, error, k1, k2, k3, k4, k5, k6, k7;
+	STATE interpolant[5], event_values;
+	double event_time;
+	const bool need_interpolant = this->mDenseOutput || !this->mEventFunctions.empty();
+
+	mNumberOfAcceptedSteps = 0;
+	mNumberOfRejectedSteps = 0;
+	// Count the right-hand side evaluations (unless the stats are compiled out)
+	auto&& rhs = CountRhsEvaluations(uncountedRhs, this->mStats);
+
+	// Start the trace with the initial values and start times.  The number of steps depends on the
+	// tolerances, not on the first trial step, so the trace grows as the steps are accepted
+	this->BeginRecording(t, v, false, false);
+	if (this->mDenseOutput) {
+		// Likewise the interpolants are added as they come
+		this->mDenseOutputData.Begin(t, 5, 0);
+	}
+	rhs(v, t, k1);
+	while (direction*(end_time - t) > 0.0) {
+		// Don't step past the end time, and stretch a step that would stop just short of it, since
+		// the rounding in t would otherwise leave a sliver of a last step
+		bool last_step = false;
+		if (direction*(t + 1.01*h - end_time) >= 0.0) {
+			h = end_time - t;
+			last_step = true;
+		}
+		if (!last_step && (fabs(h) <= 1e-14*std::max(fabs(t), 1.0) || TIME(t) + TIME(h) == TIME(t))) {
+			throw Exception("OdeSolve", "Step size underflow: the tolerances can't be met");
+		}
+
+		// Run the DE
+		rhs(STATE(v + k1*(h*a21)), t + c2*h, k2);
+		rhs(STATE(v + (k1*a31 + k2*a32)*h), t + c3*h, k3);
+		rhs(STATE(v + (k1*a41 + k2*a42 + k3*a43)*h), t + c4*h, k4);
+		rhs(STATE(v + (k1*a51 + k2*a52 + k3*a53 + k4*a54)*h), t + c5*h, k5);
+		rhs(STATE(v + (k1*a61 + k2*a62 + k3*a63 + k4*a64 + k5*a65)*h), t + h, k6);
+		v_new = v + (k1*b1 + k3*b3 + k4*b4 + k5*b5 + k6*b6)*h;
+		rhs(v_new, t + h, k7);
+
+		// Local error estimate
+		error = (k1*e1 + k3*e3 + k4*e4 + k5*e5 + k6*e6 + k7*e7)*h;
+		double error_norm = ErrorNorm(error, v, v_new);
+
+		if (error_norm <= 1.0) {
+			// Accept: keep the interpolant over the step, then progress over the current timestep
+			double new_t = last_step ? end_time : TIME(t) + TIME(h);
+			if (need_interpolant) {
+				interpolant[0] = v;
+				interpolant[1] = v_new - v;
+				interpolant[2] = k1*h - interpolant[1];
+				interpolant[3] = interpolant[1] - k7*h - interpolant[2];
+				interpolant[4] = (k1*d1 + k3*d3 + k4*d4 + k5*d5 + k6*d6 + k7*d7)*h;
+			}
+			if (this->mDenseOutput) {
+				this->mDenseOutputData.AddStep(new_t, interpolant);
+			}
+			mNumberOfAcceptedSteps++;
+			if (!this->mEventFunctions.empty()
+			    && this->LocateEvents(t, new_t, interpolant, 5, v_new, event_time, event_values)) {
+				// Stopped by an event: the solution finishes there
+				this->mDenseOutputData.Truncate(event_time);
+				this->RecordStep(event_time, event_values);
+				break;
+			}
+			t = new_t;
+			v = v_new;
+			k1 = k7; // First same as last
+
+			// Append the results to the traces
+			this->RecordStep(t, v);
+
+			double factor = max_factor;
+			if (error_norm > 0.0) {
+				factor = safety*pow(error_norm, -alpha)*pow(previous_error, beta);
+				factor = std::min(max_factor, std::max(min_factor, factor));
+			}
+			if (last_step_rejected) {
+				factor = std::min(factor, 1.0);
+			}
+			h *= factor;
+			previous_error = std::max(error_norm, 1e-4);
+			last_step_rejected = false;
+		}
+		else {
+			// Reject and retry with a smaller step
+			mNumberOfRejectedSteps++;
+			h *= std::max(min_factor, safety*pow(error_norm, -alpha));
+			last_step_rejected = true;
+		}
+	}
+	this->EndRecording();
+}
+
+/** The 2-D solver */
+typedef DormandPrinceOdeSolverT<Pair> DormandPrinceOdeSolver;
+// Compiled once in DormandPrinceOdeSolver.cpp
+extern template class DormandPrinceOdeSolverT<Pair>;
+
+#endif /* DORMANDPRINCEODESOLVER_HPP_ */
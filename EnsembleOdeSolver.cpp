@@ -0,0 +1,134 @@
+/*
+ * EnsembleOdeSolver.cpp
+ *
+ * Implements the classical 4th order Runge-Kutta solver over an ensemble of initial conditions
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include "EnsembleOdeSolver.hpp"
+#include "StageKernels.hpp"
+
+template<class STATE>
+EnsembleOdeSolverT<STATE>::EnsembleOdeSolverT() {
+	mEnsembleSize = 0;
+	mpBatchRhsFunction = NULL;
+}
+
+template<class STATE>
+EnsembleOdeSolverT<STATE>::~EnsembleOdeSolverT() {
+}
+
+template<class STATE>
+void EnsembleOdeSolverT<STATE>::SetEnsembleInitialValues(const std::vector<ValueType>& x, const std::vector<ValueType>& y) {
+	if (x.size() != y.size()) {
+		throw Exception("OdeSetup", "Ensemble x and y initial values have different sizes");
+	}
+	if (x.empty()) {
+		throw Exception("OdeSetup", "Ensemble is empty");
+	}
+	mEnsembleSize = x.size();
+	mEnsembleInitialValues = x;
+	mEnsembleInitialValues.insert(mEnsembleInitialValues.end(), y.begin(), y.end());
+	// Keep the base class in step with the traced (first) member
+	this->SetInitialValues(x[0], y[0]);
+}
+
+template<class STATE>
+void EnsembleOdeSolverT<STATE>::SetBatchRhsFunction(void (*pFunctionName)(const ValueType*, const ValueType*, double, ValueType*, ValueType*, unsigned)) {
+	mpBatchRhsFunction = pFunctionName;
+}
+
+template<class STATE>
+unsigned EnsembleOdeSolverT<STATE>::GetEnsembleSize() const {
+	return mEnsembleSize;
+}
+
+template<class STATE>
+std::vector<typename EnsembleOdeSolverT<STATE>::ValueType> EnsembleOdeSolverT<STATE>::GetFinalXValues() const {
+	if (mEnsembleFinalValues.empty()) {
+		throw Exception("OdePost", "There no solution.  Please run the Solve() method");
+	}
+	return std::vector<ValueType>(mEnsembleFinalValues.begin(), mEnsembleFinalValues.begin() + mEnsembleSize);
+}
+
+template<class STATE>
+std::vector<typename EnsembleOdeSolverT<STATE>::ValueType> EnsembleOdeSolverT<STATE>::GetFinalYValues() const {
+	if (mEnsembleFinalValues.empty()) {
+		throw Exception("OdePost", "There no solution.  Please run the Solve() method");
+	}
+	return std::vector<ValueType>(mEnsembleFinalValues.begin() + mEnsembleSize, mEnsembleFinalValues.end());
+}
+
+template<class STATE>
+void EnsembleOdeSolverT<STATE>::EvaluateRhs(const ValueType* pState, double t, ValueType* pDerivative) {
+	this->mStats.AddRhsEvaluations(mEnsembleSize);
+	if (mpBatchRhsFunction != NULL) {
+		mpBatchRhsFunction(pState, pState + mEnsembleSize, t, pDerivative, pDerivative + mEnsembleSize, mEnsembleSize);
+		return;
+	}
+	STATE v, dvdt;
+	for (unsigned i = 0; i < mEnsembleSize; i++) {
+		v.x = pState[i];
+		v.y = pState[mEnsembleSize + i];
+		this->mpRhsFunction(v, t, dvdt);
+		pDerivative[i] = dvdt.x;
+		pDerivative[mEnsembleSize + i] = dvdt.y;
+	}
+}
+
+template<class STATE>
+void EnsembleOdeSolverT<STATE>::Solve() {
+	// Defensive programming to prevent bad inputs
+	if (this->mNumberOfTimeSteps < 0) {
+		throw Exception("OdeSolve", "The number of time steps is negative");
+	}
+
+	if (mpBatchRhsFunction == NULL && this->mpRhsFunction == NULL) {
+		throw Exception("OdeSolve", "Please define the right hand side function");
+	}
+
+	if (mEnsembleSize == 0) {
+		throw Exception("OdeSolve", "Please set the ensemble initial values");
+	}
+
+	const unsigned size = 2*mEnsembleSize;
+	std::vector<ValueType> v(mEnsembleInitialValues);
+	std::vector<ValueType> stage(size), k1(size), k2(size), k3(size), k4(size);
+
+	if (!this->mEventFunctions.empty()) {
+		throw Exception("OdeSolve", "Events are not available for the ensemble solver");
+	}
+	mEnsembleFinalValues.clear();
+
+	// Start the trace with the first member's initial values and start times
+	double time = this->mStartTime;
+	this->BeginRecording(time, STATE(v[0], v[mEnsembleSize]));
+	for (int64_t t = 1; t <= this->mNumberOfTimeSteps; t++) {
+
+		// Run the DE over all members for each stage
+		EvaluateRhs(&v[0], time, &k1[0]);
+		StageValues(&stage[0], &v[0], 0.5*this->mTimeStepSize, &k1[0], size);
+		EvaluateRhs(&stage[0], time + this->mTimeStepSize*0.5, &k2[0]);
+		StageValues(&stage[0], &v[0], 0.5*this->mTimeStepSize, &k2[0], size);
+		EvaluateRhs(&stage[0], time + this->mTimeStepSize*0.5, &k3[0]);
+		StageValues(&stage[0], &v[0], this->mTimeStepSize, &k3[0], size);
+		EvaluateRhs(&stage[0], time + this->mTimeStepSize, &k4[0]);
+
+		// Progress over the current timestep
+		CombineStages(&v[0], this->mTimeStepSize, &k1[0], &k2[0], &k3[0], &k4[0], size);
+
+		// Append the first member to the traces
+		time = this->GetStepTime(t);
+		this->RecordStep(time, STATE(v[0], v[mEnsembleSize]));
+	}
+	this->EndRecording();
+
+	mEnsembleFinalValues.swap(v);
+}
+
+// The solver is compiled here, next to its kernels, in double, mixed and single precision
+template class EnsembleOdeSolverT<Pair>;
+template class EnsembleOdeSolverT<MixedPair>;
+template class EnsembleOdeSolverT<FloatPair>;
@@ -0,0 +1,90 @@
+/*
+ * EnsembleOdeSolver.hpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef ENSEMBLEODESOLVER_HPP_
+#define ENSEMBLEODESOLVER_HPP_
+
+#include "AbstractOdeSolver.hpp"
+
+/**
+ * Runs the classical 4th order Runge-Kutta method on a whole ensemble of initial conditions in lockstep.
+ *
+ * The ensemble state is stored structure-of-arrays: all N x-values, followed by all N y-values.  The
+ * right-hand side is called once per stage for the whole ensemble, and the stage combinations are
+ * done by AVX-512/AVX2 kernels when the translation unit is compiled with those instruction sets
+ * (e.g. -march=native), otherwise by plain loops.
+ *
+ *  * SetEnsembleInitialValues() replaces SetInitialValues()
+ *  * SetBatchRhsFunction() sets the batched right-hand side.  If it is not set then the usual
+ *    SetRhsFunction() right-hand side is called once per ensemble member instead
+ *  * The time and solution traces record the first ensemble member, so that the usual
+ *    post-processing works.  GetFinalXValues() and GetFinalYValues() give the whole ensemble at the end time.
+ *  * The components are stored in the state's precision, so the float solvers (MixedPair and
+ *    FloatPair) fit twice as many members in each vector register
+ */
+template<class STATE>
+class EnsembleOdeSolverT: public AbstractOdeSolverT<STATE> {
+public:
+	/** Type of the ensemble components (double or float) */
+	typedef typename STATE::ValueType ValueType;
+
+private:
+	/** Number of ensemble members */
+	unsigned mEnsembleSize;
+
+	/** Initial conditions for the ensemble: x-values then y-values */
+	std::vector<ValueType> mEnsembleInitialValues;
+
+	/** Ensemble state at the end time (same layout as the initial values) - calculated during solve */
+	std::vector<ValueType> mEnsembleFinalValues;
+
+	/** Batched righthand side function pointer */
+	void (* mpBatchRhsFunction)(const ValueType*, const ValueType*, double, ValueType*, ValueType*, unsigned);
+
+	/** Evaluates the batched right-hand side, falling back to the per-member one if needed */
+	void EvaluateRhs(const ValueType* pState, double t, ValueType* pDerivative);
+
+public:
+	EnsembleOdeSolverT();
+	virtual ~EnsembleOdeSolverT();
+
+	std::string GetSolverName() const {
+		return "EnsembleRungeKutta4";
+	}
+
+	/** Initial conditions: one x and one y per ensemble member.  Throws if the sizes differ or are zero */
+	void SetEnsembleInitialValues(const std::vector<ValueType>& x, const std::vector<ValueType>& y);
+
+	/**
+	 * Set the batched righthand side function.  It is called with the x- and y-values of all
+	 * ensemble members, the time, the output dx/dt and dy/dt arrays and the ensemble size.
+	 */
+	void SetBatchRhsFunction(void (*pFunctionName)(const ValueType*, const ValueType*, double, ValueType*, ValueType*, unsigned));
+
+	/** Number of ensemble members */
+	unsigned GetEnsembleSize() const;
+
+	/** Post-processing method : x-values of all ensemble members at the end time */
+	std::vector<ValueType> GetFinalXValues() const;
+
+	/** Post-processing method : y-values of all ensemble members at the end time */
+	std::vector<ValueType> GetFinalYValues() const;
+
+	void Solve();
+};
+
+/** The double precision ensemble solver */
+typedef EnsembleOdeSolverT<Pair> EnsembleOdeSolver;
+/** Single precision ensembles, with the time accumulated in double (mixed) or in float */
+typedef EnsembleOdeSolverT<MixedPair> MixedEnsembleOdeSolver;
+typedef EnsembleOdeSolverT<FloatPair> FloatEnsembleOdeSolver;
+// Compiled in EnsembleOdeSolver.cpp, which has the vector kernels
+extern template class EnsembleOdeSolverT<Pair>;
+extern template class EnsembleOdeSolverT<MixedPair>;
+extern template class EnsembleOdeSolverT<FloatPair>;
+
+#endif /* ENSEMBLEODESOLVER_HPP_ */
@@ -0,0 +1,15 @@
+/*
+ * ExplicitRungeKuttaOdeSolver.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include "ExplicitRungeKuttaOdeSolver.hpp"
+
+// The methods are templates defined in the header.  The 2-D (Pair) versions of the solvers without
+// headers of their own are compiled here once.
+template class ExplicitRungeKuttaOdeSolverT<Pair, HeunTableau>;
+template class ExplicitRungeKuttaOdeSolverT<Pair, RalstonTableau>;
+template class ExplicitRungeKuttaOdeSolverT<Pair, SspRungeKutta3Tableau>;
+template class ExplicitRungeKuttaOdeSolverT<Pair, RungeKutta38Tableau>;
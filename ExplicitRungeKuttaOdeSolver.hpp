@@ -0,0 +1,332 @@
+/*
+ * ExplicitRungeKuttaOdeSolver.hpp
+ *
+ * Fixed time-step explicit Runge-Kutta solvers, each given by its Butcher tableau
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef EXPLICITRUNGEKUTTAODESOLVER_HPP_
+#define EXPLICITRUNGEKUTTAODESOLVER_HPP_
+
+#include <new>
+#include <utility>
+#include "AbstractOdeSolver.hpp"
+#include "OdeStepper.hpp"
+
+/*
+ * Butcher tableaux.  Each one gives the number of stages S, the order, the solver's name and the
+ * coefficients as constexpr arrays:
+ *     k_i = f(v + dt*(A[i][0]*k_0 + ... + A[i][i-1]*k_{i-1}), t + C[i]*dt)
+ *     v  <- v + dt*(B[0]*k_0 + ... + B[S-1]*k_{S-1})
+ * Since the coefficients are known at compile time the zero ones cost nothing.
+ */
+
+/** Forward Euler: first order, one stage */
+struct ForwardEulerTableau
+{
+    static constexpr int STAGES = 1;
+    static constexpr int ORDER = 1;
+    static constexpr const char* NAME = "ForwardEuler";
+    static constexpr double A[1][1] = {{0.0}};
+    static constexpr double B[1] = {1.0};
+    static constexpr double C[1] = {0.0};
+};
+
+/** The explicit midpoint method: second order */
+struct MidpointTableau
+{
+    static constexpr int STAGES = 2;
+    static constexpr int ORDER = 2;
+    static constexpr const char* NAME = "RungeKutta2";
+    static constexpr double A[2][2] = {{0.0, 0.0},
+                                       {0.5, 0.0}};
+    static constexpr double B[2] = {0.0, 1.0};
+    static constexpr double C[2] = {0.0, 0.5};
+};
+
+/** Heun's method (the explicit trapezium rule): second order */
+struct HeunTableau
+{
+    static constexpr int STAGES = 2;
+    static constexpr int ORDER = 2;
+    static constexpr const char* NAME = "Heun";
+    static constexpr double A[2][2] = {{0.0, 0.0},
+                                       {1.0, 0.0}};
+    static constexpr double B[2] = {0.5, 0.5};
+    static constexpr double C[2] = {0.0, 1.0};
+};
+
+/** Ralston's method: the second order method with the smallest error bound */
+struct RalstonTableau
+{
+    static constexpr int STAGES = 2;
+    static constexpr int ORDER = 2;
+    static constexpr const char* NAME = "Ralston";
+    static constexpr double A[2][2] = {{0.0, 0.0},
+                                       {2.0/3.0, 0.0}};
+    static constexpr double B[2] = {0.25, 0.75};
+    static constexpr double C[2] = {0.0, 2.0/3.0};
+};
+
+/** Shu and Osher's strong stability preserving method: third order */
+struct SspRungeKutta3Tableau
+{
+    static constexpr int STAGES = 3;
+    static constexpr int ORDER = 3;
+    static constexpr const char* NAME = "SspRungeKutta3";
+    static constexpr double A[3][3] = {{0.0, 0.0, 0.0},
+                                       {1.0, 0.0, 0.0},
+                                       {0.25, 0.25, 0.0}};
+    static constexpr double B[3] = {1.0/6.0, 1.0/6.0, 2.0/3.0};
+    static constexpr double C[3] = {0.0, 1.0, 0.5};
+};
+
+/** The classical fourth order Runge-Kutta method */
+struct RungeKutta4Tableau
+{
+    static constexpr int STAGES = 4;
+    static constexpr int ORDER = 4;
+    static constexpr const char* NAME = "RungeKutta4";
+    static constexpr double A[4][4] = {{0.0, 0.0, 0.0, 0.0},
+                                       {0.5, 0.0, 0.0, 0.0},
+                                       {0.0, 0.5, 0.0, 0.0},
+                                       {0.0, 0.0, 1.0, 0.0}};
+    static constexpr double B[4] = {1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0};
+    static constexpr double C[4] = {0.0, 0.5, 0.5, 1.0};
+};
+
+/** Kutta's 3/8 rule: fourth order, with smaller error constants than the classical method */
+struct RungeKutta38Tableau
+{
+    static constexpr int STAGES = 4;
+    static constexpr int ORDER = 4;
+    static constexpr const char* NAME = "RungeKutta38";
+    static constexpr double A[4][4] = {{0.0, 0.0, 0.0, 0.0},
+                                       {1.0/3.0, 0.0, 0.0, 0.0},
+                                       {-1.0/3.0, 1.0, 0.0, 0.0},
+                                       {1.0, -1.0, 1.0, 0.0}};
+    static constexpr double B[4] = {0.125, 0.375, 0.375, 0.125};
+    static constexpr double C[4] = {0.0, 1.0/3.0, 2.0/3.0, 1.0};
+};
+
+/** Whether the tableau is explicit (A strictly lower triangular), so that the stages can be taken in turn */
+template<class TABLEAU>
+constexpr bool IsExplicitTableau()
+{
+    for (int i=0; i<TABLEAU::STAGES; i++)
+    {
+        for (int j=i; j<TABLEAU::STAGES; j++)
+        {
+            if (TABLEAU::A[i][j] != 0.0)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/** Row I of A, and the weights B, as functions of the column (for the stage sums below) */
+template<class TABLEAU, int I>
+struct ButcherRow
+{
+    static constexpr double Get(int j) { return TABLEAU::A[I][j]; }
+};
+
+template<class TABLEAU>
+struct ButcherWeights
+{
+    static constexpr double Get(int j) { return TABLEAU::B[j]; }
+};
+
+/**
+ * An explicit Runge-Kutta solver with the coefficients from TABLEAU.  The stages are unrolled at
+ * compile time, each stage value is built only from the stages with non-zero coefficients, and the
+ * stage derivatives are kept in one array on the stack.
+ */
+template<class STATE, class TABLEAU>
+class ExplicitRungeKuttaOdeSolverT: public AbstractOdeSolverT<STATE> {
+	static_assert(IsExplicitTableau<TABLEAU>(), "The Butcher tableau should be explicit");
+
+	/**
+	 * Room for the stage derivatives k, each constructed (as zero) just before its stage.  Zeroing
+	 * them all up front is one wide store, which is slower than the stages' own small ones.
+	 */
+	union Stages {
+		STATE k[TABLEAU::STAGES];
+		Stages() {}
+	};
+
+	/** Adds dt times the sum of COEFFICIENTS::Get(j)*k[j] over the non-zero coefficients to rValue */
+	template<class COEFFICIENTS, int... J>
+	static inline void AddStages(STATE& rValue, const STATE* k, double dt, std::integer_sequence<int, J...>);
+
+	/** Take stage I, which needs the stages before it */
+	template<int I, class RHS>
+	static inline void TakeStage(RHS& rRhs, double t, double dt, const STATE& v, STATE* k);
+
+	/** Take the stages in turn.  A fold rather than recursion, so that every stage is inlined */
+	template<class RHS, int... I>
+	static inline void TakeStages(RHS& rRhs, double t, double dt, const STATE& v, STATE* k, std::integer_sequence<int, I...>);
+
+public:
+	ExplicitRungeKuttaOdeSolverT();
+	virtual ~ExplicitRungeKuttaOdeSolverT();
+
+	/** The tableau's coefficients */
+	typedef TABLEAU Tableau;
+
+	std::string GetSolverName() const {
+		return TABLEAU::NAME;
+	}
+
+	/** Solve with the function pointer set by SetRhsFunction() */
+	void Solve();
+
+	/**
+	 * Solve with any callable right-hand side rhs(v, t, dvdt): a lambda (which can capture
+	 * parameters), a functor or a function pointer.  The call is inlined into the stages.
+	 */
+	template<class RHS>
+	void Solve(RHS rhs);
+
+	/** Advance v over one time step from time t to t+dt */
+	template<class RHS>
+	void TakeStep(RHS& rRhs, double t, double dt, STATE& v) const;
+
+	/** The right-hand side function pointer set by SetRhsFunction() */
+	typedef void (*RhsFunction)(const STATE&, double, STATE&);
+
+	/**
+	 * A stepper (see OdeStepper.hpp) which integrates the problem as set up so far a step at a time,
+	 * with the function pointer set by SetRhsFunction(), or with any callable rhs(v, t, dvdt)
+	 */
+	OdeStepperT<ExplicitRungeKuttaOdeSolverT, RhsFunction> GetStepper() const;
+
+	template<class RHS>
+	OdeStepperT<ExplicitRungeKuttaOdeSolverT, RHS> GetStepper(RHS rhs) const;
+};
+
+template<class STATE, class TABLEAU>
+ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>::ExplicitRungeKuttaOdeSolverT() {
+}
+
+template<class STATE, class TABLEAU>
+ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>::~ExplicitRungeKuttaOdeSolverT() {
+}
+
+template<class STATE, class TABLEAU>
+void ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>::Solve() {
+	if (this->mpRhsFunction == NULL) {
+		throw Exception("OdeSolve", "Please define the right hand side function");
+	}
+	Solve(this->mpRhsFunction);
+}
+
+template<class STATE, class TABLEAU>
+template<class RHS>
+void ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>::Solve(RHS rhs) {
+	this->RunFixedTimeSteps(*this, rhs);
+}
+
+template<class STATE, class TABLEAU>
+template<class COEFFICIENTS, int... J>
+void ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>::AddStages(STATE& rValue, const STATE* k, double dt,
+                                                           std::integer_sequence<int, J...>) {
+	if constexpr (sizeof...(J) > 0) {
+		// Scaling each stage by the scalar coefficient*dt costs one multiply a stage, and the sum of
+		// the increments is added to rValue last to keep its rounding error small
+		STATE sum;
+		bool first = true;
+		auto add_stage = [&](auto j) {
+			constexpr double coefficient = COEFFICIENTS::Get(decltype(j)::value);
+			if constexpr (coefficient != 0.0) {
+				if (first) {
+					sum = k[j]*(coefficient*dt);
+					first = false;
+				} else {
+					sum += k[j]*(coefficient*dt);
+				}
+			}
+		};
+		(add_stage(std::integral_constant<int, J>()), ...);
+		if (!first) {
+			rValue += sum;
+		}
+	}
+}
+
+template<class STATE, class TABLEAU>
+template<int I, class RHS>
+void ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>::TakeStage(RHS& rRhs, double t, double dt, const STATE& v, STATE* k) {
+	new (&k[I]) STATE();
+	if constexpr (I == 0) {
+		rRhs(v, t, k[0]);
+	} else {
+		STATE stage_value = v;
+		AddStages<ButcherRow<TABLEAU, I> >(stage_value, k, dt, std::make_integer_sequence<int, I>());
+		rRhs(stage_value, t + TABLEAU::C[I]*dt, k[I]);
+	}
+}
+
+template<class STATE, class TABLEAU>
+template<class RHS, int... I>
+void ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>::TakeStages(RHS& rRhs, double t, double dt, const STATE& v, STATE* k,
+                                                            std::integer_sequence<int, I...>) {
+	(TakeStage<I>(rRhs, t, dt, v, k), ...);
+}
+
+template<class STATE, class TABLEAU>
+template<class RHS>
+void ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>::TakeStep(RHS& rRhs, double t, double dt, STATE& v) const {
+	Stages stages;
+	TakeStages(rRhs, t, dt, v, stages.k, std::make_integer_sequence<int, TABLEAU::STAGES>());
+	AddStages<ButcherWeights<TABLEAU> >(v, stages.k, dt, std::make_integer_sequence<int, TABLEAU::STAGES>());
+}
+
+template<class STATE, class TABLEAU>
+OdeStepperT<ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>, typename ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>::RhsFunction>
+ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>::GetStepper() const {
+	if (this->mpRhsFunction == NULL) {
+		throw Exception("OdeSolve", "Please define the right hand side function");
+	}
+	return GetStepper(this->mpRhsFunction);
+}
+
+template<class STATE, class TABLEAU>
+template<class RHS>
+OdeStepperT<ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>, RHS> ExplicitRungeKuttaOdeSolverT<STATE, TABLEAU>::GetStepper(RHS rhs) const {
+	if (this->mNumberOfTimeSteps < 0) {
+		throw Exception("OdeSolve", "The number of time steps is negative");
+	}
+	return OdeStepperT<ExplicitRungeKuttaOdeSolverT, RHS>(*this, rhs, this->mStartTime, this->mTimeStepSize,
+	                                                     this->mNumberOfTimeSteps, this->mInitialValues);
+}
+
+/*
+ * The solvers.  ForwardEulerOdeSolverT, HigherOrderOdeSolverT (midpoint) and RK4SolverT are in
+ * their own headers.
+ */
+template<class STATE>
+using HeunOdeSolverT = ExplicitRungeKuttaOdeSolverT<STATE, HeunTableau>;
+template<class STATE>
+using RalstonOdeSolverT = ExplicitRungeKuttaOdeSolverT<STATE, RalstonTableau>;
+template<class STATE>
+using SspRungeKutta3OdeSolverT = ExplicitRungeKuttaOdeSolverT<STATE, SspRungeKutta3Tableau>;
+template<class STATE>
+using RungeKutta38OdeSolverT = ExplicitRungeKuttaOdeSolverT<STATE, RungeKutta38Tableau>;
+
+/** The 2-D solvers */
+typedef HeunOdeSolverT<Pair> HeunOdeSolver;
+typedef RalstonOdeSolverT<Pair> RalstonOdeSolver;
+typedef SspRungeKutta3OdeSolverT<Pair> SspRungeKutta3OdeSolver;
+typedef RungeKutta38OdeSolverT<Pair> RungeKutta38OdeSolver;
+// Compiled once in ExplicitRungeKuttaOdeSolver.cpp
+extern template class ExplicitRungeKuttaOdeSolverT<Pair, HeunTableau>;
+extern template class ExplicitRungeKuttaOdeSolverT<Pair, RalstonTableau>;
+extern template class ExplicitRungeKuttaOdeSolverT<Pair, SspRungeKutta3Tableau>;
+extern template class ExplicitRungeKuttaOdeSolverT<Pair, RungeKutta38Tableau>;
+
+#endif /* EXPLICITRUNGEKUTTAODESOLVER_HPP_ */
@@ -8,13 +8,15 @@
 #ifndef FORWARDEULERODESOLVER_HPP_
 #define FORWARDEULERODESOLVER_HPP_
 
-#include "AbstractOdeSolver.hpp"
+#include "ExplicitRungeKuttaOdeSolver.hpp"
 
-class ForwardEulerOdeSolver: public AbstractOdeSolver {
-public:
-	ForwardEulerOdeSolver();
-	virtual ~ForwardEulerOdeSolver();
-	void Solve();
-};
+/** The forward Euler solver: the one-stage explicit Runge-Kutta method */
+template<class STATE>
+using ForwardEulerOdeSolverT = ExplicitRungeKuttaOdeSolverT<STATE, ForwardEulerTableau>;
+
+/** The original 2-D solver */
+typedef ForwardEulerOdeSolverT<Pair> ForwardEulerOdeSolver;
+// Compiled once in ForwardEulerOdeSolver.cpp
+extern template class ExplicitRungeKuttaOdeSolverT<Pair, ForwardEulerTableau>;
 
 #endif /* FORWARDEULERODESOLVER_HPP_ */
@@ -0,0 +1,122 @@
+/*
+ * HeatEquationDemo.cpp
+ *
+ * The 1-D heat equation u_t = u_xx on (0, 1), with u = 0 at both ends, solved by the method of lines:
+ * central differences in space turn it into one ODE per grid point, which LargeSystemOdeSolver
+ * integrates with RK4.  Build and run with "make heat".  The optional arguments are the number of
+ * grid points (default 10^6), the number of steps (default 200) and the number of threads (default
+ * one per core), e.g. "make heat HEAT_ARGS='1e7 50 4'".
+ *
+ * The initial condition is sin(pi x) + sin(m pi x), where mode m is chosen to decay by about a factor
+ * of e over the run.  Each sine is an eigenvector of the difference operator, so the semi-discrete
+ * solution is known exactly and the error printed at the end is RK4's (and rounding's) alone.
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "LargeSystemOdeSolver.hpp"
+
+/** Central differences on the size interior points x_i = (i + 1)/(size + 1) */
+struct HeatEquation
+{
+    void operator()(const double* v, double t, double* dvdt, std::size_t begin, std::size_t end, std::size_t size) const
+    {
+        const double scale = (size + 1.0)*(size + 1.0);
+        std::size_t i = begin;
+        // The end points see the zero boundary values, and the loop in between has no branches
+        if (i == 0 && i < end)
+        {
+            dvdt[0] = scale*(-2.0*v[0] + (size > 1 ? v[1] : 0.0));
+            i++;
+        }
+        const std::size_t interior_end = std::min(end, size - 1);
+        for (; i < interior_end; i++)
+        {
+            dvdt[i] = scale*(v[i - 1] - 2.0*v[i] + v[i + 1]);
+        }
+        if (i < end)
+        {
+            dvdt[i] = scale*(v[i - 1] - 2.0*v[i]);
+        }
+    }
+};
+
+/** Decay rate of the sine mode k under the difference operator */
+double ModeDecayRate(double k, std::size_t size)
+{
+    const double s = sin(k*M_PI/(2.0*(size + 1.0)));
+    return 4.0*(size + 1.0)*(size + 1.0)*s*s;
+}
+
+double WallTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t size = (argc > 1) ? (std::size_t) std::atof(argv[1]) : 1000000;
+    const int64_t num_steps = (argc > 2) ? (int64_t) std::atof(argv[2]) : 200;
+    const unsigned num_threads = (argc > 3) ? (unsigned) std::atoi(argv[3]) : 0;
+    if (size < 2 || num_steps < 1)
+    {
+        std::cerr << "Usage: " << argv[0] << " [grid points >= 2] [steps >= 1] [threads]\n";
+        return 1;
+    }
+
+    // RK4 is stable for dt < 0.7 dx^2 on this problem
+    const double dx = 1.0/(size + 1.0);
+    const double dt = 0.4*dx*dx;
+    const double end_time = num_steps*dt;
+    // Mode m decays by a factor of e by the end time
+    const double m = std::max(2.0, std::floor(2.0*(size + 1.0)/M_PI*asin(sqrt(1.0/(4.0*0.4*num_steps)))));
+
+    std::vector<double> initial(size);
+    for (std::size_t i=0; i<size; i++)
+    {
+        const double x = (i + 1.0)*dx;
+        initial[i] = sin(M_PI*x) + sin(m*M_PI*x);
+    }
+
+    LargeSystemOdeSolver solver;
+    solver.SetSystemInitialValues(initial);
+    solver.SetSystemRhsFunction(HeatEquation());
+    solver.SetNumberOfThreads(num_threads);
+    solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, end_time);
+    solver.SetTracedComponents(size/2, size/4);
+    solver.SetStoreTrace(false);
+
+    // The first solve allocates the workspace and starts the threads, so time the second
+    solver.Solve();
+    const double start = WallTime();
+    solver.Solve();
+    const double seconds = WallTime() - start;
+
+    const double low_decay = exp(-ModeDecayRate(1.0, size)*end_time);
+    const double high_decay = exp(-ModeDecayRate(m, size)*end_time);
+    std::vector<double> final_values = solver.GetFinalValues();
+    double max_error = 0.0;
+    for (std::size_t i=0; i<size; i++)
+    {
+        const double x = (i + 1.0)*dx;
+        const double exact = low_decay*sin(M_PI*x) + high_decay*sin(m*M_PI*x);
+        max_error = std::max(max_error, fabs(final_values[i] - exact));
+    }
+
+    std::cout << "grid points:                " << size << "\n";
+    std::cout << "steps:                      " << num_steps << " of dt = " << dt << " to t = " << end_time << "\n";
+    std::cout << "second mode:                " << (long) m << ", decayed by " << high_decay << "\n";
+    std::cout << "workspace:                  " << solver.GetWorkspaceBytes()/1048576.0 << " MB\n";
+    std::cout << "solve time:                 " << seconds << " s\n";
+    std::cout << "ns per point per step:      " << 1e9*seconds/((double) size*num_steps) << "\n";
+    std::cout << "max error (semi-discrete):  " << max_error << "\n";
+    return 0;
+}
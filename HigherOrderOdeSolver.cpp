@@ -9,44 +9,5 @@
 
 #include "HigherOrderOdeSolver.hpp"
 
-HigherOrderOdeSolver::HigherOrderOdeSolver() {
-	// TODO Auto-generated constructor stub
-
-}
-
-HigherOrderOdeSolver::~HigherOrderOdeSolver() {
-	// TODO Auto-generated destructor stub
-}
-
-void HigherOrderOdeSolver::Solve() {
-	// Defensive programming to prevent bad inputs
-	if (mNumberOfTimeSteps < 0) {
-        throw "The number of time steps is negative";
-	}
-
-	if (mpRhsFunction == NULL) {
-		throw "Please define the right hand side function";
-	}
-
-	Pair v, k1, k2;
-
-	// Clear the traces if the code has been previously run
-	mSolutionTrace.clear();
-	mTimeTrace.clear();
-
-	// Start the trace with the initial values and start times
-	mSolutionTrace.push_back(mInitialValues);
-	mTimeTrace.push_back(mStartTime);
-    for (int t = 1; t <= mNumberOfTimeSteps; t++) {
-    	// Run the DE
-    	mpRhsFunction(mSolutionTrace.back(), mTimeTrace.back(), k1);
-    	mpRhsFunction(mSolutionTrace.back() + k1*(0.5*mTimeStepSize), mTimeTrace.back() + mTimeStepSize*0.5, k2);
-
-    	// Progress over the current timestep
-    	v = mSolutionTrace.back() + k2*mTimeStepSize;
-
-    	// Append the results to the traces
-    	mSolutionTrace.push_back(v);
-    	mTimeTrace.push_back(mStartTime + t*mTimeStepSize);
-    }
-}
+// The methods are templates defined in the header.  The 2-D (Pair) version is compiled here once.
+template class ExplicitRungeKuttaOdeSolverT<Pair, MidpointTableau>;
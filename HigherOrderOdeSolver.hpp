@@ -1,6 +1,8 @@
 /*
  * HigherOrderOdeSolver.hpp
  *
+ * Implements a second order Runge-Kutta solver
+ *
  *  Created on: 25 Oct 2017
  *      Author: adathy
  */
@@ -8,13 +10,15 @@
 #ifndef HIGHERORDERODESOLVER_HPP_
 #define HIGHERORDERODESOLVER_HPP_
 
-#include "AbstractOdeSolver.hpp"
+#include "ExplicitRungeKuttaOdeSolver.hpp"
+
+/** The second order Runge-Kutta (explicit midpoint) solver, from its Butcher tableau */
+template<class STATE>
+using HigherOrderOdeSolverT = ExplicitRungeKuttaOdeSolverT<STATE, MidpointTableau>;
 
-class HigherOrderOdeSolver: public AbstractOdeSolver {
-public:
-	HigherOrderOdeSolver();
-	virtual ~HigherOrderOdeSolver();
-	void Solve();
-};
+/** The original 2-D solver */
+typedef HigherOrderOdeSolverT<Pair> HigherOrderOdeSolver;
+// Compiled once in HigherOrderOdeSolver.cpp
+extern template class ExplicitRungeKuttaOdeSolverT<Pair, MidpointTableau>;
 
 #endif /* HIGHERORDERODESOLVER_HPP_ */
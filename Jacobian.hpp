@@ -0,0 +1,132 @@
+/*
+ * Jacobian.hpp
+ *
+ * Small dense matrices for the implicit solvers: the Jacobian of the right-hand side and the LU
+ * factorisation of the Newton iteration matrix
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef JACOBIAN_HPP_
+#define JACOBIAN_HPP_
+
+#include <cmath>
+#include "Exception.hpp"
+#include "State.hpp"
+
+/**
+ * Jacobian of an N-variable right-hand side: jacobian(i, j) is d(dvdt[i])/d(v[j]).  Stored by rows,
+ * one state per row, so it is DIMENSION*DIMENSION components (in the state's precision) with no
+ * heap allocation.
+ */
+template<class STATE>
+struct JacobianT
+{
+    static const int DIMENSION = STATE::DIMENSION; ///< Number of rows and columns
+    typedef typename STATE::ValueType ValueType;   ///< Type of the entries
+
+    STATE rows[DIMENSION]; ///< The entries (zero unless set)
+
+    ValueType& operator()(int i, int j) { return rows[i][j]; }
+    const ValueType& operator()(int i, int j) const { return rows[i][j]; }
+};
+
+/** The Jacobian of a 2-D system */
+typedef JacobianT<State<2> > Jacobian;
+
+/**
+ * LU factorisation, with partial pivoting, of the Newton iteration matrix I - coefficient*J.  The
+ * implicit solvers factorise once and then call Solve() for every Newton iteration (or Rosenbrock
+ * stage) until the Jacobian or the coefficient changes.
+ */
+template<class STATE>
+class LuFactorisationT
+{
+private:
+    static const int N = STATE::DIMENSION;
+
+    /** L (below the diagonal, with a unit diagonal) and U (on and above it) */
+    JacobianT<STATE> mLu;
+    /** Row swapped with row i when eliminating column i */
+    int mPivots[N];
+
+public:
+    /** Factorise I - coefficient*rJacobian.  Throws if the matrix is singular */
+    void Factorise(const JacobianT<STATE>& rJacobian, double coefficient)
+    {
+        for (int i=0; i<N; i++)
+        {
+            for (int j=0; j<N; j++)
+            {
+                mLu(i, j) = (i == j ? 1.0 : 0.0) - coefficient*rJacobian(i, j);
+            }
+        }
+        for (int k=0; k<N; k++)
+        {
+            // Pivot on the largest entry in the column
+            int pivot = k;
+            for (int i=k+1; i<N; i++)
+            {
+                if (fabs(mLu(i, k)) > fabs(mLu(pivot, k)))
+                {
+                    pivot = i;
+                }
+            }
+            if (mLu(pivot, k) == 0.0 || !std::isfinite(mLu(pivot, k)))
+            {
+                throw Exception("OdeSolve", "The Newton iteration matrix is singular");
+            }
+            mPivots[k] = pivot;
+            if (pivot != k)
+            {
+                STATE row = mLu.rows[k];
+                mLu.rows[k] = mLu.rows[pivot];
+                mLu.rows[pivot] = row;
+            }
+            for (int i=k+1; i<N; i++)
+            {
+                double multiplier = mLu(i, k)/mLu(k, k);
+                mLu(i, k) = multiplier;
+                for (int j=k+1; j<N; j++)
+                {
+                    mLu(i, j) -= multiplier*mLu(k, j);
+                }
+            }
+        }
+    }
+
+    /** Overwrite rRhs with the solution x of (I - coefficient*J) x = rRhs */
+    void Solve(STATE& rRhs) const
+    {
+        // The rows were swapped in full while factorising, so apply all the swaps first
+        for (int k=0; k<N; k++)
+        {
+            if (mPivots[k] != k)
+            {
+                double temp = rRhs[k];
+                rRhs[k] = rRhs[mPivots[k]];
+                rRhs[mPivots[k]] = temp;
+            }
+        }
+        // Forward substitution with L
+        for (int k=0; k<N; k++)
+        {
+            for (int i=k+1; i<N; i++)
+            {
+                rRhs[i] -= mLu(i, k)*rRhs[k];
+            }
+        }
+        // Back substitution with U
+        for (int i=N-1; i>=0; i--)
+        {
+            for (int j=i+1; j<N; j++)
+            {
+                rRhs[i] -= mLu(i, j)*rRhs[j];
+            }
+            rRhs[i] /= mLu(i, i);
+        }
+    }
+};
+
+#endif /* JACOBIAN_HPP_ */
@@ -0,0 +1,211 @@
+/*
+ * LargeSystemOdeSolver.cpp
+ *
+ * Implements the classical 4th order Runge-Kutta solver over a large, runtime-sized system
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include <algorithm>
+#include <thread>
+#include "LargeSystemOdeSolver.hpp"
+#include "StageKernels.hpp"
+
+/** Components per tile: the right-hand side and stage combination of a tile (16 KB per array) stay in cache */
+static const std::size_t TILE_SIZE = 2048;
+
+/** Blocks start on cache-line boundaries (8 doubles), so that two threads never write to the same line */
+static const std::size_t CACHE_LINE_DOUBLES = 8;
+
+/** Number of arrays in the workspace: the state, two stage values and k1 to k4 */
+static const unsigned NUMBER_OF_ARRAYS = 7;
+
+LargeSystemOdeSolver::LargeSystemOdeSolver() {
+	mSystemSize = 0;
+	mNumberOfThreads = 0;
+	mNumberOfBlocks = 0;
+	mWorkspaceStride = 0;
+	mTracedComponents[0] = 0;
+	mTracedComponents[1] = 1;
+	mHaveSolution = false;
+}
+
+LargeSystemOdeSolver::~LargeSystemOdeSolver() {
+}
+
+void LargeSystemOdeSolver::SetSystemInitialValues(const std::vector<double>& rValues) {
+	if (rValues.empty()) {
+		throw Exception("OdeSetup", "The system is empty");
+	}
+	mSystemInitialValues = rValues;
+}
+
+void LargeSystemOdeSolver::SetSystemRhsFunction(const RangeRhsFunction& rRhs) {
+	mSystemRhsFunction = rRhs;
+}
+
+void LargeSystemOdeSolver::SetNumberOfThreads(unsigned numberOfThreads) {
+	mNumberOfThreads = numberOfThreads;
+}
+
+void LargeSystemOdeSolver::SetTracedComponents(std::size_t xComponent, std::size_t yComponent) {
+	mTracedComponents[0] = xComponent;
+	mTracedComponents[1] = yComponent;
+}
+
+std::size_t LargeSystemOdeSolver::GetSystemSize() const {
+	return mSystemSize;
+}
+
+std::size_t LargeSystemOdeSolver::GetWorkspaceBytes() const {
+	return NUMBER_OF_ARRAYS*mWorkspaceStride*sizeof(double);
+}
+
+std::vector<double> LargeSystemOdeSolver::GetFinalValues() const {
+	if (!mHaveSolution) {
+		throw Exception("OdePost", "There no solution.  Please run the Solve() method");
+	}
+	const double* p_state = GetArray(0);
+	return std::vector<double>(p_state, p_state + mSystemSize);
+}
+
+double* LargeSystemOdeSolver::GetArray(unsigned i) const {
+	return mpWorkspace.get() + i*mWorkspaceStride;
+}
+
+template<class KERNEL>
+void LargeSystemOdeSolver::ForEachBlock(const KERNEL& rKernel) {
+	if (mNumberOfBlocks == 1) {
+		rKernel(0, mSystemSize);
+		return;
+	}
+	const std::size_t size = mSystemSize;
+	const std::size_t blocks = mNumberOfBlocks;
+	mpThreadPool->ParallelFor(blocks, [&rKernel, size, blocks](std::size_t b) {
+		std::size_t begin = ((size*b)/blocks) & ~(CACHE_LINE_DOUBLES - 1);
+		std::size_t end = (b + 1 == blocks) ? size : ((size*(b + 1))/blocks) & ~(CACHE_LINE_DOUBLES - 1);
+		rKernel(begin, end);
+	});
+}
+
+void LargeSystemOdeSolver::SetUpWorkspace() {
+	const bool new_size = (mSystemInitialValues.size() != mSystemSize);
+	mSystemSize = mSystemInitialValues.size();
+
+	unsigned threads = mNumberOfThreads;
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	mNumberOfBlocks = std::max<std::size_t>(1, std::min<std::size_t>(threads, mSystemSize/MIN_BLOCK_SIZE));
+	if (mNumberOfBlocks == 1) {
+		mpThreadPool.reset();
+	}
+	else if (!mpThreadPool || mpThreadPool->GetNumberOfThreads() != mNumberOfBlocks) {
+		mpThreadPool.reset(new WorkStealingThreadPool(mNumberOfBlocks));
+	}
+
+	if (mpWorkspace && !new_size) {
+		return;
+	}
+	// Free the old workspace before allocating the new one
+	mpWorkspace.reset();
+	mWorkspaceStride = (mSystemSize + CACHE_LINE_DOUBLES - 1) & ~(CACHE_LINE_DOUBLES - 1);
+	mpWorkspace.reset(new double[NUMBER_OF_ARRAYS*mWorkspaceStride]);
+
+	// Each block's memory is first touched by the thread that will work on it (which matters on
+	// machines where memory is local to a socket)
+	ForEachBlock([this](std::size_t begin, std::size_t end) {
+		for (unsigned a = 0; a < NUMBER_OF_ARRAYS; a++) {
+			std::fill(GetArray(a) + begin, GetArray(a) + end, 0.0);
+		}
+	});
+}
+
+void LargeSystemOdeSolver::Solve() {
+	// Defensive programming to prevent bad inputs
+	if (mNumberOfTimeSteps < 0) {
+		throw Exception("OdeSolve", "The number of time steps is negative");
+	}
+
+	if (!mSystemRhsFunction) {
+		throw Exception("OdeSolve", "Please define the right hand side function");
+	}
+
+	if (mSystemInitialValues.empty()) {
+		throw Exception("OdeSolve", "Please set the system initial values");
+	}
+
+	if (mTracedComponents[0] >= mSystemInitialValues.size() || mTracedComponents[1] >= mSystemInitialValues.size()) {
+		throw Exception("OdeSolve", "The traced components are outside the system");
+	}
+
+	if (!mEventFunctions.empty()) {
+		throw Exception("OdeSolve", "Events are not available for the large system solver");
+	}
+
+	SetUpWorkspace();
+	mHaveSolution = false;
+
+	const std::size_t size = mSystemSize;
+	double* v = GetArray(0);
+	double* stage[2] = {GetArray(1), GetArray(2)};
+	double* k[4] = {GetArray(3), GetArray(4), GetArray(5), GetArray(6)};
+	const std::size_t x_component = mTracedComponents[0];
+	const std::size_t y_component = mTracedComponents[1];
+	const RangeRhsFunction& rhs = mSystemRhsFunction;
+
+	ForEachBlock([this, v](std::size_t begin, std::size_t end) {
+		std::copy(mSystemInitialValues.begin() + begin, mSystemInitialValues.begin() + end, v + begin);
+	});
+
+	// Start the trace with the traced components' initial values and start times
+	double time = mStartTime;
+	BeginRecording(time, Pair(v[x_component], v[y_component]));
+	const double h = mTimeStepSize;
+	for (int64_t t = 1; t <= mNumberOfTimeSteps; t++) {
+
+		// Stages 1 to 3: the derivative of each tile, then straight away the tile's values for the
+		// next stage.  The right-hand side reads neighbouring tiles, so the stage values are
+		// written to the other stage array from the one being read.
+		const double* inputs[3] = {v, stage[0], stage[1]};
+		double* outputs[3] = {stage[0], stage[1], stage[0]};
+		const double input_times[3] = {time, time + 0.5*h, time + 0.5*h};
+		const double factors[3] = {0.5*h, 0.5*h, h};
+		for (int s = 0; s < 3; s++) {
+			const double* p_input = inputs[s];
+			double* p_output = outputs[s];
+			double* p_k = k[s];
+			const double input_time = input_times[s];
+			const double factor = factors[s];
+			ForEachBlock([&rhs, p_input, p_output, p_k, v, input_time, factor, size](std::size_t begin, std::size_t end) {
+				for (std::size_t tile = begin; tile < end; tile += TILE_SIZE) {
+					const std::size_t tile_end = std::min(end, tile + TILE_SIZE);
+					rhs(p_input, input_time, p_k, tile, tile_end, size);
+					StageValues(p_output + tile, v + tile, factor, p_k + tile, tile_end - tile);
+				}
+			});
+		}
+
+		// Stage 4, then progress over the current timestep.  Each component of v is only read by its
+		// own tile, so it can be updated in place.
+		const double* p_input = stage[0];
+		double* const* p_k = k;
+		const double input_time = time + h;
+		ForEachBlock([&rhs, p_input, p_k, v, input_time, h, size](std::size_t begin, std::size_t end) {
+			for (std::size_t tile = begin; tile < end; tile += TILE_SIZE) {
+				const std::size_t tile_end = std::min(end, tile + TILE_SIZE);
+				rhs(p_input, input_time, p_k[3], tile, tile_end, size);
+				CombineStages(v + tile, h, p_k[0] + tile, p_k[1] + tile, p_k[2] + tile, p_k[3] + tile, tile_end - tile);
+			}
+		});
+		mStats.AddRhsEvaluations(4);
+
+		// Append the traced components to the traces
+		time = GetStepTime(t);
+		RecordStep(time, Pair(v[x_component], v[y_component]));
+	}
+	EndRecording();
+
+	mHaveSolution = true;
+}
@@ -0,0 +1,121 @@
+/*
+ * LargeSystemOdeSolver.hpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef LARGESYSTEMODESOLVER_HPP_
+#define LARGESYSTEMODESOLVER_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "AbstractOdeSolver.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * Runs the classical 4th order Runge-Kutta method on a system whose size is only known at run time,
+ * e.g. the method-of-lines semi-discretisation of a PDE with 10^5 to 10^7 unknowns.
+ *
+ * The state and the stage arrays are contiguous buffers which are allocated once, on the first
+ * solve (and again only if the system size changes).  Each step is four passes over the system,
+ * one per stage, and each pass is split into blocks that run on a pool of threads.  Within a block
+ * the right-hand side is evaluated a cache-sized tile at a time, and the tile's stage combination
+ * (e.g. v + dt*(k1/6 + k2/3 + k3/3 + k4/6)) is done straight afterwards by one fused loop from
+ * StageKernels.hpp, so the new stage values are still in cache.
+ *
+ *  * SetSystemInitialValues() replaces SetInitialValues(), and sets the system size
+ *  * SetSystemRhsFunction() replaces SetRhsFunction().  The right-hand side is called as
+ *    rhs(v, t, dvdt, begin, end, size): it must set dvdt[i] for begin <= i < end, and may read any
+ *    of the size components of v.  It is called from several threads at once (on different ranges)
+ *    so it mustn't change any shared state
+ *  * The results don't depend on the number of threads
+ *  * The time and solution traces record two components of the system (0 and 1 unless
+ *    SetTracedComponents() says otherwise), so that the usual post-processing works.
+ *    GetFinalValues() gives the whole system at the end time
+ *  * Events and checkpoints are not available
+ */
+class LargeSystemOdeSolver: public AbstractOdeSolver {
+public:
+	/** Right-hand side rhs(v, t, dvdt, begin, end, size) on the components begin <= i < end */
+	typedef std::function<void(const double*, double, double*, std::size_t, std::size_t, std::size_t)> RangeRhsFunction;
+
+	/** Systems smaller than this many components per thread use fewer threads */
+	static constexpr std::size_t MIN_BLOCK_SIZE = 16384;
+
+private:
+	/** Number of components in the system */
+	std::size_t mSystemSize;
+
+	/** Initial conditions for the whole system */
+	std::vector<double> mSystemInitialValues;
+
+	/** The right-hand side over a range of components */
+	RangeRhsFunction mSystemRhsFunction;
+
+	/** Number of threads to use (zero for one per core) */
+	unsigned mNumberOfThreads;
+
+	/** The workers, kept between solves.  NULL when the system is solved on the calling thread */
+	std::unique_ptr<WorkStealingThreadPool> mpThreadPool;
+
+	/** Number of blocks each pass is split into (one per worker) */
+	std::size_t mNumberOfBlocks;
+
+	/** The state, two stage values and the four stage derivatives, one after the other */
+	std::unique_ptr<double[]> mpWorkspace;
+
+	/** Length of each array in the workspace (the system size, rounded up to whole cache lines) */
+	std::size_t mWorkspaceStride;
+
+	/** The components recorded in the x and y traces */
+	std::size_t mTracedComponents[2];
+
+	/** True once Solve() has left a solution in the workspace */
+	bool mHaveSolution;
+
+	/** Array i of the workspace: 0 is the state, 1 and 2 the stage values and 3 to 6 k1 to k4 */
+	double* GetArray(unsigned i) const;
+
+	/** Calls rKernel(begin, end) on each block of the system, on the workers if there is more than one block */
+	template<class KERNEL>
+	void ForEachBlock(const KERNEL& rKernel);
+
+	/** Allocates the workspace and starts the workers if the system size or number of threads has changed */
+	void SetUpWorkspace();
+
+public:
+	LargeSystemOdeSolver();
+	virtual ~LargeSystemOdeSolver();
+
+	std::string GetSolverName() const {
+		return "LargeSystemRungeKutta4";
+	}
+
+	/** Initial conditions for the whole system, which also give its size.  Throws if empty */
+	void SetSystemInitialValues(const std::vector<double>& rValues);
+
+	/** Set the right-hand side over a range of components (see above) */
+	void SetSystemRhsFunction(const RangeRhsFunction& rRhs);
+
+	/** Zero (the default) means one thread per core.  One means the calling thread only */
+	void SetNumberOfThreads(unsigned numberOfThreads);
+
+	/** The components recorded in the x and y traces (checked against the system size by Solve()) */
+	void SetTracedComponents(std::size_t xComponent, std::size_t yComponent);
+
+	/** Number of components in the system */
+	std::size_t GetSystemSize() const;
+
+	/** Bytes held by the state and stage arrays */
+	std::size_t GetWorkspaceBytes() const;
+
+	/** Post-processing method : the whole system at the end time */
+	std::vector<double> GetFinalValues() const;
+
+	void Solve();
+};
+
+#endif /* LARGESYSTEMODESOLVER_HPP_ */
@@ -0,0 +1,748 @@
+/*
+ * OdeObservers.hpp
+ *
+ * Observers (sinks) which are told about each step of a solve as it happens
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef ODEOBSERVERS_HPP_
+#define ODEOBSERVERS_HPP_
+
+#include <algorithm>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Exception.hpp"
+#include "TextTraceWriter.hpp"
+
+/**
+ * Writes one row of column data:
+ * time     x-value     y-value ...
+ */
+template<class STATE>
+void WriteTraceRow(TextTraceWriter& rWriter, double t, const STATE& rValues)
+{
+    double row[STATE::DIMENSION + 1];
+    row[0] = t;
+    for (int j=0; j<STATE::DIMENSION; j++)
+    {
+        row[j + 1] = rValues[j];
+    }
+    rWriter.WriteRow(row);
+}
+
+/** Writes downsampled traces to a file or path in the same column format as DumpToFile() */
+template<class STATE>
+void DumpTraceToFile(const std::string& fileName, const std::vector<double>& rTimes,
+                     const std::vector<STATE>& rSolution)
+{
+    TextTraceWriter write_output(fileName, STATE::DIMENSION + 1);
+    for (std::size_t i=0; i<rTimes.size(); i++)
+    {
+        WriteTraceRow(write_output, rTimes[i], rSolution[i]);
+    }
+    write_output.Close();
+}
+
+/**
+ * Keeps the number of buckets bounded without knowing the number of steps in advance: when there
+ * are maximumNumberOfBuckets full buckets, neighbouring pairs are merged (with BUCKET::Merge) and
+ * the number of points per bucket doubles.  Returns the new number of points per bucket.
+ */
+template<class BUCKET>
+long MergeBucketPairs(std::vector<BUCKET>& rBuckets, long pointsPerBucket)
+{
+    std::size_t merged = 0;
+    for (std::size_t i=0; i + 1<rBuckets.size(); i+=2)
+    {
+        rBuckets[merged] = rBuckets[i];
+        rBuckets[merged].Merge(rBuckets[i + 1]);
+        merged++;
+    }
+    if (rBuckets.size() % 2 == 1)
+    {
+        rBuckets[merged++] = rBuckets.back();
+    }
+    rBuckets.resize(merged);
+    return 2*pointsPerBucket;
+}
+
+/**
+ * Interface for anything that wants to see the solution as it is calculated.  Add observers to a
+ * solver with AddObserver(): the solver calls ObserveStep() for the initial values and then
+ * once for every accepted step.  Combined with SetStoreTrace(false) a solve then uses O(1) memory.
+ */
+template<class STATE>
+class AbstractOdeObserverT
+{
+public:
+    virtual ~AbstractOdeObserverT() {}
+
+    /** Called at the start of every solve, before the initial values are observed */
+    virtual void BeginSolve() {}
+
+    /** Called with the time and solution at the start and after every accepted step */
+    virtual void ObserveStep(double t, const STATE& rValues) = 0;
+
+    /** Called at the end of every solve */
+    virtual void EndSolve() {}
+
+    /**
+     * Called when the solver writes a checkpoint: make everything observed so far safe, and return
+     * where to carry on from (e.g. the length of a file), which is stored in the checkpoint
+     */
+    virtual uint64_t Checkpoint()
+    {
+        return 0;
+    }
+
+    /**
+     * Called instead of BeginSolve() when a solve resumes from a checkpoint, with what Checkpoint()
+     * returned then.  The time-point at the checkpoint has already been observed, so it isn't
+     * passed to ObserveStep() again.  By default the observer just starts again from there.
+     */
+    virtual void BeginResume(uint64_t position)
+    {
+        BeginSolve();
+    }
+};
+
+/**
+ * Keeps only the most recent time-point, which is the final state once the solve is finished
+ */
+template<class STATE>
+class FinalStateObserverT: public AbstractOdeObserverT<STATE>
+{
+private:
+    /** Number of time-points observed in the last solve */
+    long mNumberOfObservations;
+    double mFinalTime;
+    STATE mFinalValues;
+
+public:
+    FinalStateObserverT() : mNumberOfObservations(0), mFinalTime(0.0) {}
+
+    void BeginSolve()
+    {
+        mNumberOfObservations = 0;
+    }
+
+    void ObserveStep(double t, const STATE& rValues)
+    {
+        mNumberOfObservations++;
+        mFinalTime = t;
+        mFinalValues = rValues;
+    }
+
+    /** Number of time-points (including the initial one) seen in the last solve */
+    long GetNumberOfObservations() const
+    {
+        return mNumberOfObservations;
+    }
+
+    double GetFinalTime() const
+    {
+        if (mNumberOfObservations == 0)
+        {
+            throw Exception("OdePost", "There no solution.  Please run the Solve() method");
+        }
+        return mFinalTime;
+    }
+
+    const STATE& GetFinalValues() const
+    {
+        if (mNumberOfObservations == 0)
+        {
+            throw Exception("OdePost", "There no solution.  Please run the Solve() method");
+        }
+        return mFinalValues;
+    }
+};
+
+/**
+ * Keeps the final time-point and the smallest and largest value of each component over the solve
+ */
+template<class STATE>
+class RangeObserverT: public FinalStateObserverT<STATE>
+{
+private:
+    STATE mMinimumValues;
+    STATE mMaximumValues;
+
+public:
+    void ObserveStep(double t, const STATE& rValues)
+    {
+        if (this->GetNumberOfObservations() == 0)
+        {
+            mMinimumValues = rValues;
+            mMaximumValues = rValues;
+        }
+        for (int j=0; j<STATE::DIMENSION; j++)
+        {
+            mMinimumValues[j] = std::min(mMinimumValues[j], rValues[j]);
+            mMaximumValues[j] = std::max(mMaximumValues[j], rValues[j]);
+        }
+        FinalStateObserverT<STATE>::ObserveStep(t, rValues);
+    }
+
+    const STATE& GetMinimumValues() const
+    {
+        this->GetFinalValues(); // Throws if there's no solution
+        return mMinimumValues;
+    }
+
+    const STATE& GetMaximumValues() const
+    {
+        this->GetFinalValues(); // Throws if there's no solution
+        return mMaximumValues;
+    }
+};
+
+/**
+ * Keeps every k-th time-point (counting the initial values as point 0), and always the final one
+ */
+template<class STATE>
+class StrideObserverT: public AbstractOdeObserverT<STATE>
+{
+private:
+    /** Keep one in this many points */
+    long mStride;
+    /** Index of the next point to be observed */
+    long mIndex;
+    /** The most recent point and its index (-1 if none), in case it is the last and hasn't been kept */
+    long mLastIndex;
+    double mLastTime;
+    STATE mLastValues;
+
+    std::vector<double> mTimeTrace;
+    std::vector<STATE> mSolutionTrace;
+
+public:
+    StrideObserverT(long stride) : mStride(stride), mIndex(0), mLastIndex(-1), mLastTime(0.0)
+    {
+        if (stride <= 0)
+        {
+            throw Exception("OdeSetup", "Stride should be positive");
+        }
+    }
+
+    void BeginSolve()
+    {
+        mIndex = 0;
+        mLastIndex = -1;
+        mTimeTrace.clear();
+        mSolutionTrace.clear();
+    }
+
+    void ObserveStep(double t, const STATE& rValues)
+    {
+        if (mIndex % mStride == 0)
+        {
+            mTimeTrace.push_back(t);
+            mSolutionTrace.push_back(rValues);
+        }
+        mLastIndex = mIndex;
+        mIndex++;
+        mLastTime = t;
+        mLastValues = rValues;
+    }
+
+    /** Returns the index of the next point to be observed */
+    uint64_t Checkpoint()
+    {
+        return mIndex;
+    }
+
+    /**
+     * Carries on counting from the checkpoint, so the same points are kept as in an uninterrupted
+     * solve.  Points kept after the checkpoint (by an interrupted solve with this observer) are
+     * dropped; those before it are kept, so a new observer only has the points from the checkpoint on.
+     */
+    void BeginResume(uint64_t position)
+    {
+        mIndex = position;
+        std::size_t kept = (position + mStride - 1)/mStride;
+        if (mTimeTrace.size() > kept)
+        {
+            mTimeTrace.resize(kept);
+            mSolutionTrace.resize(kept);
+        }
+    }
+
+    void EndSolve()
+    {
+        if (mIndex > 0 && mLastIndex == mIndex - 1 && mLastIndex % mStride != 0)
+        {
+            mTimeTrace.push_back(mLastTime);
+            mSolutionTrace.push_back(mLastValues);
+        }
+    }
+
+    const std::vector<double>& GetTimeTrace() const
+    {
+        return mTimeTrace;
+    }
+
+    const std::vector<STATE>& GetSolutionTrace() const
+    {
+        return mSolutionTrace;
+    }
+
+    /** Write the kept points in the same format as DumpToFile() */
+    void DumpToFile(const std::string& fileName) const
+    {
+        DumpTraceToFile(fileName, mTimeTrace, mSolutionTrace);
+    }
+};
+
+/**
+ * The smallest and largest value of each component over each of (at most) maximumNumberOfBuckets
+ * consecutive runs of time-points.  The number of steps doesn't need to be known in advance: the
+ * buckets start with one point each and neighbours are merged as they fill up, so there are
+ * between maximumNumberOfBuckets/2 and maximumNumberOfBuckets buckets of equal size at the end
+ * (the last may be partly filled, and an odd maximum is rounded down).  Memory use is bounded by the number of buckets.
+ */
+template<class STATE>
+class EnvelopeObserverT: public AbstractOdeObserverT<STATE>
+{
+private:
+    struct Bucket
+    {
+        double startTime;
+        double endTime;
+        STATE minimumValues;
+        STATE maximumValues;
+
+        void Merge(const Bucket& rNext)
+        {
+            endTime = rNext.endTime;
+            for (int j=0; j<STATE::DIMENSION; j++)
+            {
+                minimumValues[j] = std::min(minimumValues[j], rNext.minimumValues[j]);
+                maximumValues[j] = std::max(maximumValues[j], rNext.maximumValues[j]);
+            }
+        }
+    };
+
+    std::size_t mMaximumNumberOfBuckets;
+    /** Points in every full bucket */
+    long mPointsPerBucket;
+    /** Points in the last bucket so far */
+    long mPointsInLastBucket;
+    std::vector<Bucket> mBuckets;
+
+public:
+    EnvelopeObserverT(int maximumNumberOfBuckets)
+        : mPointsPerBucket(1),
+          mPointsInLastBucket(0)
+    {
+        if (maximumNumberOfBuckets < 2)
+        {
+            throw Exception("OdeSetup", "There should be at least two buckets");
+        }
+        // An even number, so that all the buckets pair up when they are merged
+        mMaximumNumberOfBuckets = maximumNumberOfBuckets - maximumNumberOfBuckets%2;
+        mBuckets.reserve(mMaximumNumberOfBuckets + 1);
+    }
+
+    void BeginSolve()
+    {
+        mPointsPerBucket = 1;
+        mPointsInLastBucket = 0;
+        mBuckets.clear();
+    }
+
+    void ObserveStep(double t, const STATE& rValues)
+    {
+        if (mPointsInLastBucket > 0 && mPointsInLastBucket < mPointsPerBucket)
+        {
+            Bucket point = {t, t, rValues, rValues};
+            mBuckets.back().Merge(point);
+            mPointsInLastBucket++;
+            return;
+        }
+        if (mBuckets.size() == mMaximumNumberOfBuckets)
+        {
+            mPointsPerBucket = MergeBucketPairs(mBuckets, mPointsPerBucket);
+        }
+        Bucket bucket = {t, t, rValues, rValues};
+        mBuckets.push_back(bucket);
+        mPointsInLastBucket = 1;
+    }
+
+    /** Number of buckets in the last solve */
+    std::size_t GetNumberOfBuckets() const
+    {
+        return mBuckets.size();
+    }
+
+    /** Number of time-points in each bucket (except perhaps the last) */
+    long GetPointsPerBucket() const
+    {
+        return mPointsPerBucket;
+    }
+
+    /** First and last time in bucket i */
+    double GetStartTime(std::size_t i) const
+    {
+        return mBuckets.at(i).startTime;
+    }
+    double GetEndTime(std::size_t i) const
+    {
+        return mBuckets.at(i).endTime;
+    }
+
+    /** Smallest and largest value of each component in bucket i */
+    const STATE& GetMinimumValues(std::size_t i) const
+    {
+        return mBuckets.at(i).minimumValues;
+    }
+    const STATE& GetMaximumValues(std::size_t i) const
+    {
+        return mBuckets.at(i).maximumValues;
+    }
+
+    /**
+     * Write one row per bucket:
+     * start-time     end-time     x-minimum     x-maximum     y-minimum     y-maximum ...
+     */
+    void DumpToFile(const std::string& fileName) const
+    {
+        TextTraceWriter write_output(fileName, 2*STATE::DIMENSION + 2);
+        double row[2*STATE::DIMENSION + 2];
+        for (std::size_t i=0; i<mBuckets.size(); i++)
+        {
+            row[0] = mBuckets[i].startTime;
+            row[1] = mBuckets[i].endTime;
+            for (int j=0; j<STATE::DIMENSION; j++)
+            {
+                row[2*j + 2] = mBuckets[i].minimumValues[j];
+                row[2*j + 3] = mBuckets[i].maximumValues[j];
+            }
+            write_output.WriteRow(row);
+        }
+        write_output.Close();
+    }
+};
+
+/**
+ * Largest-triangle-three-buckets downsampling to (at most) numberOfPoints of the calculated
+ * time-points, chosen to keep the shape of the curves when they are plotted.  The first and last
+ * points are always kept.
+ *
+ * LTTB needs the whole trace, so during the solve only candidates are kept: in each of a bounded
+ * number of buckets (merged as they fill up, as in EnvelopeObserverT) the first point and the
+ * points where each component is smallest and largest.  At the end of the solve LTTB chooses from
+ * the candidates, so memory use is bounded by a multiple of numberOfPoints.  The triangle areas
+ * are added up over the components, each scaled by its range.
+ */
+template<class STATE>
+class LttbObserverT: public AbstractOdeObserverT<STATE>
+{
+private:
+    struct Point
+    {
+        /** Position in the solve, to put the candidates in order */
+        long index;
+        double time;
+        STATE values;
+    };
+
+    struct Bucket
+    {
+        Point first;
+        Point minima[STATE::DIMENSION];
+        Point maxima[STATE::DIMENSION];
+
+        void Add(const Point& rPoint)
+        {
+            for (int j=0; j<STATE::DIMENSION; j++)
+            {
+                if (rPoint.values[j] < minima[j].values[j])
+                {
+                    minima[j] = rPoint;
+                }
+                if (rPoint.values[j] > maxima[j].values[j])
+                {
+                    maxima[j] = rPoint;
+                }
+            }
+        }
+
+        void Merge(const Bucket& rNext)
+        {
+            for (int j=0; j<STATE::DIMENSION; j++)
+            {
+                if (rNext.minima[j].values[j] < minima[j].values[j])
+                {
+                    minima[j] = rNext.minima[j];
+                }
+                if (rNext.maxima[j].values[j] > maxima[j].values[j])
+                {
+                    maxima[j] = rNext.maxima[j];
+                }
+            }
+        }
+    };
+
+    std::size_t mNumberOfPoints;
+    long mPointsPerBucket;
+    long mPointsInLastBucket;
+    std::vector<Bucket> mBuckets;
+    /** The most recent point, which is the last one once the solve is finished */
+    Point mLastPoint;
+    /** Number of points observed */
+    long mNumberOfObservations;
+
+    std::vector<double> mTimeTrace;
+    std::vector<STATE> mSolutionTrace;
+
+    static Bucket MakeBucket(const Point& rPoint)
+    {
+        Bucket bucket;
+        bucket.first = rPoint;
+        for (int j=0; j<STATE::DIMENSION; j++)
+        {
+            bucket.minima[j] = rPoint;
+            bucket.maxima[j] = rPoint;
+        }
+        return bucket;
+    }
+
+    /** The candidates in time order (without repeats), finishing with the last point */
+    std::vector<Point> GetCandidates() const
+    {
+        std::vector<Point> candidates;
+        candidates.reserve(mBuckets.size()*(2*STATE::DIMENSION + 1) + 1);
+        for (std::size_t i=0; i<mBuckets.size(); i++)
+        {
+            std::size_t start = candidates.size();
+            candidates.push_back(mBuckets[i].first);
+            for (int j=0; j<STATE::DIMENSION; j++)
+            {
+                candidates.push_back(mBuckets[i].minima[j]);
+                candidates.push_back(mBuckets[i].maxima[j]);
+            }
+            // The buckets are in time order, so only the points within each need sorting
+            std::sort(candidates.begin() + start, candidates.end(),
+                      [](const Point& rA, const Point& rB) { return rA.index < rB.index; });
+        }
+        candidates.push_back(mLastPoint);
+        std::vector<Point> unique_candidates;
+        unique_candidates.reserve(candidates.size());
+        for (std::size_t i=0; i<candidates.size(); i++)
+        {
+            if (unique_candidates.empty() || unique_candidates.back().index != candidates[i].index)
+            {
+                unique_candidates.push_back(candidates[i]);
+            }
+        }
+        return unique_candidates;
+    }
+
+public:
+    LttbObserverT(int numberOfPoints)
+        : mPointsPerBucket(1),
+          mPointsInLastBucket(0),
+          mNumberOfObservations(0)
+    {
+        if (numberOfPoints < 3)
+        {
+            throw Exception("OdeSetup", "There should be at least three points");
+        }
+        mNumberOfPoints = numberOfPoints;
+    }
+
+    void BeginSolve()
+    {
+        mPointsPerBucket = 1;
+        mPointsInLastBucket = 0;
+        mNumberOfObservations = 0;
+        mBuckets.clear();
+        mTimeTrace.clear();
+        mSolutionTrace.clear();
+    }
+
+    void ObserveStep(double t, const STATE& rValues)
+    {
+        Point point = {mNumberOfObservations++, t, rValues};
+        mLastPoint = point;
+        if (mPointsInLastBucket > 0 && mPointsInLastBucket < mPointsPerBucket)
+        {
+            mBuckets.back().Add(point);
+            mPointsInLastBucket++;
+            return;
+        }
+        // Twice as many candidate buckets as points, so that LTTB has a choice in every bucket
+        if (mBuckets.size() == 2*mNumberOfPoints)
+        {
+            mPointsPerBucket = MergeBucketPairs(mBuckets, mPointsPerBucket);
+        }
+        mBuckets.push_back(MakeBucket(point));
+        mPointsInLastBucket = 1;
+    }
+
+    /** Chooses the points from the candidates */
+    void EndSolve()
+    {
+        if (mNumberOfObservations == 0)
+        {
+            return;
+        }
+        std::vector<Point> candidates = GetCandidates();
+        mTimeTrace.clear();
+        mSolutionTrace.clear();
+        const std::size_t size = candidates.size();
+        if (size <= mNumberOfPoints)
+        {
+            for (std::size_t i=0; i<size; i++)
+            {
+                mTimeTrace.push_back(candidates[i].time);
+                mSolutionTrace.push_back(candidates[i].values);
+            }
+            return;
+        }
+
+        // Scale each component by its range so that they all count
+        STATE scale;
+        for (int j=0; j<STATE::DIMENSION; j++)
+        {
+            double minimum = candidates[0].values[j], maximum = candidates[0].values[j];
+            for (std::size_t i=1; i<size; i++)
+            {
+                minimum = std::min(minimum, candidates[i].values[j]);
+                maximum = std::max(maximum, candidates[i].values[j]);
+            }
+            scale[j] = (maximum > minimum) ? 1.0/(maximum - minimum) : 0.0;
+        }
+
+        // The first and last points are kept, and the rest are split into numberOfPoints-2 buckets
+        mTimeTrace.reserve(mNumberOfPoints);
+        mSolutionTrace.reserve(mNumberOfPoints);
+        mTimeTrace.push_back(candidates[0].time);
+        mSolutionTrace.push_back(candidates[0].values);
+        std::size_t selected = 0;
+        const double bucket_size = double(size - 2)/double(mNumberOfPoints - 2);
+        for (std::size_t b=0; b<mNumberOfPoints - 2; b++)
+        {
+            std::size_t start = 1 + std::size_t(b*bucket_size);
+            std::size_t end = 1 + std::size_t((b + 1)*bucket_size);
+            std::size_t next_end = std::min(size, 1 + std::size_t((b + 2)*bucket_size));
+            if (b + 1 == mNumberOfPoints - 2)
+            {
+                // The last point is the next bucket
+                end = size - 1;
+                next_end = size;
+            }
+
+            // Average of the next bucket
+            double average_time = 0.0;
+            STATE average = STATE();
+            for (std::size_t i=end; i<next_end; i++)
+            {
+                average_time += candidates[i].time;
+                average += candidates[i].values;
+            }
+            average_time /= double(next_end - end);
+            average = average/double(next_end - end);
+
+            // The point making the largest triangle with the last one chosen and the average
+            const Point& r_previous = candidates[selected];
+            double largest_area = -1.0;
+            std::size_t chosen = start;
+            for (std::size_t i=start; i<end; i++)
+            {
+                double area = 0.0;
+                for (int j=0; j<STATE::DIMENSION; j++)
+                {
+                    area += scale[j]*fabs((r_previous.time - average_time)*(candidates[i].values[j] - r_previous.values[j])
+                                          - (r_previous.time - candidates[i].time)*(average[j] - r_previous.values[j]));
+                }
+                if (area > largest_area)
+                {
+                    largest_area = area;
+                    chosen = i;
+                }
+            }
+            selected = chosen;
+            mTimeTrace.push_back(candidates[selected].time);
+            mSolutionTrace.push_back(candidates[selected].values);
+        }
+        mTimeTrace.push_back(candidates.back().time);
+        mSolutionTrace.push_back(candidates.back().values);
+    }
+
+    const std::vector<double>& GetTimeTrace() const
+    {
+        return mTimeTrace;
+    }
+
+    const std::vector<STATE>& GetSolutionTrace() const
+    {
+        return mSolutionTrace;
+    }
+
+    /** Write the chosen points in the same format as DumpToFile() */
+    void DumpToFile(const std::string& fileName) const
+    {
+        DumpTraceToFile(fileName, mTimeTrace, mSolutionTrace);
+    }
+};
+
+/**
+ * Writes every time-point to a file as it is calculated, in the same format as DumpToFile().
+ * In background mode the formatting and writing happen on another thread while the solver carries on.
+ * At a checkpoint the file is flushed to disk, and a resumed solve cuts it back to that length and
+ * appends to it.
+ */
+template<class STATE>
+class FileStreamObserverT: public AbstractOdeObserverT<STATE>
+{
+private:
+    std::string mFileName;
+    bool mBackground;
+    std::unique_ptr<TextTraceWriter> mpWriter;
+
+public:
+    FileStreamObserverT(const std::string& fileName, bool background=false)
+        : mFileName(fileName),
+          mBackground(background)
+    {}
+
+    /** Opens (and truncates) the file.  Throws if it can't be opened */
+    void BeginSolve()
+    {
+        mpWriter.reset(); // Finish off any earlier (interrupted) solve
+        mpWriter.reset(new TextTraceWriter(mFileName, STATE::DIMENSION + 1, mBackground));
+    }
+
+    /** Carries on writing at the end of the file as it was at the checkpoint */
+    void BeginResume(uint64_t position)
+    {
+        mpWriter.reset();
+        mpWriter.reset(new TextTraceWriter(mFileName, STATE::DIMENSION + 1, mBackground, position));
+    }
+
+    void ObserveStep(double t, const STATE& rValues)
+    {
+        WriteTraceRow(*mpWriter, t, rValues);
+    }
+
+    /** Writes out the rows so far, returning the length of the file */
+    uint64_t Checkpoint()
+    {
+        return mpWriter->Flush();
+    }
+
+    /** Waits for the file to be written.  Throws if it couldn't be */
+    void EndSolve()
+    {
+        mpWriter->Close();
+        mpWriter.reset();
+    }
+};
+
+#endif /* ODEOBSERVERS_HPP_ */
@@ -0,0 +1,201 @@
+/*
+ * OdeStepper.hpp
+ *
+ * Pull-based integration: advance a fixed-step solve one step (or a few) at a time
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef ODESTEPPER_HPP_
+#define ODESTEPPER_HPP_
+
+#include <cstddef>
+#include <iterator>
+#include <stdint.h>
+
+/** A time-point of a solve and the solution there */
+template<class STATE>
+struct OdePointT
+{
+    double time;
+    STATE values;
+};
+
+/**
+ * Integrates a fixed-step problem incrementally, for callers that want each step as soon as it is
+ * taken (interactive tools, pipelines) rather than after Solve() has finished.  Get one from the
+ * solver's GetStepper(): it starts at the initial values and takes the solver's steps, through the
+ * same time-points as Solve(), whenever Step() or Advance() asks for them.
+ *
+ * Only the current point is kept: there is no trace, and a step costs exactly what it costs inside
+ * Solve(), with the stages on the stack and nothing allocated.  Observers, events, dense output,
+ * checkpoints and stats belong to Solve() and are not used.  The stepper refers to the solver for
+ * its steps, so the solver must outlive it; the setup (times, steps, initial values) is copied when
+ * the stepper is made, so later changes to the solver don't affect it.
+ *
+ * The stepper is also a lazy range of OdePointT<STATE>, from the current point to the end time:
+ *     for (const auto& point : stepper) { ... point.time ... point.values ... }
+ * Each increment of the iterator takes one step.  Leaving the loop early leaves the stepper where
+ * it got to, so a later loop (or Step()) carries on from there.
+ */
+template<class SOLVER, class RHS>
+class OdeStepperT
+{
+public:
+    typedef typename SOLVER::StateType StateType;
+    typedef OdePointT<StateType> PointType;
+
+    /** Single-pass iterator over the points, from the current one to the end */
+    class iterator
+    {
+    private:
+        OdeStepperT* mpStepper;
+        /** Set once we have gone past the last point (and always for end()) */
+        bool mPastEnd;
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef PointType value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const PointType* pointer;
+        typedef const PointType& reference;
+
+        iterator(OdeStepperT* pStepper, bool pastEnd) : mpStepper(pStepper), mPastEnd(pastEnd) {}
+        const PointType& operator*() const { return mpStepper->GetPoint(); }
+        const PointType* operator->() const { return &mpStepper->GetPoint(); }
+        iterator& operator++()
+        {
+            mPastEnd = !mpStepper->Step();
+            return *this;
+        }
+        bool operator==(const iterator& rOther) const { return mPastEnd == rOther.mPastEnd; }
+        bool operator!=(const iterator& rOther) const { return mPastEnd != rOther.mPastEnd; }
+    };
+
+private:
+    /** The solver which takes the steps, and the right-hand side it takes them with */
+    const SOLVER& mrSolver;
+    RHS mRhs;
+
+    /** The solver's setup when the stepper was made */
+    double mStartTime;
+    double mTimeStepSize;
+    int64_t mNumberOfTimeSteps;
+    StateType mInitialValues;
+
+    /** Where we have got to: step mStepIndex, at mPoint */
+    int64_t mStepIndex;
+    PointType mPoint;
+
+    /** Time-point stepIndex, worked out as the solver's GetStepTime() does */
+    double GetStepTime(int64_t stepIndex) const
+    {
+        typedef typename StateType::TimeType TIME;
+        return TIME(mStartTime) + TIME(stepIndex)*TIME(mTimeStepSize);
+    }
+
+public:
+    /** Starts at the initial values.  Made by the solvers' GetStepper() methods */
+    OdeStepperT(const SOLVER& rSolver, RHS rhs, double startTime, double timeStepSize, int64_t numberOfTimeSteps,
+                const StateType& rInitialValues)
+        : mrSolver(rSolver),
+          mRhs(rhs),
+          mStartTime(startTime),
+          mTimeStepSize(timeStepSize),
+          mNumberOfTimeSteps(numberOfTimeSteps),
+          mInitialValues(rInitialValues)
+    {
+        Reset();
+    }
+
+    /** Go back to the initial values at the start time */
+    void Reset()
+    {
+        mStepIndex = 0;
+        mPoint.time = mStartTime;
+        mPoint.values = mInitialValues;
+    }
+
+    /** Takes one step.  Returns false (and does nothing) if we are already at the end time */
+    bool Step()
+    {
+        if (mStepIndex >= mNumberOfTimeSteps)
+        {
+            return false;
+        }
+        mrSolver.TakeStep(mRhs, mPoint.time, mTimeStepSize, mPoint.values);
+        mStepIndex++;
+        mPoint.time = GetStepTime(mStepIndex);
+        return true;
+    }
+
+    /** Takes up to steps steps, stopping at the end time.  Returns the number taken */
+    int64_t Advance(int64_t steps)
+    {
+        const int64_t last_step = (steps < GetNumberOfRemainingSteps()) ? mStepIndex + steps : mNumberOfTimeSteps;
+        const int64_t first_step = mStepIndex;
+        for (; mStepIndex < last_step; mStepIndex++)
+        {
+            mrSolver.TakeStep(mRhs, mPoint.time, mTimeStepSize, mPoint.values);
+            mPoint.time = GetStepTime(mStepIndex + 1);
+        }
+        return (last_step > first_step) ? last_step - first_step : 0;
+    }
+
+    /** Takes the remaining steps to the end time */
+    void AdvanceToEnd()
+    {
+        Advance(GetNumberOfRemainingSteps());
+    }
+
+    /** The current time and solution */
+    const PointType& GetPoint() const
+    {
+        return mPoint;
+    }
+
+    double GetTime() const
+    {
+        return mPoint.time;
+    }
+
+    const StateType& GetValues() const
+    {
+        return mPoint.values;
+    }
+
+    /** Number of steps taken since the start, and in all */
+    int64_t GetStepIndex() const
+    {
+        return mStepIndex;
+    }
+
+    int64_t GetNumberOfTimeSteps() const
+    {
+        return mNumberOfTimeSteps;
+    }
+
+    int64_t GetNumberOfRemainingSteps() const
+    {
+        return mNumberOfTimeSteps - mStepIndex;
+    }
+
+    /** Whether we have reached the end time */
+    bool IsFinished() const
+    {
+        return mStepIndex >= mNumberOfTimeSteps;
+    }
+
+    /** The lazy range of points: the current point first, then one per step */
+    iterator begin()
+    {
+        return iterator(this, false);
+    }
+
+    iterator end()
+    {
+        return iterator(this, true);
+    }
+};
+
+#endif /* ODESTEPPER_HPP_ */
@@ -0,0 +1,320 @@
+/*
+ * PagedTrace.hpp
+ *
+ * A trace stored as a list of fixed-size pages, for very long solves
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef PAGEDTRACE_HPP_
+#define PAGEDTRACE_HPP_
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Exception.hpp"
+
+/**
+ * A sequence of values (of type T, e.g. double or a state) kept in fixed-size pages rather than one
+ * contiguous array.  Appending never moves what is already stored: when the last page is full a new
+ * one is started, so growing costs one page allocation (or none, if a page from before the last
+ * Clear() can be reused) and never copies the trace, and a trace of n values needs n values of
+ * memory plus at most one page.  Positions are 64-bit, so there is no limit of 2^31 entries.
+ *
+ * With a spill file, each page is written to the file as soon as it is full and its memory is used
+ * again for the next page, so only the page being filled stays in memory however long the trace
+ * gets.  Reading a spilled value reads its whole page back into a one-page cache.  The spill file
+ * is deleted by Clear() and by the destructor.
+ *
+ * Entries are read by value or through a const reference which, for a spilled page, is only valid
+ * until the next read from a different spilled page.
+ */
+template<class T>
+class PagedTraceT
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Paged traces hold plain numbers or states");
+
+public:
+    /** Entries per page unless the constructor says otherwise (512 KB of doubles) */
+    static const std::size_t DEFAULT_PAGE_SIZE = 65536;
+
+    /** Forward iterator over the entries, for range-based for loops and standard algorithms */
+    class const_iterator
+    {
+    private:
+        const PagedTraceT* mpTrace;
+        uint64_t mIndex;
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        const_iterator(const PagedTraceT* pTrace, uint64_t index) : mpTrace(pTrace), mIndex(index) {}
+        const T& operator*() const { return (*mpTrace)[mIndex]; }
+        const T* operator->() const { return &(*mpTrace)[mIndex]; }
+        const_iterator& operator++() { mIndex++; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; mIndex++; return old; }
+        bool operator==(const const_iterator& rOther) const { return mIndex == rOther.mIndex; }
+        bool operator!=(const const_iterator& rOther) const { return mIndex != rOther.mIndex; }
+    };
+
+private:
+    /** Entries per page, a power of two, and its log */
+    std::size_t mPageSize;
+    unsigned mPageShift;
+
+    /** The pages in order.  Pages that have been spilled to the file are NULL */
+    std::vector<std::unique_ptr<T[]> > mPages;
+
+    /** Pages no longer in use (from before a Clear(), or spilled), kept to be used again */
+    std::vector<std::unique_ptr<T[]> > mSparePages;
+
+    /** Number of entries */
+    uint64_t mSize;
+
+    /** Where full pages go (empty for never), the open file, and how many pages it holds */
+    std::string mSpillFileName;
+    mutable std::fstream mSpillFile;
+    uint64_t mNumberOfSpilledPages;
+
+    /** A spilled page read back from the file, and which page it is */
+    mutable std::unique_ptr<T[]> mpLoadedPage;
+    mutable uint64_t mLoadedPageIndex;
+
+    // Not copyable: the spill file is owned
+    PagedTraceT(const PagedTraceT&);
+    PagedTraceT& operator=(const PagedTraceT&);
+
+    /** Makes room for entry mSize, which starts a new page */
+    void StartPage()
+    {
+        if (!mSpillFileName.empty() && !mPages.empty())
+        {
+            SpillPage(mPages.size() - 1);
+        }
+        if (mSparePages.empty())
+        {
+            mPages.push_back(std::unique_ptr<T[]>(new T[mPageSize]));
+        }
+        else
+        {
+            mPages.push_back(std::move(mSparePages.back()));
+            mSparePages.pop_back();
+        }
+    }
+
+    /** Writes a full page to the end of the spill file, and keeps its memory for the next page */
+    void SpillPage(uint64_t page)
+    {
+        if (!mSpillFile.is_open())
+        {
+            mSpillFile.open(mSpillFileName.c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!mSpillFile.is_open())
+            {
+                throw Exception("OdeSolve", "Can't open trace spill file");
+            }
+        }
+        mSpillFile.seekp(std::streamoff(page*GetPageBytes()));
+        mSpillFile.write(reinterpret_cast<const char*>(mPages[page].get()), GetPageBytes());
+        if (mSpillFile.fail())
+        {
+            throw Exception("OdeSolve", "Failed writing trace spill file");
+        }
+        mSparePages.push_back(std::move(mPages[page]));
+        mNumberOfSpilledPages++;
+    }
+
+    /** The entries of a page, reading it back from the spill file if need be */
+    const T* GetPageData(uint64_t page) const
+    {
+        if (mPages[page])
+        {
+            return mPages[page].get();
+        }
+        if (!mpLoadedPage || mLoadedPageIndex != page)
+        {
+            if (!mpLoadedPage)
+            {
+                mpLoadedPage.reset(new T[mPageSize]);
+            }
+            // Written pages must reach the file before they can be read back
+            mSpillFile.flush();
+            mSpillFile.seekg(std::streamoff(page*GetPageBytes()));
+            mSpillFile.read(reinterpret_cast<char*>(mpLoadedPage.get()), GetPageBytes());
+            if (mSpillFile.fail())
+            {
+                mSpillFile.clear();
+                mLoadedPageIndex = UINT64_MAX;
+                throw Exception("OdePost", "Failed reading trace spill file");
+            }
+            mLoadedPageIndex = page;
+        }
+        return mpLoadedPage.get();
+    }
+
+    std::size_t GetPageBytes() const
+    {
+        return mPageSize*sizeof(T);
+    }
+
+    /** Closes and deletes the spill file, if there is one */
+    void RemoveSpillFile()
+    {
+        if (mSpillFile.is_open())
+        {
+            mSpillFile.close();
+            std::remove(mSpillFileName.c_str());
+        }
+        mSpillFile.clear();
+        mNumberOfSpilledPages = 0;
+        mLoadedPageIndex = UINT64_MAX;
+    }
+
+public:
+    /** An empty trace.  Throws unless pageSize is a power of two */
+    explicit PagedTraceT(std::size_t pageSize=DEFAULT_PAGE_SIZE)
+        : mPageSize(pageSize),
+          mPageShift(0),
+          mSize(0),
+          mNumberOfSpilledPages(0),
+          mLoadedPageIndex(UINT64_MAX)
+    {
+        if (pageSize == 0 || (pageSize & (pageSize - 1)) != 0)
+        {
+            throw Exception("OdeSetup", "The page size should be a power of two");
+        }
+        while ((std::size_t(1) << mPageShift) < pageSize)
+        {
+            mPageShift++;
+        }
+    }
+
+    ~PagedTraceT()
+    {
+        RemoveSpillFile();
+    }
+
+    /**
+     * Spill full pages to fileName from now on (an empty name for never).  Clears the trace, since
+     * the pages already stored aren't in the file.
+     */
+    void SetSpillFile(const std::string& fileName)
+    {
+        Clear();
+        mSpillFileName = fileName;
+    }
+
+    /** Appends an entry */
+    void push_back(const T& rValue)
+    {
+        const std::size_t offset = std::size_t(mSize) & (mPageSize - 1);
+        if (offset == 0)
+        {
+            StartPage();
+        }
+        mPages.back()[offset] = rValue;
+        mSize++;
+    }
+
+    /** Entry i (see above for how long the reference lasts) */
+    const T& operator[](uint64_t i) const
+    {
+        return GetPageData(i >> mPageShift)[std::size_t(i) & (mPageSize - 1)];
+    }
+
+    const T& back() const
+    {
+        return (*this)[mSize - 1];
+    }
+
+    uint64_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, mSize); }
+
+    /** Entries per page */
+    std::size_t GetPageSize() const
+    {
+        return mPageSize;
+    }
+
+    /** Number of pages, the last of which may be part full */
+    uint64_t GetNumberOfPages() const
+    {
+        return mPages.size();
+    }
+
+    /** Number of (full) pages that are in the spill file rather than in memory */
+    uint64_t GetNumberOfSpilledPages() const
+    {
+        return mNumberOfSpilledPages;
+    }
+
+    /**
+     * The entries of page p, which are entries p*GetPageSize() onwards, for working through the
+     * trace a page at a time.  A spilled page is only valid until the next read of another one.
+     */
+    const T* GetPage(uint64_t page) const
+    {
+        return GetPageData(page);
+    }
+
+    /** Number of entries in page p */
+    std::size_t GetPageLength(uint64_t page) const
+    {
+        return (page + 1 < mPages.size()) ? mPageSize : std::size_t(mSize - (page << mPageShift));
+    }
+
+    /** Makes room in the list of pages for a trace of size entries (the pages are allocated as they are needed) */
+    void reserve(uint64_t size)
+    {
+        mPages.reserve(std::size_t((size + mPageSize - 1) >> mPageShift));
+    }
+
+    /** Empties the trace, keeping the pages in memory for the next one */
+    void Clear()
+    {
+        for (std::size_t p=0; p<mPages.size(); p++)
+        {
+            if (mPages[p])
+            {
+                mSparePages.push_back(std::move(mPages[p]));
+            }
+        }
+        mPages.clear();
+        mSize = 0;
+        RemoveSpillFile();
+    }
+
+    /** Empties the trace and gives back all of its memory */
+    void ReleaseMemory()
+    {
+        Clear();
+        std::vector<std::unique_ptr<T[]> >().swap(mPages);
+        std::vector<std::unique_ptr<T[]> >().swap(mSparePages);
+        mpLoadedPage.reset();
+    }
+
+    /** Memory held in pages (including spare ones and the spilled page cache) and the list of pages */
+    std::size_t GetCapacityBytes() const
+    {
+        std::size_t pages = mSparePages.size() + (mpLoadedPage ? 1 : 0);
+        for (std::size_t p=0; p<mPages.size(); p++)
+        {
+            pages += mPages[p] ? 1 : 0;
+        }
+        return pages*GetPageBytes() + mPages.capacity()*sizeof(mPages[0]);
+    }
+};
+
+#endif /* PAGEDTRACE_HPP_ */
@@ -0,0 +1,177 @@
+/*
+ * ParameterSweep.hpp
+ *
+ * Runs one solver over a grid of parameter values and initial conditions, in parallel
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef PARAMETERSWEEP_HPP_
+#define PARAMETERSWEEP_HPP_
+
+#include <vector>
+#include "AbstractOdeSolver.hpp"
+#include "ThreadPool.hpp"
+
+/** One point of a sweep: a parameter value (e.g. Van der Pol mu) and the initial conditions */
+template<class STATE>
+struct SweepPointT
+{
+    double parameter;
+    STATE initialValues;
+};
+
+/** Summary of one solve in a sweep, and its trace if traces are being kept */
+template<class STATE>
+struct SweepResultT
+{
+    SweepPointT<STATE> point;
+    /** Number of time-points (including the initial values) */
+    long numberOfTimePoints;
+    double finalTime;
+    STATE finalValues;
+    /** Smallest and largest value of each component over the solve */
+    STATE minimumValues;
+    STATE maximumValues;
+    /** Only filled when SetKeepTraces(true) */
+    SolutionTraceT<STATE> trace;
+};
+
+/** Every combination of the parameters and the initial conditions (parameters varying slowest) */
+template<class STATE>
+std::vector<SweepPointT<STATE> > MakeSweepGrid(const std::vector<double>& rParameters,
+                                               const std::vector<STATE>& rInitialValues)
+{
+    std::vector<SweepPointT<STATE> > grid;
+    grid.reserve(rParameters.size()*rInitialValues.size());
+    for (unsigned i=0; i<rParameters.size(); i++)
+    {
+        for (unsigned j=0; j<rInitialValues.size(); j++)
+        {
+            SweepPointT<STATE> point = {rParameters[i], rInitialValues[j]};
+            grid.push_back(point);
+        }
+    }
+    return grid;
+}
+
+/**
+ * Solves the same parameterised ODE at every point of a grid, with the solver type chosen by the
+ * template argument (e.g. ParameterSweep<RK4Solver>; any solver with a Solve(rhs) method will do).
+ * Each point gets its own solver and the results are stored by grid index, so they are identical
+ * whatever the number of threads.
+ */
+template<class SOLVER>
+class ParameterSweep
+{
+public:
+    typedef typename SOLVER::StateType STATE;
+
+private:
+    std::vector<SweepPointT<STATE> > mGrid;
+    std::vector<SweepResultT<STATE> > mResults;
+
+    double mStartTime;
+    int64_t mNumberOfTimeSteps;
+    double mEndTime;
+
+    /** Number of threads to use (zero for one per core) */
+    unsigned mNumberOfThreads;
+    bool mKeepTraces;
+
+public:
+    ParameterSweep()
+        : mStartTime(0.0),
+          mNumberOfTimeSteps(-1),
+          mEndTime(0.0),
+          mNumberOfThreads(0),
+          mKeepTraces(false)
+    {}
+
+    void SetGrid(const std::vector<SweepPointT<STATE> >& rGrid)
+    {
+        mGrid = rGrid;
+    }
+
+    /** The time set-up given to every solver (see AbstractOdeSolverT) */
+    void SetInitialTimeNumberOfStepsAndFinalTime(double startTime, int64_t steps, double endTime)
+    {
+        if (steps <= 0)
+        {
+            throw Exception("OdeSetup", "Number of time steps should be positive");
+        }
+        mStartTime = startTime;
+        mNumberOfTimeSteps = steps;
+        mEndTime = endTime;
+    }
+
+    /** Zero (the default) means one thread per core */
+    void SetNumberOfThreads(unsigned numberOfThreads)
+    {
+        mNumberOfThreads = numberOfThreads;
+    }
+
+    /** Keep every solve's full trace in the results, rather than just the summary */
+    void SetKeepTraces(bool keepTraces)
+    {
+        mKeepTraces = keepTraces;
+    }
+
+    /**
+     * Runs the sweep.  rhs(parameter, v, t, dvdt) is the right-hand side: it is called from several
+     * threads at once so it mustn't change any shared state.  Throws (after all the solves have
+     * finished) if any solve threw.
+     */
+    template<class RHS>
+    void Run(const RHS& rRhs)
+    {
+        if (mGrid.empty())
+        {
+            throw Exception("OdeSetup", "The sweep grid is empty");
+        }
+        if (mNumberOfTimeSteps <= 0)
+        {
+            throw Exception("OdeSetup", "Please set the sweep's time interval");
+        }
+        mResults.assign(mGrid.size(), SweepResultT<STATE>());
+
+        WorkStealingThreadPool pool(mNumberOfThreads);
+        pool.ParallelFor(mGrid.size(), [&](std::size_t i)
+        {
+            const SweepPointT<STATE>& r_point = mGrid[i];
+            SOLVER solver;
+            solver.SetInitialValues(r_point.initialValues);
+            solver.SetInitialTimeNumberOfStepsAndFinalTime(mStartTime, mNumberOfTimeSteps, mEndTime);
+            solver.SetStoreTrace(mKeepTraces);
+            RangeObserverT<STATE> range;
+            solver.AddObserver(&range);
+
+            const double parameter = r_point.parameter;
+            solver.Solve([&rRhs, parameter](const STATE& v, double t, STATE& dvdt)
+            {
+                rRhs(parameter, v, t, dvdt);
+            });
+
+            SweepResultT<STATE>& r_result = mResults[i];
+            r_result.point = r_point;
+            r_result.numberOfTimePoints = range.GetNumberOfObservations();
+            r_result.finalTime = range.GetFinalTime();
+            r_result.finalValues = range.GetFinalValues();
+            r_result.minimumValues = range.GetMinimumValues();
+            r_result.maximumValues = range.GetMaximumValues();
+            if (mKeepTraces)
+            {
+                r_result.trace = solver.TakeTrace();
+            }
+        });
+    }
+
+    /** One result per grid point, in grid order */
+    const std::vector<SweepResultT<STATE> >& GetResults() const
+    {
+        return mResults;
+    }
+};
+
+#endif /* PARAMETERSWEEP_HPP_ */
@@ -1,6 +1,8 @@
 /*
  * RK4SOLVER_HPP_.hpp
  *
+ * Implements the classical fourth order Runge-Kutta solver
+ *
  *  Created on: 25 Oct 2017
  *      Author: adathy
  */
@@ -8,13 +10,15 @@
 #ifndef RK4SOLVER_HPP_
 #define RK4SOLVER_HPP_
 
-#include "AbstractOdeSolver.hpp"
+#include "ExplicitRungeKuttaOdeSolver.hpp"
+
+/** The classical fourth order Runge-Kutta solver, from its Butcher tableau */
+template<class STATE>
+using RK4SolverT = ExplicitRungeKuttaOdeSolverT<STATE, RungeKutta4Tableau>;
 
-class RK4Solver: public AbstractOdeSolver {
-public:
-	RK4Solver();
-	virtual ~RK4Solver();
-	void Solve();
-};
+/** The original 2-D solver */
+typedef RK4SolverT<Pair> RK4Solver;
+// Compiled once in RK4Solver.cpp
+extern template class ExplicitRungeKuttaOdeSolverT<Pair, RungeKutta4Tableau>;
 
 #endif /* RK4SOLVER_HPP_ */
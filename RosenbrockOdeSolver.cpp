@@ -0,0 +1,13 @@
+/*
+ * RosenbrockOdeSolver.cpp
+ *
+ * Implements the second order Rosenbrock (ROS2) solver for stiff problems
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include "RosenbrockOdeSolver.hpp"
+
+// The methods are templates defined in the header.  The 2-D (Pair) version is compiled here once.
+template class RosenbrockOdeSolverT<Pair>;
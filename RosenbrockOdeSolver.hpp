@@ -0,0 +1,113 @@
+/*
+ * RosenbrockOdeSolver.hpp
+ *
+ * Implements the second order Rosenbrock (ROS2) solver for stiff problems
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef ROSENBROCKODESOLVER_HPP_
+#define ROSENBROCKODESOLVER_HPP_
+
+#include "AbstractImplicitOdeSolver.hpp"
+
+/**
+ * Two stage, second order Rosenbrock method ROS2 (Verwer, Spee, Blom & Hundsdorfer, 1999):
+ *     (I - gamma dt J) k1 = f(t_n, v_n)
+ *     (I - gamma dt J) k2 = f(t_{n+1}, v_n + dt k1) - 2 k1
+ *     v_{n+1} = v_n + 3/2 dt k1 + 1/2 dt k2,        gamma = 1 + 1/sqrt(2)
+ * This is linearly implicit: there is no Newton iteration, just two solves with one factorisation.
+ * L-stable.  It stays second order with an approximate J (so any time dependence of the right-hand
+ * side is left out of it), but with no Newton iteration to notice a stale Jacobian it is evaluated
+ * every step by default.  SetMaximumJacobianAge() allows reuse on slowly varying problems.
+ */
+template<class STATE>
+class RosenbrockOdeSolverT: public AbstractImplicitOdeSolverT<STATE> {
+public:
+	RosenbrockOdeSolverT();
+	virtual ~RosenbrockOdeSolverT();
+
+	std::string GetSolverName() const {
+		return "Rosenbrock2";
+	}
+
+	/**
+	 * Solve with the function pointers set by SetRhsFunction() and (if it was called)
+	 * SetJacobianFunction().  Without a Jacobian function, finite differences are used.
+	 */
+	void Solve();
+
+	/** Solve with any callable right-hand side rhs(v, t, dvdt), using a finite difference Jacobian */
+	template<class RHS>
+	void Solve(RHS rhs);
+
+	/**
+	 * Solve with any callable right-hand side and Jacobian jacobian(v, t, J).  Pass
+	 * FiniteDifferenceJacobian() as the Jacobian to use finite differences.
+	 */
+	template<class RHS, class JACOBIAN>
+	void Solve(RHS rhs, JACOBIAN jacobian);
+
+	/** Advance v over one time step from time t to t+dt */
+	template<class RHS, class JACOBIAN>
+	void TakeStep(RHS& rRhs, JACOBIAN& rJacobian, double t, double dt, STATE& v);
+};
+
+template<class STATE>
+RosenbrockOdeSolverT<STATE>::RosenbrockOdeSolverT() {
+	// Nothing checks the stages, so an old Jacobian is only safe once the problem is known to be smooth
+	this->mMaximumJacobianAge = 1;
+}
+
+template<class STATE>
+RosenbrockOdeSolverT<STATE>::~RosenbrockOdeSolverT() {
+}
+
+template<class STATE>
+void RosenbrockOdeSolverT<STATE>::Solve() {
+	if (this->mpRhsFunction == NULL) {
+		throw Exception("OdeSolve", "Please define the right hand side function");
+	}
+	if (this->mpJacobianFunction != NULL) {
+		Solve(this->mpRhsFunction, this->mpJacobianFunction);
+	}
+	else {
+		Solve(this->mpRhsFunction);
+	}
+}
+
+template<class STATE>
+template<class RHS>
+void RosenbrockOdeSolverT<STATE>::Solve(RHS rhs) {
+	Solve(rhs, FiniteDifferenceJacobian());
+}
+
+template<class STATE>
+template<class RHS, class JACOBIAN>
+void RosenbrockOdeSolverT<STATE>::Solve(RHS rhs, JACOBIAN jacobian) {
+	this->RunImplicitTimeSteps(*this, rhs, jacobian);
+}
+
+template<class STATE>
+template<class RHS, class JACOBIAN>
+void RosenbrockOdeSolverT<STATE>::TakeStep(RHS& rRhs, JACOBIAN& rJacobian, double t, double dt, STATE& v) {
+	const double gamma = 1.0 + 1.0/sqrt(2.0);
+	this->UpdateJacobian(rRhs, rJacobian, t, v);
+	this->FactoriseIterationMatrix(gamma*dt);
+
+	STATE k1, k2;
+	rRhs(v, t, k1);
+	this->mIterationMatrix.Solve(k1);
+	rRhs(STATE(v + k1*dt), t + dt, k2);
+	k2 -= k1*2.0;
+	this->mIterationMatrix.Solve(k2);
+	v += (k1*1.5 + k2*0.5)*dt;
+}
+
+/** The 2-D solver */
+typedef RosenbrockOdeSolverT<Pair> RosenbrockOdeSolver;
+// Compiled once in RosenbrockOdeSolver.cpp
+extern template class RosenbrockOdeSolverT<Pair>;
+
+#endif /* ROSENBROCKODESOLVER_HPP_ */
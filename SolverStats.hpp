@@ -0,0 +1,194 @@
+/*
+ * SolverStats.hpp
+ *
+ * Per-solve instrumentation: right-hand side evaluations, steps, phase timings and trace memory
+ *
+ * Compiled in by default.  Build everything with -DODE_DISABLE_STATS to remove it: the recording
+ * calls are then empty inline functions and GetStats() reports enabled == false.
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef SOLVERSTATS_HPP_
+#define SOLVERSTATS_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * What the last solve did, returned by AbstractOdeSolverT::GetStats().  Everything is reset at the
+ * start of each solve, except outputSeconds which covers the DumpToFile()/DumpToBinaryFile() calls
+ * since then.
+ */
+struct SolverStats
+{
+    /** False if the instrumentation was compiled out (everything else is then zero) */
+    bool enabled;
+    /**
+     * Right-hand side evaluations (for an ensemble, one per member; for a large system, one per
+     * evaluation of the whole system)
+     */
+    unsigned long long rhsEvaluations;
+    /** Accepted steps */
+    unsigned long long stepsTaken;
+    /** Clearing and reserving the traces before the first step */
+    double setupSeconds;
+    /** The steps themselves, including recording the traces and calling the observers */
+    double integrateSeconds;
+    /** Writing the stored trace out to files */
+    double outputSeconds;
+    /**
+     * Most memory held by the stored traces during the solve, counting both the old and the new
+     * block while a trace is reallocated
+     */
+    std::size_t peakTraceBytes;
+    /** Number of times the traces were full and had to be reallocated to record a time-point */
+    unsigned long long traceReallocations;
+};
+
+#ifndef ODE_DISABLE_STATS
+
+/**
+ * Fills in a SolverStats as a solve goes.  The solver calls BeginSolve(), BeginIntegration() (after
+ * the initial values are recorded) and EndIntegration(); output calls are bracketed by
+ * BeginOutput() and EndOutput().
+ */
+class SolverStatsRecorder
+{
+private:
+    SolverStats mStats;
+    std::chrono::steady_clock::time_point mPhaseStart;
+
+    double SecondsSincePhaseStart() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - mPhaseStart).count();
+    }
+
+public:
+    SolverStatsRecorder()
+    {
+        BeginSolve();
+    }
+
+    void BeginSolve()
+    {
+        mStats = SolverStats();
+        mStats.enabled = true;
+        mPhaseStart = std::chrono::steady_clock::now();
+    }
+
+    void BeginIntegration()
+    {
+        mStats.setupSeconds = SecondsSincePhaseStart();
+        mStats.stepsTaken = 0; // The initial values aren't a step
+        mPhaseStart = std::chrono::steady_clock::now();
+    }
+
+    void EndIntegration(std::size_t traceBytes)
+    {
+        mStats.integrateSeconds = SecondsSincePhaseStart();
+        NoteTraceBytes(traceBytes);
+    }
+
+    /** The traces hold traceBytes just now (e.g. part way through a reallocation) */
+    void NoteTraceBytes(std::size_t traceBytes)
+    {
+        mStats.peakTraceBytes = std::max(mStats.peakTraceBytes, traceBytes);
+    }
+
+    void BeginOutput()
+    {
+        mPhaseStart = std::chrono::steady_clock::now();
+    }
+
+    void EndOutput()
+    {
+        mStats.outputSeconds += SecondsSincePhaseStart();
+    }
+
+    void CountStep(bool traceReallocated)
+    {
+        mStats.stepsTaken++;
+        mStats.traceReallocations += traceReallocated;
+    }
+
+    void AddRhsEvaluations(unsigned long long evaluations)
+    {
+        mStats.rhsEvaluations += evaluations;
+    }
+
+    /** The counter incremented by CountingRhs */
+    unsigned long long& RhsEvaluationCounter()
+    {
+        return mStats.rhsEvaluations;
+    }
+
+    const SolverStats& GetStats() const
+    {
+        return mStats;
+    }
+};
+
+/** Wraps a right-hand side rhs(v, t, dvdt) so that every call is counted */
+template<class RHS>
+class CountingRhs
+{
+private:
+    RHS& mrRhs;
+    unsigned long long& mrCount;
+
+public:
+    CountingRhs(RHS& rRhs, unsigned long long& rCount)
+        : mrRhs(rRhs),
+          mrCount(rCount)
+    {}
+
+    template<class STATE>
+    void operator()(const STATE& rValues, double t, STATE& rDerivative)
+    {
+        mrCount++;
+        mrRhs(rValues, t, rDerivative);
+    }
+};
+
+/** The right-hand side for the solver's loop: counted (or, when the stats are compiled out, as it is) */
+template<class RHS>
+CountingRhs<RHS> CountRhsEvaluations(RHS& rRhs, SolverStatsRecorder& rStats)
+{
+    return CountingRhs<RHS>(rRhs, rStats.RhsEvaluationCounter());
+}
+
+#else // ODE_DISABLE_STATS
+
+/** Does nothing: see above for the real one */
+class SolverStatsRecorder
+{
+public:
+    void BeginSolve() {}
+    void BeginIntegration() {}
+    void EndIntegration(std::size_t) {}
+    void BeginOutput() {}
+    void EndOutput() {}
+    void CountStep(bool) {}
+    void NoteTraceBytes(std::size_t) {}
+    void AddRhsEvaluations(unsigned long long) {}
+
+    SolverStats GetStats() const
+    {
+        SolverStats stats = SolverStats();
+        stats.enabled = false;
+        return stats;
+    }
+};
+
+template<class RHS>
+RHS& CountRhsEvaluations(RHS& rRhs, SolverStatsRecorder&)
+{
+    return rRhs;
+}
+
+#endif // ODE_DISABLE_STATS
+
+#endif /* SOLVERSTATS_HPP_ */
@@ -0,0 +1,148 @@
+/*
+ * StageKernels.hpp
+ *
+ * Fused Runge-Kutta stage combinations over contiguous arrays of components, vectorised with
+ * AVX-512/AVX2 when the translation unit is compiled with those instruction sets (e.g.
+ * -march=native), otherwise plain loops.  Each combination is one pass over memory with no
+ * temporaries.
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef STAGEKERNELS_HPP_
+#define STAGEKERNELS_HPP_
+
+#include <cstddef>
+
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+#include <immintrin.h>
+#endif
+
+/*
+ * The kernels work on any contiguous run of components, so a solver can call them on a whole state
+ * in one sweep or on blocks of it from several threads.  The Makefile compiles the solvers that use
+ * them, and their tests, with VECTOR_FLAGS (-march=native unless set otherwise).
+ */
+
+/** Doubles per vector register in the kernels below (1 when they are plain loops) */
+#if defined(__AVX512F__)
+const std::size_t STAGE_KERNEL_DOUBLE_LANES = 8;
+#elif defined(__AVX2__) && defined(__FMA__)
+const std::size_t STAGE_KERNEL_DOUBLE_LANES = 4;
+#else
+const std::size_t STAGE_KERNEL_DOUBLE_LANES = 1;
+#endif
+
+/** Floats per vector register: twice as many */
+const std::size_t STAGE_KERNEL_FLOAT_LANES = (STAGE_KERNEL_DOUBLE_LANES == 1) ? 1 : 2*STAGE_KERNEL_DOUBLE_LANES;
+
+/**
+ * The plain loops, over components begin to size.  The vector kernels use them for the components
+ * left over after the last whole register, and the tests check the vector kernels against them.
+ */
+template<class T>
+inline void StageValuesScalar(T* pOut, const T* pV, double a, const T* pK, std::size_t begin, std::size_t size) {
+	const T a_t = T(a);
+	for (std::size_t i=begin; i<size; i++) {
+		pOut[i] = pV[i] + a_t*pK[i];
+	}
+}
+
+template<class T>
+inline void CombineStagesScalar(T* pV, double dt, const T* pK1, const T* pK2, const T* pK3, const T* pK4,
+								std::size_t begin, std::size_t size) {
+	const T sixth = T(dt/6.0);
+	const T third = T(dt/3.0);
+	for (std::size_t i=begin; i<size; i++) {
+		pV[i] += sixth*(pK1[i] + pK4[i]) + third*(pK2[i] + pK3[i]);
+	}
+}
+
+/** out = v + a*k */
+inline void StageValues(double* pOut, const double* pV, double a, const double* pK, std::size_t size) {
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	const __m512d a8 = _mm512_set1_pd(a);
+	for (; i + 8 <= size; i += 8) {
+		_mm512_storeu_pd(pOut + i, _mm512_fmadd_pd(a8, _mm512_loadu_pd(pK + i), _mm512_loadu_pd(pV + i)));
+	}
+#elif defined(__AVX2__) && defined(__FMA__)
+	const __m256d a4 = _mm256_set1_pd(a);
+	for (; i + 4 <= size; i += 4) {
+		_mm256_storeu_pd(pOut + i, _mm256_fmadd_pd(a4, _mm256_loadu_pd(pK + i), _mm256_loadu_pd(pV + i)));
+	}
+#endif
+	StageValuesScalar(pOut, pV, a, pK, i, size);
+}
+
+/** v += dt*(k1/6 + k2/3 + k3/3 + k4/6) */
+inline void CombineStages(double* pV, double dt, const double* pK1, const double* pK2,
+						  const double* pK3, const double* pK4, std::size_t size) {
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	const __m512d sixth8 = _mm512_set1_pd(dt/6.0);
+	const __m512d third8 = _mm512_set1_pd(dt/3.0);
+	for (; i + 8 <= size; i += 8) {
+		__m512d outer = _mm512_add_pd(_mm512_loadu_pd(pK1 + i), _mm512_loadu_pd(pK4 + i));
+		__m512d inner = _mm512_add_pd(_mm512_loadu_pd(pK2 + i), _mm512_loadu_pd(pK3 + i));
+		__m512d v = _mm512_fmadd_pd(sixth8, outer, _mm512_loadu_pd(pV + i));
+		_mm512_storeu_pd(pV + i, _mm512_fmadd_pd(third8, inner, v));
+	}
+#elif defined(__AVX2__) && defined(__FMA__)
+	const __m256d sixth4 = _mm256_set1_pd(dt/6.0);
+	const __m256d third4 = _mm256_set1_pd(dt/3.0);
+	for (; i + 4 <= size; i += 4) {
+		__m256d outer = _mm256_add_pd(_mm256_loadu_pd(pK1 + i), _mm256_loadu_pd(pK4 + i));
+		__m256d inner = _mm256_add_pd(_mm256_loadu_pd(pK2 + i), _mm256_loadu_pd(pK3 + i));
+		__m256d v = _mm256_fmadd_pd(sixth4, outer, _mm256_loadu_pd(pV + i));
+		_mm256_storeu_pd(pV + i, _mm256_fmadd_pd(third4, inner, v));
+	}
+#endif
+	CombineStagesScalar(pV, dt, pK1, pK2, pK3, pK4, i, size);
+}
+
+/** out = v + a*k in single precision, with twice as many lanes */
+inline void StageValues(float* pOut, const float* pV, double a, const float* pK, std::size_t size) {
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	const __m512 a16 = _mm512_set1_ps(float(a));
+	for (; i + 16 <= size; i += 16) {
+		_mm512_storeu_ps(pOut + i, _mm512_fmadd_ps(a16, _mm512_loadu_ps(pK + i), _mm512_loadu_ps(pV + i)));
+	}
+#elif defined(__AVX2__) && defined(__FMA__)
+	const __m256 a8 = _mm256_set1_ps(float(a));
+	for (; i + 8 <= size; i += 8) {
+		_mm256_storeu_ps(pOut + i, _mm256_fmadd_ps(a8, _mm256_loadu_ps(pK + i), _mm256_loadu_ps(pV + i)));
+	}
+#endif
+	StageValuesScalar(pOut, pV, a, pK, i, size);
+}
+
+/** v += dt*(k1/6 + k2/3 + k3/3 + k4/6) in single precision */
+inline void CombineStages(float* pV, double dt, const float* pK1, const float* pK2,
+						  const float* pK3, const float* pK4, std::size_t size) {
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	const __m512 sixth16 = _mm512_set1_ps(float(dt/6.0));
+	const __m512 third16 = _mm512_set1_ps(float(dt/3.0));
+	for (; i + 16 <= size; i += 16) {
+		__m512 outer = _mm512_add_ps(_mm512_loadu_ps(pK1 + i), _mm512_loadu_ps(pK4 + i));
+		__m512 inner = _mm512_add_ps(_mm512_loadu_ps(pK2 + i), _mm512_loadu_ps(pK3 + i));
+		__m512 v = _mm512_fmadd_ps(sixth16, outer, _mm512_loadu_ps(pV + i));
+		_mm512_storeu_ps(pV + i, _mm512_fmadd_ps(third16, inner, v));
+	}
+#elif defined(__AVX2__) && defined(__FMA__)
+	const __m256 sixth8 = _mm256_set1_ps(float(dt/6.0));
+	const __m256 third8 = _mm256_set1_ps(float(dt/3.0));
+	for (; i + 8 <= size; i += 8) {
+		__m256 outer = _mm256_add_ps(_mm256_loadu_ps(pK1 + i), _mm256_loadu_ps(pK4 + i));
+		__m256 inner = _mm256_add_ps(_mm256_loadu_ps(pK2 + i), _mm256_loadu_ps(pK3 + i));
+		__m256 v = _mm256_fmadd_ps(sixth8, outer, _mm256_loadu_ps(pV + i));
+		_mm256_storeu_ps(pV + i, _mm256_fmadd_ps(third8, inner, v));
+	}
+#endif
+	CombineStagesScalar(pV, dt, pK1, pK2, pK3, pK4, i, size);
+}
+
+#endif /* STAGEKERNELS_HPP_ */
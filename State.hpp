@@ -0,0 +1,357 @@
+/*
+ * State.hpp
+ *
+ * Fixed-size state vectors for ODE systems of any (compile-time) dimension
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef STATE_HPP_
+#define STATE_HPP_
+
+#include <type_traits>
+#include <utility>
+
+/**
+ * Calls f(i) for i = 0, 1, ..., N-1, with i a compile-time constant.  This is a fold over an index
+ * sequence rather than a loop, so that the arithmetic below compiles to straight-line code.
+ */
+template<int N, class F, int... I>
+constexpr void ForEachComponentImpl(F& f, std::integer_sequence<int, I...>)
+{
+    (f(std::integral_constant<int, I>()), ...);
+}
+
+template<int N, class F>
+constexpr void ForEachComponent(F f)
+{
+    ForEachComponentImpl<N>(f, std::make_integer_sequence<int, N>());
+}
+
+/** Base of the expression nodes in the state arithmetic below, so that they can be recognised */
+struct StateExpressionTag
+{
+};
+
+/**
+ * State of an N-variable ODE system: x' = f(x,t) with x a vector of N numbers.
+ * The components are accessed with state[i].
+ *
+ * The components are doubles unless SCALAR says otherwise.  TIME is the precision the solvers work
+ * out the time-points in (start time + n*dt), and is double unless set too, so:
+ *  * State<N> is all double precision
+ *  * State<N, float> is mixed precision: the solution is in float, which halves the memory of the
+ *    traces and doubles the width of the SIMD arithmetic, while the time-points stay exact to double
+ *    precision however long the run is
+ *  * State<N, float, float> is all single precision, time-points included
+ * The time passed to the right-hand side and stored in the time trace is always a double.
+ */
+template<int N, class SCALAR=double, class TIME=double>
+struct State
+{
+    static const int DIMENSION = N; ///< Number of variables
+    typedef SCALAR ValueType;       ///< Type of the components
+    typedef TIME TimeType;          ///< Precision of the time-points
+
+    SCALAR values[N] = {}; ///< The components (zero unless set)
+
+    constexpr SCALAR& operator[](int i) { return values[i]; }
+    constexpr const SCALAR& operator[](int i) const { return values[i]; }
+
+    /** Evaluate an expression of states (see below) and then store it in this one */
+    template<class E, class = typename std::enable_if<std::is_base_of<StateExpressionTag, E>::value>::type>
+    constexpr State& operator=(const E& rExpression)
+    {
+        static_assert(std::is_same<typename E::StateType, State>::value, "State arithmetic needs states of the same type");
+        *this = State(rExpression);
+        return *this;
+    }
+};
+
+/**
+ * The two-variable state is a "struct" with named components.
+ *
+ * This is because it's arguably easier to read
+ *          dvdt.x = f(v.x, v.y, t)
+ * than
+ *          dxdt[0] = f(x[0], x[1], t)
+ */
+template<class SCALAR, class TIME>
+struct State<2, SCALAR, TIME>
+{
+    static const int DIMENSION = 2; ///< Number of variables
+    typedef SCALAR ValueType;       ///< Type of the components
+    typedef TIME TimeType;          ///< Precision of the time-points
+
+    SCALAR x; ///< named x variable for convenience
+    SCALAR y; ///< y
+
+    constexpr State(SCALAR x=0, SCALAR y=0) : x(x), y(y) {}
+
+    constexpr SCALAR& operator[](int i) { return i == 0 ? x : y; }
+    constexpr const SCALAR& operator[](int i) const { return i == 0 ? x : y; }
+
+    /** Evaluate an expression of states (see below) and then store it in this one */
+    template<class E, class = typename std::enable_if<std::is_base_of<StateExpressionTag, E>::value>::type>
+    constexpr State& operator=(const E& rExpression)
+    {
+        static_assert(std::is_same<typename E::StateType, State>::value, "State arithmetic needs states of the same type");
+        *this = State(rExpression);
+        return *this;
+    }
+};
+
+/** The original 2-D state used throughout the solvers and tests */
+typedef State<2> Pair;
+
+/** The 2-D state in mixed precision (float solution, double time-points) and all in single precision */
+typedef State<2, float> MixedPair;
+typedef State<2, float, float> FloatPair;
+
+/*
+ * Component-wise arithmetic, by expression templates.  The operators don't work anything out: they
+ * return a small node (StateBinaryExpression or ScaledStateExpression) which refers to its operands,
+ * and a whole expression such as
+ *     v + (k1/6.0 + k2/3.0 + k3/3.0 + k4/6.0)*dt
+ * is a tree of nodes that is evaluated in one pass over the components when it is assigned to a
+ * state, added to one, or converted to one (e.g. passed to a right-hand side).  So there are no
+ * intermediate states, whatever the dimension.  Each component is worked out with the same
+ * operations in the same order as before, so the results are unchanged.
+ *
+ *  * Products and quotients of two states are component-wise too
+ *  * Scalar factors are converted to the component type first, so float states stay in float
+ *  * Both sides of an operator must have the same state type
+ *  * The nodes hold references to the states in them, so keep an expression in a state rather than
+ *    in an "auto" variable that outlives the full expression
+ */
+
+/** The type of state an operand of the arithmetic evaluates to */
+template<class E>
+struct StateTypeOf
+{
+    typedef typename E::StateType Type;
+};
+
+template<int N, class S, class T>
+struct StateTypeOf<State<N, S, T> >
+{
+    typedef State<N, S, T> Type;
+};
+
+/** True for the types the arithmetic works on: states and expression nodes */
+template<class E>
+struct IsStateOperand : std::is_base_of<StateExpressionTag, E>
+{
+};
+
+template<int N, class S, class T>
+struct IsStateOperand<State<N, S, T> > : std::true_type
+{
+};
+
+/** Expression nodes are stored in the nodes above them by value, and states by reference */
+template<class E>
+struct StateOperandStorage
+{
+    typedef const E Type;
+};
+
+template<int N, class S, class T>
+struct StateOperandStorage<State<N, S, T> >
+{
+    typedef const State<N, S, T>& Type;
+};
+
+/** The component operations */
+struct StatePlus
+{
+    template<class S>
+    static constexpr S Apply(S a, S b) { return a + b; }
+};
+
+struct StateMinus
+{
+    template<class S>
+    static constexpr S Apply(S a, S b) { return a - b; }
+};
+
+struct StateTimes
+{
+    template<class S>
+    static constexpr S Apply(S a, S b) { return a * b; }
+};
+
+struct StateDivide
+{
+    template<class S>
+    static constexpr S Apply(S a, S b) { return a / b; }
+};
+
+/**
+ * A new state with the components rExpression[0], rExpression[1]...  This is a plain loop rather than
+ * ForEachComponent(): the compiler unrolls it for small states and vectorises it for big ones, and it
+ * stays small enough to be inlined whatever the dimension, so that the expression nodes never have to
+ * be built in memory.
+ */
+template<class STATE, class E>
+constexpr STATE MakeState(const E& rExpression)
+{
+    STATE result;
+    for (int i=0; i<STATE::DIMENSION; i++)
+    {
+        result[i] = rExpression[i];
+    }
+    return result;
+}
+
+/** Node for a op b, with a and b states or expressions of the same type */
+template<class L, class R, class OP>
+class StateBinaryExpression : public StateExpressionTag
+{
+private:
+    typename StateOperandStorage<L>::Type mLeft;
+    typename StateOperandStorage<R>::Type mRight;
+
+public:
+    typedef typename StateTypeOf<L>::Type StateType;
+    typedef typename StateType::ValueType ValueType;
+    static_assert(std::is_same<StateType, typename StateTypeOf<R>::Type>::value,
+                  "State arithmetic needs states of the same type");
+
+    constexpr StateBinaryExpression(const L& rLeft, const R& rRight)
+        : mLeft(rLeft),
+          mRight(rRight)
+    {}
+
+    constexpr ValueType operator[](int i) const
+    {
+        return OP::template Apply<ValueType>(mLeft[i], mRight[i]);
+    }
+
+    /** Evaluate the expression into a new state */
+    constexpr operator StateType() const
+    {
+        return MakeState<StateType>(*this);
+    }
+};
+
+/** Node for e op factor, with the factor converted to the component type */
+template<class E, class OP>
+class ScaledStateExpression : public StateExpressionTag
+{
+public:
+    typedef typename StateTypeOf<E>::Type StateType;
+    typedef typename StateType::ValueType ValueType;
+
+private:
+    typename StateOperandStorage<E>::Type mExpression;
+    ValueType mFactor;
+
+public:
+    constexpr ScaledStateExpression(const E& rExpression, double factor)
+        : mExpression(rExpression),
+          mFactor(ValueType(factor))
+    {}
+
+    constexpr ValueType operator[](int i) const
+    {
+        return OP::template Apply<ValueType>(mExpression[i], mFactor);
+    }
+
+    /** Evaluate the expression into a new state */
+    constexpr operator StateType() const
+    {
+        return MakeState<StateType>(*this);
+    }
+};
+
+/**
+ * rResult[i] = OP(rResult[i], rExpression[i]) for each component.  All of the components are worked
+ * out before any is stored, so that the compiler needn't worry that rResult is also one of the states
+ * in the expression, and can keep them in (vector) registers.
+ */
+template<int N, class S, class T, class E, class OP>
+constexpr void EvaluateState(State<N, S, T>& rResult, const E& rExpression, OP)
+{
+    static_assert(std::is_same<typename StateTypeOf<E>::Type, State<N, S, T> >::value,
+                  "State arithmetic needs states of the same type");
+    rResult = MakeState<State<N, S, T> >(StateBinaryExpression<State<N, S, T>, E, OP>(rResult, rExpression));
+}
+
+/** Enables the operators below for states and expressions only */
+template<class L, class R=L>
+using EnableForStates = typename std::enable_if<IsStateOperand<L>::value && IsStateOperand<R>::value>::type;
+
+template<int N, class S, class T, class E, class = EnableForStates<E> >
+constexpr State<N, S, T>& operator+=(State<N, S, T>& a, const E& b)
+{
+    EvaluateState(a, b, StatePlus());
+    return a;
+}
+
+template<int N, class S, class T, class E, class = EnableForStates<E> >
+constexpr State<N, S, T>& operator-=(State<N, S, T>& a, const E& b)
+{
+    EvaluateState(a, b, StateMinus());
+    return a;
+}
+
+template<int N, class S, class T, class E, class = EnableForStates<E> >
+constexpr State<N, S, T>& operator*=(State<N, S, T>& a, const E& b)
+{
+    EvaluateState(a, b, StateTimes());
+    return a;
+}
+
+template<int N, class S, class T>
+constexpr State<N, S, T>& operator*=(State<N, S, T>& a, double b)
+{
+    const S factor = S(b);
+    ForEachComponent<N>([&](int i) { a[i] *= factor; });
+    return a;
+}
+
+template<class L, class R, class = EnableForStates<L, R> >
+constexpr StateBinaryExpression<L, R, StatePlus> operator+(const L& a, const R& b)
+{
+    return StateBinaryExpression<L, R, StatePlus>(a, b);
+}
+
+template<class L, class R, class = EnableForStates<L, R> >
+constexpr StateBinaryExpression<L, R, StateMinus> operator-(const L& a, const R& b)
+{
+    return StateBinaryExpression<L, R, StateMinus>(a, b);
+}
+
+template<class L, class R, class = EnableForStates<L, R> >
+constexpr StateBinaryExpression<L, R, StateTimes> operator*(const L& a, const R& b)
+{
+    return StateBinaryExpression<L, R, StateTimes>(a, b);
+}
+
+template<class L, class R, class = EnableForStates<L, R> >
+constexpr StateBinaryExpression<L, R, StateDivide> operator/(const L& a, const R& b)
+{
+    return StateBinaryExpression<L, R, StateDivide>(a, b);
+}
+
+template<class E, class = EnableForStates<E> >
+constexpr ScaledStateExpression<E, StateTimes> operator*(const E& a, double b)
+{
+    return ScaledStateExpression<E, StateTimes>(a, b);
+}
+
+template<class E, class = EnableForStates<E> >
+constexpr ScaledStateExpression<E, StateTimes> operator*(double a, const E& b)
+{
+    return ScaledStateExpression<E, StateTimes>(b, a);
+}
+
+template<class E, class = EnableForStates<E> >
+constexpr ScaledStateExpression<E, StateDivide> operator/(const E& a, double b)
+{
+    return ScaledStateExpression<E, StateDivide>(a, b);
+}
+
+#endif /* STATE_HPP_ */
@@ -0,0 +1,13 @@
+/*
+ * StormerVerletOdeSolver.cpp
+ *
+ * Implements the Stormer-Verlet (leapfrog) symplectic solver
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include "StormerVerletOdeSolver.hpp"
+
+// The methods are templates defined in the header.  The 2-D (Pair) version is compiled here once.
+template class StormerVerletOdeSolverT<Pair>;
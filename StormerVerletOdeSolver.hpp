@@ -0,0 +1,96 @@
+/*
+ * StormerVerletOdeSolver.hpp
+ *
+ * Implements the Stormer-Verlet (leapfrog) symplectic solver
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef STORMERVERLETODESOLVER_HPP_
+#define STORMERVERLETODESOLVER_HPP_
+
+#include "AbstractSymplecticOdeSolver.hpp"
+
+/**
+ * Stormer-Verlet (leapfrog) in its kick-drift-kick "velocity Verlet" form:
+ *     p_{n+1/2} = p_n + dt/2 force(q_n),  q_{n+1} = q_n + dt positionRhs(p_{n+1/2}),
+ *     p_{n+1} = p_{n+1/2} + dt/2 force(q_{n+1})
+ * Second order, symplectic and time-reversible, so the energy error stays bounded over long runs
+ * instead of drifting.  One force evaluation per step.
+ */
+template<class STATE>
+class StormerVerletOdeSolverT: public AbstractSymplecticOdeSolverT<STATE> {
+public:
+	StormerVerletOdeSolverT();
+	virtual ~StormerVerletOdeSolverT();
+
+	std::string GetSolverName() const {
+		return "StormerVerlet";
+	}
+
+	/**
+	 * Solve with the function pointers set by SetSplitRhsFunctions() or, if that wasn't called,
+	 * with the one set by SetRhsFunction() for both halves
+	 */
+	void Solve();
+
+	/** Solve with any callable right-hand side rhs(v, t, dvdt) for a separable system */
+	template<class RHS>
+	void Solve(RHS rhs);
+
+	/** Solve with any callable position right-hand side and force */
+	template<class POSITION_RHS, class FORCE>
+	void Solve(POSITION_RHS positionRhs, FORCE force);
+
+	/** Advance v over one time step from time t to t+dt */
+	template<class POSITION_RHS, class FORCE>
+	void TakeStep(POSITION_RHS& rPositionRhs, FORCE& rForce, double t, double dt, STATE& v);
+};
+
+template<class STATE>
+StormerVerletOdeSolverT<STATE>::StormerVerletOdeSolverT() {
+}
+
+template<class STATE>
+StormerVerletOdeSolverT<STATE>::~StormerVerletOdeSolverT() {
+}
+
+template<class STATE>
+void StormerVerletOdeSolverT<STATE>::Solve() {
+	if (this->mpPositionRhsFunction != NULL) {
+		Solve(this->mpPositionRhsFunction, this->mpForceFunction);
+		return;
+	}
+	if (this->mpRhsFunction == NULL) {
+		throw Exception("OdeSolve", "Please define the right hand side function");
+	}
+	Solve(this->mpRhsFunction);
+}
+
+template<class STATE>
+template<class RHS>
+void StormerVerletOdeSolverT<STATE>::Solve(RHS rhs) {
+	Solve(rhs, rhs);
+}
+
+template<class STATE>
+template<class POSITION_RHS, class FORCE>
+void StormerVerletOdeSolverT<STATE>::Solve(POSITION_RHS positionRhs, FORCE force) {
+	this->RunSymplecticTimeSteps(*this, positionRhs, force);
+}
+
+template<class STATE>
+template<class POSITION_RHS, class FORCE>
+void StormerVerletOdeSolverT<STATE>::TakeStep(POSITION_RHS& rPositionRhs, FORCE& rForce, double t, double dt, STATE& v) {
+	const double kicks[2] = {0.5, 0.5};
+	const double drifts[1] = {1.0};
+	this->TakeCompositionStep(rPositionRhs, rForce, t, dt, v, kicks, drifts, 1);
+}
+
+/** The 2-D solver: x is the position and y the velocity */
+typedef StormerVerletOdeSolverT<Pair> StormerVerletOdeSolver;
+// Compiled once in StormerVerletOdeSolver.cpp
+extern template class StormerVerletOdeSolverT<Pair>;
+
+#endif /* STORMERVERLETODESOLVER_HPP_ */
@@ -0,0 +1,243 @@
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <vector>
+
+#include "AbstractOdeSolver.hpp"
+#include "ConvergenceStudy.hpp"
+#include "RK4Solver.hpp"
+#include "AdamsBashforthMoultonOdeSolver.hpp"
+
+/*
+ * x' = -y
+ * y' = +x
+ * You can solve this one as: dy/dx = (dy/dt)/(dx/dt) = -x/y.  Separate and integrate to give x^2 + y^2 = 2*c
+ */
+void RhsCircle(const Pair& v, double t, Pair& dvdt)
+{
+    dvdt.x = -v.y;
+    dvdt.y =  v.x;
+}
+
+/** x' = x*cos(t), y' = -y, a non-autonomous problem with x = exp(sin(t)), y = exp(-t) */
+void RhsExpSin(const Pair& v, double t, Pair& dvdt)
+{
+    dvdt.x = v.x*cos(t);
+    dvdt.y = -v.y;
+}
+
+void RhsVanderPol(const Pair& v, double t, Pair& dvdt)
+{
+    double mu = 7;
+    dvdt.x = mu * (v.x - pow(v.x, 3) / 3.0 - v.y);
+    dvdt.y = v.x / mu;
+}
+
+/** Counts right-hand side evaluations of the circle */
+struct CountingCircle
+{
+    int evaluations;
+
+    void operator()(const Pair& v, double t, Pair& dvdt)
+    {
+        evaluations++;
+        RhsCircle(v, t, dvdt);
+    }
+};
+
+/** Fixed order solvers that ConvergenceStudy can make for itself */
+template<int ORDER>
+class AdamsBashforthMoultonOrder : public AdamsBashforthMoultonOdeSolver
+{
+public:
+    AdamsBashforthMoultonOrder()
+    {
+        SetOrder(ORDER);
+    }
+};
+
+/**
+ * This test suite is about the Adams-Bashforth-Moulton multistep solvers
+ */
+class TestAdamsBashforthMoultonOdeSolver : public CxxTest::TestSuite
+{
+private:
+    /** Observed orders of the solver on a non-autonomous problem, from 64 to 1024 steps */
+    template<class SOLVER>
+    std::vector<ConvergenceResult> Convergence()
+    {
+        std::vector<double> step_sizes;
+        for (int num_steps=64; num_steps<=1024; num_steps*=2)
+        {
+            step_sizes.push_back(2.0/num_steps);
+        }
+        ConvergenceStudy<SOLVER> study;
+        study.SetInitialValues(Pair(1.0, 1.0));
+        study.SetInitialAndFinalTime(0.0, 2.0);
+        study.SetStepSizes(step_sizes);
+        study.SetAnalyticSolution([](double t) { return Pair(exp(sin(t)), exp(-t)); });
+        study.Run(&RhsExpSin);
+        return study.GetResults();
+    }
+
+public:
+    void TestSetup()
+    {
+        AdamsBashforthMoultonOdeSolver solver;
+        TS_ASSERT_EQUALS(solver.GetOrder(), 4);
+        TS_ASSERT_EQUALS(solver.GetSolverName(), "AdamsBashforthMoulton4");
+        TS_ASSERT_THROWS_ANYTHING( solver.SetOrder(1) );
+        TS_ASSERT_THROWS_ANYTHING( solver.SetOrder(6) );
+        solver.SetOrder(5);
+        solver.SetVariableOrder(true);
+        TS_ASSERT_EQUALS(solver.GetSolverName(), "AdamsBashforthMoulton2to5");
+        TS_ASSERT_THROWS_ANYTHING( solver.GetNumberOfStepsAtOrder(1) );
+
+        // No right-hand side
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10, 1.0);
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+
+        // The derivative history can't be checkpointed
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetCheckpointing("./tempfile.chk", 5);
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+    }
+
+    /** One evaluation per step (two with PECE) after the RK4 starting steps, which reuse the history */
+    void TestRhsEvaluations()
+    {
+        const int num_steps = 100;
+        for (int order=2; order<=5; order++)
+        {
+            AdamsBashforthMoultonOdeSolver solver;
+            solver.SetOrder(order);
+            solver.SetInitialValues(1.0, 0.0);
+            solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+            CountingCircle rhs = {0};
+            solver.Solve(std::ref(rhs));
+            TS_ASSERT_EQUALS(solver.GetNumberOfStartingSteps(), order - 1);
+            TS_ASSERT_EQUALS(solver.GetNumberOfStepsAtOrder(order), num_steps - order + 1);
+            TS_ASSERT_EQUALS(rhs.evaluations, 1 + 4*(order - 1) + (num_steps - order + 1));
+
+            solver.SetEvaluateAfterCorrection(true);
+            rhs.evaluations = 0;
+            solver.Solve(std::ref(rhs));
+            TS_ASSERT_EQUALS(rhs.evaluations, 1 + 4*(order - 1) + 2*(num_steps - order + 1));
+        }
+    }
+
+    void TestOrders()
+    {
+        std::vector<ConvergenceResult> results[4] = {Convergence<AdamsBashforthMoultonOrder<2> >(),
+                                                     Convergence<AdamsBashforthMoultonOrder<3> >(),
+                                                     Convergence<AdamsBashforthMoultonOrder<4> >(),
+                                                     Convergence<AdamsBashforthMoultonOrder<5> >()};
+        for (int order=2; order<=5; order++)
+        {
+            // The starting steps and the history make the orders approach theirs from below
+            const std::vector<ConvergenceResult>& r = results[order - 2];
+            for (unsigned i=1; i<r.size(); i++)
+            {
+                TS_ASSERT_LESS_THAN(order - 0.4, r[i].observedOrder);
+            }
+            TS_ASSERT_DELTA(r.back().observedOrder, order, 0.1);
+        }
+        // Each order is more accurate than the one below
+        for (int order=3; order<=5; order++)
+        {
+            TS_ASSERT_LESS_THAN(results[order - 2].back().maxError, results[order - 3].back().maxError);
+        }
+    }
+
+    /** Fourth order for a quarter of the evaluations of RK4 */
+    void TestAgainstRK4()
+    {
+        const int num_steps = 1000;
+        RK4Solver rk4_solver;
+        AdamsBashforthMoultonOdeSolver abm_solver;
+        AbstractOdeSolver* solvers[2] = {&rk4_solver, &abm_solver};
+        for (int i=0; i<2; i++)
+        {
+            solvers[i]->SetInitialValues(1.0, 0.0);
+            solvers[i]->SetRhsFunction( &RhsCircle );
+            solvers[i]->SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+            solvers[i]->Solve();
+            TS_ASSERT_DELTA(solvers[i]->GetXTrace().back(), 1.0, 1e-9);
+            TS_ASSERT_DELTA(solvers[i]->GetYTrace().back(), 0.0, 1e-9);
+        }
+        // The starting steps are RK4's
+        for (int t=0; t<=abm_solver.GetNumberOfStartingSteps(); t++)
+        {
+            TS_ASSERT_EQUALS(abm_solver.GetXTrace()[t], rk4_solver.GetXTrace()[t]);
+        }
+    }
+
+    void TestVariableOrder()
+    {
+        AdamsBashforthMoultonOdeSolver fixed_solver, variable_solver;
+        fixed_solver.SetOrder(5);
+        variable_solver.SetOrder(5);
+        variable_solver.SetVariableOrder(true);
+        AdamsBashforthMoultonOdeSolver* solvers[2] = {&fixed_solver, &variable_solver};
+        for (int i=0; i<2; i++)
+        {
+            solvers[i]->SetInitialValues(1.0, 1.0);
+            solvers[i]->SetRhsFunction( &RhsExpSin );
+            solvers[i]->SetInitialTimeNumberOfStepsAndFinalTime(0.0, 400, 2.0);
+            solvers[i]->Solve();
+        }
+        // A smooth problem with a reasonable step size stays at (or near) the highest order
+        int steps = 0;
+        for (int order=2; order<=5; order++)
+        {
+            steps += variable_solver.GetNumberOfStepsAtOrder(order);
+        }
+        TS_ASSERT_EQUALS(steps + variable_solver.GetNumberOfStartingSteps(), 400);
+        TS_ASSERT_LESS_THAN(steps/2, variable_solver.GetNumberOfStepsAtOrder(5));
+        TS_ASSERT_DELTA(variable_solver.GetXTrace().back(), exp(sin(2.0)), 1e-8);
+        TS_ASSERT_DELTA(variable_solver.GetYTrace().back(), exp(-2.0), 1e-8);
+
+        // Where the step size is tiny the high differences are rounding noise, so lower orders are used
+        variable_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100000, 2.0);
+        variable_solver.Solve();
+        TS_ASSERT_LESS_THAN(0, variable_solver.GetNumberOfStepsAtOrder(4));
+        TS_ASSERT_DELTA(variable_solver.GetXTrace().back(), exp(sin(2.0)), 1e-10);
+
+        // Van der Pol's fast jumps need the larger stability regions of the lower orders at this step
+        // size (fixed order 5 blows up)
+        variable_solver.SetInitialValues(2.0, 0.0);
+        variable_solver.SetRhsFunction( &RhsVanderPol );
+        variable_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 400, 10.0);
+        variable_solver.Solve();
+        TS_ASSERT_LESS_THAN(0, variable_solver.GetNumberOfStepsAtOrder(2));
+        fixed_solver.SetInitialValues(2.0, 0.0);
+        fixed_solver.SetRhsFunction( &RhsVanderPol );
+        fixed_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10000, 10.0);
+        fixed_solver.Solve();
+        TS_ASSERT_DELTA(variable_solver.GetXTrace().back(), fixed_solver.GetXTrace().back(), 0.1);
+    }
+
+    /** Any state dimension and precision, a lambda right-hand side, and events work as usual */
+    void TestOtherDimensionsAndFeatures()
+    {
+        AdamsBashforthMoultonOdeSolverT<State<3> > solver;
+        State<3> initial;
+        initial[0] = 1.0;
+        initial[1] = 2.0;
+        initial[2] = 3.0;
+        solver.SetInitialValues(initial);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 1.0);
+        int stop = solver.AddEventFunction([](const State<3>& v, double t) { return v[0] - 0.5; }, -1, 1);
+        const double rate = -2.0;
+        solver.Solve([rate](const State<3>& v, double t, State<3>& dvdt) { dvdt = v*rate; });
+        TS_ASSERT(solver.WasStoppedByEvent());
+        TS_ASSERT_DELTA(solver.GetEventTimes(stop)[0], log(2.0)/2.0, 1e-10);
+
+        AdamsBashforthMoultonOdeSolverT<MixedPair> float_solver;
+        float_solver.SetInitialValues(1.0, 0.0);
+        float_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 2*M_PI);
+        float_solver.Solve([](const MixedPair& v, double t, MixedPair& dvdt) { dvdt.x = -v.y; dvdt.y = v.x; });
+        TS_ASSERT_DELTA(float_solver.GetXTrace().back(), 1.0, 1e-5);
+    }
+};
@@ -0,0 +1,307 @@
+#include <cxxtest/TestSuite.h>
+
+#include "AbstractOdeSolver.hpp"
+#include "RK4Solver.hpp"
+#include "DormandPrinceOdeSolver.hpp"
+
+/*
+ * x' = -y
+ * y' = +x
+ * You can solve this one as: dy/dx = (dy/dt)/(dx/dt) = -x/y.  Separate and integrate to give x^2 + y^2 = 2*c
+ */
+void RhsCircle(const Pair& v, double t, Pair& dvdt)
+{
+    dvdt.x = -v.y;
+    dvdt.y =  v.x;
+}
+
+void RhsVanderPol(const Pair& v, double t, Pair& dvdt)
+{
+    double mu = 7;
+    dvdt.x = mu * (v.x - pow(v.x, 3) / 3.0 - v.y);
+    dvdt.y = v.x / mu;
+}
+
+/** Counts right-hand side evaluations of the circle */
+struct CountingCircle
+{
+    int evaluations;
+
+    void operator()(const Pair& v, double t, Pair& dvdt)
+    {
+        evaluations++;
+        RhsCircle(v, t, dvdt);
+    }
+};
+
+/**
+ * This test suite is about the adaptive step Dormand-Prince solver
+ */
+class TestDormandPrinceOdeSolver : public CxxTest::TestSuite
+{
+public:
+    void TestSetup()
+    {
+        DormandPrinceOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetRhsFunction( &RhsCircle );
+        // No time interval
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+        TS_ASSERT_THROWS_ANYTHING( solver.SetTolerances(-1e-6, 1e-6) );
+        TS_ASSERT_THROWS_ANYTHING( solver.SetTolerances(0.0, 0.0) );
+        TS_ASSERT_THROWS_NOTHING( solver.SetTolerances(0.0, 1e-6) );
+
+        DormandPrinceOdeSolver no_rhs_solver;
+        no_rhs_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1, 1.0);
+        TS_ASSERT_THROWS_ANYTHING( no_rhs_solver.Solve() );
+    }
+
+    /** The error on the circle should follow the tolerance, with the end time hit exactly */
+    void TestCircleTolerances()
+    {
+        double previous_error = 1.0;
+        int previous_steps = 0;
+        for (double tolerance = 1e-3; tolerance > 1e-11; tolerance /= 100.0)
+        {
+            DormandPrinceOdeSolver solver;
+            solver.SetInitialValues(1.0, 0.0);  // For a unit circle
+            solver.SetRhsFunction( &RhsCircle );
+            solver.SetTolerances(tolerance, tolerance);
+            // One circuit, trying a single step first
+            solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1, 2*M_PI);
+            solver.Solve();
+
+            std::vector<double> times = solver.GetTimeTrace();
+            std::vector<double> x = solver.GetXTrace();
+            std::vector<double> y = solver.GetYTrace();
+            TS_ASSERT_EQUALS(times.size(), (unsigned)solver.GetNumberOfAcceptedSteps() + 1);
+            TS_ASSERT_EQUALS(times.back(), 2*M_PI);
+
+            double max_error = 0.0;
+            for (unsigned i=0; i<times.size(); i++)
+            {
+                // Non-uniform but increasing times
+                if (i > 0)
+                {
+                    TS_ASSERT_LESS_THAN(times[i-1], times[i]);
+                }
+                max_error = std::max(max_error, fabs(x[i] - cos(times[i])));
+                max_error = std::max(max_error, fabs(y[i] - sin(times[i])));
+            }
+            // Global error is within a modest multiple of the local tolerance and improves as it's tightened
+            TS_ASSERT_LESS_THAN(max_error, 100*tolerance);
+            TS_ASSERT_LESS_THAN(max_error, previous_error);
+            TS_ASSERT_LESS_THAN(previous_steps, solver.GetNumberOfAcceptedSteps());
+            previous_error = max_error;
+            previous_steps = solver.GetNumberOfAcceptedSteps();
+        }
+    }
+
+    /** First same as last: six evaluations per attempted step plus one at the start */
+    void TestFirstSameAsLast()
+    {
+        CountingCircle rhs = {0};
+        DormandPrinceOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetTolerances(1e-8, 1e-8);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1, 2*M_PI);
+        solver.Solve(std::ref(rhs));
+        // The huge first step must have been rejected
+        TS_ASSERT_LESS_THAN(0, solver.GetNumberOfRejectedSteps());
+        TS_ASSERT_EQUALS(rhs.evaluations, 6*(solver.GetNumberOfAcceptedSteps() + solver.GetNumberOfRejectedSteps()) + 1);
+    }
+
+    /** The continuous extension is as accurate as the steps, with no extra evaluations */
+    void TestDenseOutput()
+    {
+        CountingCircle rhs = {0};
+        DormandPrinceOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetTolerances(1e-8, 1e-8);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10, 2*M_PI);
+        solver.Solve(std::ref(rhs));
+        int evaluations = rhs.evaluations;
+
+        rhs.evaluations = 0;
+        solver.SetDenseOutput(true);
+        solver.Solve(std::ref(rhs));
+        TS_ASSERT_EQUALS(rhs.evaluations, evaluations);
+        double max_error = 0.0;
+        for (int i=0; i<=1000; i++)
+        {
+            double t = 2*M_PI*i/1000.0;
+            Pair values = solver.Evaluate(t);
+            max_error = std::max(max_error, std::max(fabs(values.x - cos(t)), fabs(values.y - sin(t))));
+        }
+        TS_ASSERT_LESS_THAN(max_error, 1e-6);
+        // From far fewer steps than output points
+        TS_ASSERT_LESS_THAN(solver.GetNumberOfAcceptedSteps(), 100);
+
+        // Backwards in time
+        solver.SetInitialTimeDeltaTimeAndFinalTime(0.0, -0.1, -1.0);
+        solver.Solve(std::ref(rhs));
+        TS_ASSERT_DELTA(solver.Evaluate(-0.55).x, cos(-0.55), 1e-7);
+        TS_ASSERT_DELTA(solver.Evaluate(-0.55).y, sin(-0.55), 1e-7);
+        TS_ASSERT_THROWS_ANYTHING( solver.Evaluate(0.1) );
+    }
+
+    /** The period of Van der Pol from the rising zero crossings of x, stopping after three of them */
+    void TestVanderPolPeriod()
+    {
+        DormandPrinceOdeSolver solver;
+        solver.SetInitialValues(2.0, 0.0);
+        solver.SetRhsFunction( &RhsVanderPol );
+        solver.SetTolerances(1e-10, 1e-10);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1, 1000.0);
+        solver.AddEventFunction([](const Pair& v, double t) { return v.x; }, 1, 3);
+        solver.Solve();
+        TS_ASSERT(solver.WasStoppedByEvent());
+        std::vector<double> crossings = solver.GetEventTimes(0);
+        TS_ASSERT_EQUALS(crossings.size(), 3u);
+        // Settled onto the limit cycle: the same period twice
+        double period = crossings[2] - crossings[1];
+        TS_ASSERT_DELTA(crossings[1] - crossings[0], period, 1e-6);
+        TS_ASSERT_EQUALS(solver.GetTimeTrace().back(), crossings[2]);
+
+        // A fine fixed-step RK4 run agrees
+        RK4Solver rk4_solver;
+        rk4_solver.SetInitialValues(2.0, 0.0);
+        rk4_solver.SetRhsFunction( &RhsVanderPol );
+        rk4_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100000, 100.0);
+        rk4_solver.AddEventFunction([](const Pair& v, double t) { return v.x; }, 1, 3);
+        rk4_solver.Solve();
+        std::vector<double> rk4_crossings = rk4_solver.GetEventTimes(0);
+        TS_ASSERT_EQUALS(rk4_crossings.size(), 3u);
+        TS_ASSERT_DELTA(rk4_crossings[2] - rk4_crossings[1], period, 1e-6);
+    }
+
+    /** Backwards in time */
+    void TestNegativeTime()
+    {
+        DormandPrinceOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetTolerances(1e-10, 1e-10);
+        solver.SetInitialTimeDeltaTimeAndFinalTime(0.0, -0.1, -1.0);
+        solver.Solve();
+        TS_ASSERT_EQUALS(solver.GetTimeTrace().back(), -1.0);
+        TS_ASSERT_DELTA(solver.GetXTrace().back(), cos(-1.0), 1e-8);
+        TS_ASSERT_DELTA(solver.GetYTrace().back(), sin(-1.0), 1e-8);
+    }
+
+    /**
+     * End times that accumulating t can only miss by a few ulps: the last step is stretched to reach
+     * them rather than leaving a sliver that looks like step size underflow
+     */
+    void TestAwkwardEndTimes()
+    {
+        DormandPrinceOdeSolver solver;
+        solver.SetInitialValues(1.0, 2.0);
+        auto zero_rhs = [](const Pair& v, double t, Pair& dvdt) { dvdt = Pair(0.0, 0.0); };
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 11, 11*0.075350615031095552);
+        TS_ASSERT_THROWS_NOTHING( solver.Solve(zero_rhs) );
+        TS_ASSERT_EQUALS(solver.GetTimeTrace().back(), 11*0.075350615031095552);
+
+        // Step sizes from a fixed sequence between 0.01 and 1, on the circle as well
+        unsigned seed = 12345u;
+        const int num_steps[3] = {11, 111, 1111};
+        for (int i=0; i<3; i++)
+        {
+            for (int j=0; j<100; j++)
+            {
+                seed = 1664525u*seed + 1013904223u;
+                const double dt = 0.01 + 0.99*(seed/4294967296.0);
+                const double end_time = num_steps[i]*dt;
+                solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps[i], end_time);
+                TS_ASSERT_THROWS_NOTHING( solver.Solve(zero_rhs) );
+                TS_ASSERT_EQUALS(solver.GetTimeTrace().back(), end_time);
+                TS_ASSERT_EQUALS(solver.GetXTrace().back(), 1.0);
+                if (i == 0)
+                {
+                    solver.SetRhsFunction( &RhsCircle );
+                    TS_ASSERT_THROWS_NOTHING( solver.Solve() );
+                    TS_ASSERT_EQUALS(solver.GetTimeTrace().back(), end_time);
+                    TS_ASSERT_DELTA(solver.GetXTrace().back(), cos(end_time) - 2.0*sin(end_time), 1e-4);
+                }
+            }
+        }
+    }
+
+    /**
+     * A tiny first trial step says nothing about how many steps will be taken, so no room is
+     * reserved for that many
+     */
+    void TestTinyFirstStep()
+    {
+        DormandPrinceOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetInitialTimeDeltaTimeAndFinalTime(0.0, 1e-8, 20.0);
+        TS_ASSERT_THROWS_NOTHING( solver.Solve() );
+        TS_ASSERT_LESS_THAN(solver.GetNumberOfAcceptedSteps(), 1000);
+        TS_ASSERT_EQUALS(solver.GetTimeTrace().back(), 20.0);
+        TS_ASSERT_DELTA(solver.GetXTrace().back(), cos(20.0), 1e-4);
+        if (solver.GetStats().enabled)
+        {
+            TS_ASSERT_LESS_THAN(solver.GetStats().peakTraceBytes, 1000*(sizeof(double) + sizeof(Pair)));
+        }
+
+        // Nor for that many dense output interpolants
+        solver.SetInitialTimeDeltaTimeAndFinalTime(0.0, 1e-7, 20.0);
+        solver.SetDenseOutput(true);
+        TS_ASSERT_THROWS_NOTHING( solver.Solve() );
+        TS_ASSERT_LESS_THAN(solver.GetNumberOfAcceptedSteps(), 1000);
+        for (double t=0.0; t<=20.0; t+=0.5)
+        {
+            TS_ASSERT_DELTA(solver.Evaluate(t).x, cos(t), 1e-4);
+            TS_ASSERT_DELTA(solver.Evaluate(t).y, sin(t), 1e-4);
+        }
+    }
+
+    /** Van der Pol: same accuracy as a fine fixed-step RK4 run, for far fewer steps */
+    void TestVanderPolAgainstRK4()
+    {
+        const double end_time = 20.0;
+        RK4Solver reference_solver;
+        reference_solver.SetInitialValues(1.0, 0.0);
+        reference_solver.SetRhsFunction( &RhsVanderPol );
+        reference_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 200000, end_time);
+        reference_solver.Solve();
+
+        DormandPrinceOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetRhsFunction( &RhsVanderPol );
+        solver.SetTolerances(1e-9, 1e-9);
+        solver.SetInitialTimeDeltaTimeAndFinalTime(0.0, 0.01, end_time);
+        solver.Solve();
+
+        TS_ASSERT_DELTA(solver.GetXTrace().back(), reference_solver.GetXTrace().back(), 1e-6);
+        TS_ASSERT_DELTA(solver.GetYTrace().back(), reference_solver.GetYTrace().back(), 1e-6);
+        TS_ASSERT_LESS_THAN(solver.GetNumberOfAcceptedSteps() + solver.GetNumberOfRejectedSteps(), 20000);
+#ifndef ODE_DISABLE_STATS
+        // Six new stages per attempted step, plus the first
+        SolverStats stats = solver.GetStats();
+        TS_ASSERT_EQUALS(stats.stepsTaken, (unsigned long long) solver.GetNumberOfAcceptedSteps());
+        TS_ASSERT_EQUALS(stats.rhsEvaluations,
+                         6ull*(solver.GetNumberOfAcceptedSteps() + solver.GetNumberOfRejectedSteps()) + 1);
+
+        // The traces grew as they went: the peak counts the old block of each reallocated trace
+        std::vector<double> times;
+        std::vector<Pair> values;
+        std::size_t peak_bytes = 0;
+        for (std::size_t i=0; i<solver.GetTimeTrace().size(); i++)
+        {
+            std::size_t old_bytes = (times.size() == times.capacity()) ? times.capacity()*sizeof(double) : 0;
+            times.push_back(0.0);
+            peak_bytes = std::max(peak_bytes, times.capacity()*sizeof(double) + values.capacity()*sizeof(Pair) + old_bytes);
+            old_bytes = (values.size() == values.capacity()) ? values.capacity()*sizeof(Pair) : 0;
+            values.push_back(Pair());
+            peak_bytes = std::max(peak_bytes, times.capacity()*sizeof(double) + values.capacity()*sizeof(Pair) + old_bytes);
+        }
+        TS_ASSERT_LESS_THAN(0ull, stats.traceReallocations);
+        TS_ASSERT_EQUALS(stats.peakTraceBytes, peak_bytes);
+#endif
+
+        TS_ASSERT_THROWS_NOTHING( solver.DumpToFile("./tempfile.txt") );
+    }
+};
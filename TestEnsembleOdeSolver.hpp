@@ -0,0 +1,256 @@
+#include <cxxtest/TestSuite.h>
+
+#include "AbstractOdeSolver.hpp"
+#include "RK4Solver.hpp"
+#include "EnsembleOdeSolver.hpp"
+#include "StageKernels.hpp"
+
+/*
+ * x' = -y
+ * y' = +x
+ * You can solve this one as: dy/dx = (dy/dt)/(dx/dt) = -x/y.  Separate and integrate to give x^2 + y^2 = 2*c
+ */
+void RhsCircle(const Pair& v, double t, Pair& dvdt)
+{
+    dvdt.x = -v.y;
+    dvdt.y =  v.x;
+}
+
+/* The circle again, for a whole ensemble at once */
+void BatchRhsCircle(const double* x, const double* y, double t, double* dxdt, double* dydt, unsigned size)
+{
+    for (unsigned i=0; i<size; i++)
+    {
+        dxdt[i] = -y[i];
+        dydt[i] =  x[i];
+    }
+}
+
+/* The circle in single precision */
+void BatchRhsCircleFloat(const float* x, const float* y, double t, float* dxdt, float* dydt, unsigned size)
+{
+    for (unsigned i=0; i<size; i++)
+    {
+        dxdt[i] = -y[i];
+        dydt[i] =  x[i];
+    }
+}
+
+void RhsVanderPol(const Pair& v, double t, Pair& dvdt)
+{
+    double mu = 7;
+    dvdt.x = mu * (v.x - pow(v.x, 3) / 3.0 - v.y);
+    dvdt.y = v.x / mu;
+}
+
+void BatchRhsVanderPol(const double* x, const double* y, double t, double* dxdt, double* dydt, unsigned size)
+{
+    double mu = 7;
+    for (unsigned i=0; i<size; i++)
+    {
+        dxdt[i] = mu * (x[i] - x[i]*x[i]*x[i] / 3.0 - y[i]);
+        dydt[i] = x[i] / mu;
+    }
+}
+
+/**
+ * This test suite checks the ensemble solver against one RK4Solver per ensemble member
+ */
+class TestEnsembleOdeSolver : public CxxTest::TestSuite
+{
+private:
+    /*
+     * Private helper method.
+     * Solves every member with its own RK4Solver and checks the ensemble end values against them
+     */
+    void CompareWithScalarSolves(EnsembleOdeSolver& rEnsemble, const std::vector<double>& x0, const std::vector<double>& y0,
+                                 void (*pRhs)(const Pair&, double, Pair&), double tolerance)
+    {
+        std::vector<double> x = rEnsemble.GetFinalXValues();
+        std::vector<double> y = rEnsemble.GetFinalYValues();
+        TS_ASSERT_EQUALS(x.size(), x0.size());
+        TS_ASSERT_EQUALS(y.size(), y0.size());
+        for (unsigned i=0; i<x0.size(); i++)
+        {
+            RK4Solver solver;
+            solver.SetInitialValues(x0[i], y0[i]);
+            solver.SetRhsFunction(pRhs);
+            solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 2*M_PI);
+            solver.Solve();
+            TS_ASSERT_DELTA(x[i], solver.GetXTrace().back(), tolerance);
+            TS_ASSERT_DELTA(y[i], solver.GetYTrace().back(), tolerance);
+        }
+    }
+
+    /**
+     * The vector stage kernels (when the test is built with VECTOR_FLAGS) against the plain loops,
+     * for sizes from none to several registers, with and without a remainder.  They differ only by
+     * the rounding of the fused multiply-adds.
+     */
+    template<class T>
+    void CheckStageKernels(std::size_t lanes, double tolerance)
+    {
+        const double dt = 0.01;
+        for (std::size_t size=0; size<=3*lanes + 3; size++)
+        {
+            std::vector<T> v(size), k1(size), k2(size), k3(size), k4(size);
+            for (std::size_t i=0; i<size; i++)
+            {
+                v[i] = T(sin(i + 1.0));
+                k1[i] = T(cos(i + 1.0));
+                k2[i] = T(-0.5)*v[i];
+                k3[i] = T(2.0)*k1[i];
+                k4[i] = v[i] - k1[i];
+            }
+            std::vector<T> vector_values(size), scalar_values(size);
+            StageValues(vector_values.data(), v.data(), 0.5*dt, k1.data(), size);
+            StageValuesScalar(scalar_values.data(), v.data(), 0.5*dt, k1.data(), 0, size);
+            for (std::size_t i=0; i<size; i++)
+            {
+                TS_ASSERT_DELTA(vector_values[i], scalar_values[i], tolerance);
+            }
+
+            vector_values = v;
+            scalar_values = v;
+            CombineStages(vector_values.data(), dt, k1.data(), k2.data(), k3.data(), k4.data(), size);
+            CombineStagesScalar(scalar_values.data(), dt, k1.data(), k2.data(), k3.data(), k4.data(), 0, size);
+            for (std::size_t i=0; i<size; i++)
+            {
+                TS_ASSERT_DELTA(vector_values[i], scalar_values[i], tolerance);
+            }
+        }
+    }
+
+public:
+    void TestSetup()
+    {
+        EnsembleOdeSolver solver;
+        solver.SetBatchRhsFunction( &BatchRhsCircle );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10, 1.0);
+        // No ensemble yet
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+        TS_ASSERT_THROWS_ANYTHING( solver.GetFinalXValues() );
+
+        std::vector<double> x(3, 1.0), y(2, 0.0);
+        TS_ASSERT_THROWS_ANYTHING( solver.SetEnsembleInitialValues(x, y) );
+        TS_ASSERT_THROWS_ANYTHING( solver.SetEnsembleInitialValues(std::vector<double>(), std::vector<double>()) );
+
+        y.push_back(0.0);
+        solver.SetEnsembleInitialValues(x, y);
+        TS_ASSERT_EQUALS(solver.GetEnsembleSize(), 3u);
+
+        // No right-hand side of either kind
+        EnsembleOdeSolver no_rhs_solver;
+        no_rhs_solver.SetEnsembleInitialValues(x, y);
+        no_rhs_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10, 1.0);
+        TS_ASSERT_THROWS_ANYTHING( no_rhs_solver.Solve() );
+    }
+
+    /** Double and single precision stage kernels against the plain loops */
+    void TestStageKernels()
+    {
+        CheckStageKernels<double>(STAGE_KERNEL_DOUBLE_LANES, 1e-15);
+        CheckStageKernels<float>(STAGE_KERNEL_FLOAT_LANES, 1e-6);
+    }
+
+    /** The ensemble should agree with individual RK4 solves (up to rounding from fused multiply-adds) */
+    void TestCircleAgainstRK4()
+    {
+        // An awkward size, so that the vector kernels have a scalar remainder
+        const unsigned size = 37;
+        std::vector<double> x0, y0;
+        for (unsigned i=0; i<size; i++)
+        {
+            x0.push_back(1.0 + 0.1*i);
+            y0.push_back(-0.05*i);
+        }
+
+        EnsembleOdeSolver solver;
+        solver.SetEnsembleInitialValues(x0, y0);
+        solver.SetBatchRhsFunction( &BatchRhsCircle );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 2*M_PI);
+        solver.Solve();
+        CompareWithScalarSolves(solver, x0, y0, &RhsCircle, 1e-12);
+
+        // The traces follow the first member round the unit circle
+        std::vector<double> times = solver.GetTimeTrace();
+        std::vector<double> x = solver.GetXTrace();
+        std::vector<double> y = solver.GetYTrace();
+        TS_ASSERT_EQUALS(times.size(), 1001u);
+        TS_ASSERT_DELTA(times.back(), 2.0*M_PI, 2e-15);
+        for (unsigned i=0; i<times.size(); i++)
+        {
+            TS_ASSERT_DELTA( x[i], cos(times[i]), 1e-10);
+            TS_ASSERT_DELTA( y[i], sin(times[i]), 1e-10);
+        }
+
+        // Without a batched right-hand side the per-member one gives the same answers
+        EnsembleOdeSolver fallback_solver;
+        fallback_solver.SetEnsembleInitialValues(x0, y0);
+        fallback_solver.SetRhsFunction( &RhsCircle );
+        fallback_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 2*M_PI);
+        fallback_solver.Solve();
+        CompareWithScalarSolves(fallback_solver, x0, y0, &RhsCircle, 1e-12);
+    }
+
+    void TestVanderPolAgainstRK4()
+    {
+        std::vector<double> x0, y0;
+        for (unsigned i=0; i<16; i++)
+        {
+            x0.push_back(-2.0 + 0.25*i);
+            y0.push_back(0.5);
+        }
+
+        EnsembleOdeSolver solver;
+        solver.SetEnsembleInitialValues(x0, y0);
+        solver.SetBatchRhsFunction( &BatchRhsVanderPol );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 2*M_PI);
+        solver.Solve();
+        CompareWithScalarSolves(solver, x0, y0, &RhsVanderPol, 1e-10);
+    }
+
+    void TestSinglePrecision()
+    {
+        // Two registers of floats and a few more, so that the float vector kernels (built with
+        // VECTOR_FLAGS) and the remainder loops are both used
+        const unsigned size = 2*STAGE_KERNEL_FLOAT_LANES + 5;
+        std::vector<double> x0, y0;
+        std::vector<float> x0_float, y0_float;
+        for (unsigned i=0; i<size; i++)
+        {
+            x0.push_back(1.0 + 0.1*i);
+            y0.push_back(-0.5);
+            x0_float.push_back(x0.back());
+            y0_float.push_back(y0.back());
+        }
+
+        EnsembleOdeSolver double_solver;
+        double_solver.SetEnsembleInitialValues(x0, y0);
+        double_solver.SetBatchRhsFunction( &BatchRhsCircle );
+        double_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 2*M_PI);
+        double_solver.Solve();
+
+        MixedEnsembleOdeSolver mixed_solver;
+        mixed_solver.SetEnsembleInitialValues(x0_float, y0_float);
+        mixed_solver.SetBatchRhsFunction( &BatchRhsCircleFloat );
+        mixed_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 2*M_PI);
+        mixed_solver.Solve();
+
+        FloatEnsembleOdeSolver float_solver;
+        float_solver.SetEnsembleInitialValues(x0_float, y0_float);
+        float_solver.SetRhsFunction([](const FloatPair& v, double t, FloatPair& dvdt) { dvdt.x = -v.y; dvdt.y = v.x; });
+        float_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 2*M_PI);
+        float_solver.Solve();
+
+        std::vector<double> x = double_solver.GetFinalXValues();
+        std::vector<float> mixed_x = mixed_solver.GetFinalXValues();
+        std::vector<float> float_x = float_solver.GetFinalXValues();
+        for (unsigned i=0; i<x.size(); i++)
+        {
+            TS_ASSERT_DELTA(mixed_x[i], x[i], 1e-5*x0[i]);
+            TS_ASSERT_DELTA(float_x[i], x[i], 1e-5*x0[i]);
+        }
+        TS_ASSERT(mixed_solver.GetTimeTrace() == double_solver.GetTimeTrace());
+    }
+};
@@ -0,0 +1,300 @@
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <vector>
+
+#include "AbstractOdeSolver.hpp"
+#include "ConvergenceStudy.hpp"
+#include "ExplicitRungeKuttaOdeSolver.hpp"
+#include "ForwardEulerOdeSolver.hpp"
+#include "HigherOrderOdeSolver.hpp"
+#include "RK4Solver.hpp"
+
+/*
+ * x' = -y
+ * y' = +x
+ * You can solve this one as: dy/dx = (dy/dt)/(dx/dt) = -x/y.  Separate and integrate to give x^2 + y^2 = 2*c
+ */
+void RhsCircle(const Pair& v, double t, Pair& dvdt)
+{
+    dvdt.x = -v.y;
+    dvdt.y =  v.x;
+}
+
+/** x' = x*cos(t), y' = -y, a non-autonomous problem with x = exp(sin(t)), y = exp(-t) */
+void RhsExpSin(const Pair& v, double t, Pair& dvdt)
+{
+    dvdt.x = v.x*cos(t);
+    dvdt.y = -v.y;
+}
+
+/**
+ * This test suite is about the explicit Runge-Kutta solvers built from Butcher tableaux
+ */
+class TestExplicitRungeKuttaOdeSolvers : public CxxTest::TestSuite
+{
+private:
+    /** Checks the tableau's coefficients are consistent: the rows of A sum to C, and B sums to one */
+    template<class TABLEAU>
+    void CheckTableau()
+    {
+        double weights = 0.0;
+        for (int i=0; i<TABLEAU::STAGES; i++)
+        {
+            double row = 0.0;
+            for (int j=0; j<i; j++)
+            {
+                row += TABLEAU::A[i][j];
+            }
+            TS_ASSERT_DELTA(row, TABLEAU::C[i], 1e-15);
+            weights += TABLEAU::B[i];
+        }
+        TS_ASSERT_DELTA(weights, 1.0, 1e-15);
+        TS_ASSERT(IsExplicitTableau<TABLEAU>());
+    }
+
+    /** Observed order of the solver on a non-autonomous problem, from 64 to 1024 steps */
+    template<class SOLVER>
+    std::vector<ConvergenceResult> Convergence()
+    {
+        std::vector<double> step_sizes;
+        for (int num_steps=64; num_steps<=1024; num_steps*=2)
+        {
+            step_sizes.push_back(2.0/num_steps);
+        }
+        ConvergenceStudy<SOLVER> study;
+        study.SetInitialValues(Pair(1.0, 1.0));
+        study.SetInitialAndFinalTime(0.0, 2.0);
+        study.SetStepSizes(step_sizes);
+        study.SetAnalyticSolution([](double t) { return Pair(exp(sin(t)), exp(-t)); });
+        study.SetOrder(SOLVER::Tableau::ORDER);
+        study.SetNumberOfThreads(2);
+        study.Run(&RhsExpSin);
+        return study.GetResults();
+    }
+
+    /** Final values on the circle after 100 steps */
+    Pair SolveCircle(AbstractOdeSolver& rSolver)
+    {
+        rSolver.SetInitialValues(1.0, 0.0);
+        rSolver.SetRhsFunction(&RhsCircle);
+        rSolver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100, 2*M_PI);
+        rSolver.Solve();
+        return Pair(rSolver.GetXTrace().back(), rSolver.GetYTrace().back());
+    }
+
+    /** The stepper goes through the same points as Solve() and keeps no trace */
+    template<class SOLVER>
+    void CheckStepperMatchesSolve()
+    {
+        SOLVER solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetRhsFunction(&RhsCircle);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100, 2*M_PI);
+        auto stepper = solver.GetStepper();
+        stepper.AdvanceToEnd();
+        TS_ASSERT_THROWS_ANYTHING( solver.GetTimeTrace() );
+        stepper.Reset();
+        solver.Solve();
+        std::vector<double> time = solver.GetTimeTrace();
+        std::vector<double> x = solver.GetXTrace();
+        std::vector<double> y = solver.GetYTrace();
+
+        // One step at a time
+        TS_ASSERT_EQUALS(stepper.GetTime(), 0.0);
+        TS_ASSERT_EQUALS(stepper.GetValues().x, 1.0);
+        for (int i=1; i<=100; i++)
+        {
+            TS_ASSERT(stepper.Step());
+            TS_ASSERT_EQUALS(stepper.GetStepIndex(), i);
+            TS_ASSERT_EQUALS(stepper.GetTime(), time[i]);
+            TS_ASSERT_EQUALS(stepper.GetValues().x, x[i]);
+            TS_ASSERT_EQUALS(stepper.GetValues().y, y[i]);
+        }
+        TS_ASSERT(stepper.IsFinished());
+        TS_ASSERT(!stepper.Step());
+        TS_ASSERT_EQUALS(stepper.GetTime(), time[100]);
+
+        // N steps at a time, stopping at the end
+        stepper.Reset();
+        TS_ASSERT_EQUALS(stepper.Advance(30), 30);
+        TS_ASSERT_EQUALS(stepper.GetValues().x, x[30]);
+        TS_ASSERT_EQUALS(stepper.Advance(0), 0);
+        TS_ASSERT_EQUALS(stepper.Advance(100), 70);
+        TS_ASSERT_EQUALS(stepper.GetValues().y, y[100]);
+        TS_ASSERT_EQUALS(stepper.Advance(1), 0);
+
+        // As a range, from wherever the stepper has got to
+        stepper.Reset();
+        stepper.Advance(10);
+        int i = 10;
+        for (const auto& point : stepper)
+        {
+            TS_ASSERT_EQUALS(point.time, time[i]);
+            TS_ASSERT_EQUALS(point.values.x, x[i]);
+            i++;
+        }
+        TS_ASSERT_EQUALS(i, 101);
+    }
+
+public:
+    void TestTableaux()
+    {
+        CheckTableau<ForwardEulerTableau>();
+        CheckTableau<MidpointTableau>();
+        CheckTableau<HeunTableau>();
+        CheckTableau<RalstonTableau>();
+        CheckTableau<SspRungeKutta3Tableau>();
+        CheckTableau<RungeKutta4Tableau>();
+        CheckTableau<RungeKutta38Tableau>();
+    }
+
+    void TestNames()
+    {
+        // The original solvers keep their names (which are in checkpoints and benchmark results)
+        TS_ASSERT_EQUALS(ForwardEulerOdeSolver().GetSolverName(), "ForwardEuler");
+        TS_ASSERT_EQUALS(HigherOrderOdeSolver().GetSolverName(), "RungeKutta2");
+        TS_ASSERT_EQUALS(RK4Solver().GetSolverName(), "RungeKutta4");
+        TS_ASSERT_EQUALS(HeunOdeSolver().GetSolverName(), "Heun");
+        TS_ASSERT_EQUALS(RalstonOdeSolver().GetSolverName(), "Ralston");
+        TS_ASSERT_EQUALS(SspRungeKutta3OdeSolver().GetSolverName(), "SspRungeKutta3");
+        TS_ASSERT_EQUALS(RungeKutta38OdeSolver().GetSolverName(), "RungeKutta38");
+    }
+
+    void TestStagesMatchHandWrittenSteps()
+    {
+        // One step of each of the original solvers, written out by hand
+        const double dt = 0.1;
+        const Pair v(0.3, 1.2);
+        Pair k1, k2, k3, k4;
+        RhsExpSin(v, 0.5, k1);
+        Pair euler = v + k1*dt;
+        RhsExpSin(v + k1*(0.5*dt), 0.5 + 0.5*dt, k2);
+        Pair midpoint = v + k2*dt;
+        RhsExpSin(v + k2*(0.5*dt), 0.5 + 0.5*dt, k3);
+        RhsExpSin(v + k3*dt, 0.5 + dt, k4);
+        Pair rk4 = v + (k1/6.0 + k2/3.0 + k3/3.0 + k4/6.0)*dt;
+
+        void (*p_rhs)(const Pair&, double, Pair&) = &RhsExpSin;
+        Pair step = v;
+        ForwardEulerOdeSolver().TakeStep(p_rhs, 0.5, dt, step);
+        TS_ASSERT_EQUALS(step.x, euler.x); // Bit-identical
+        TS_ASSERT_EQUALS(step.y, euler.y);
+        step = v;
+        HigherOrderOdeSolver().TakeStep(p_rhs, 0.5, dt, step);
+        TS_ASSERT_EQUALS(step.x, midpoint.x);
+        TS_ASSERT_EQUALS(step.y, midpoint.y);
+        step = v;
+        RK4Solver().TakeStep(p_rhs, 0.5, dt, step);
+        TS_ASSERT_DELTA(step.x, rk4.x, 1e-15);
+        TS_ASSERT_DELTA(step.y, rk4.y, 1e-15);
+    }
+
+    void TestOrders()
+    {
+        std::vector<ConvergenceResult> heun = Convergence<HeunOdeSolver>();
+        std::vector<ConvergenceResult> ralston = Convergence<RalstonOdeSolver>();
+        std::vector<ConvergenceResult> ssp3 = Convergence<SspRungeKutta3OdeSolver>();
+        std::vector<ConvergenceResult> rk38 = Convergence<RungeKutta38OdeSolver>();
+        for (unsigned i=1; i<heun.size(); i++)
+        {
+            TS_ASSERT_DELTA(heun[i].observedOrder, 2.0, 0.05);
+            TS_ASSERT_DELTA(ralston[i].observedOrder, 2.0, 0.05);
+            TS_ASSERT_DELTA(ssp3[i].observedOrder, 3.0, 0.05);
+            TS_ASSERT_DELTA(rk38[i].observedOrder, 4.0, 0.1);
+        }
+        // Ralston's method minimises the error bound of the second order methods, and the 3/8 rule
+        // has smaller error constants than the classical method
+        std::vector<ConvergenceResult> rk4 = Convergence<RK4Solver>();
+        TS_ASSERT_LESS_THAN(ralston.back().maxError, heun.back().maxError);
+        TS_ASSERT_LESS_THAN(rk38.back().maxError, rk4.back().maxError);
+    }
+
+    void TestLinearProblemsAgree()
+    {
+        // On a linear problem a step of any two-stage second order method multiplies by the same
+        // polynomial, 1 + z + z^2/2, and likewise for the four-stage fourth order methods
+        HigherOrderOdeSolver midpoint_solver;
+        HeunOdeSolver heun_solver;
+        RalstonOdeSolver ralston_solver;
+        Pair midpoint = SolveCircle(midpoint_solver);
+        Pair heun = SolveCircle(heun_solver);
+        Pair ralston = SolveCircle(ralston_solver);
+        TS_ASSERT_DELTA(heun.x, midpoint.x, 1e-13);
+        TS_ASSERT_DELTA(heun.y, midpoint.y, 1e-13);
+        TS_ASSERT_DELTA(ralston.x, midpoint.x, 1e-13);
+        TS_ASSERT_DELTA(ralston.y, midpoint.y, 1e-13);
+
+        RK4Solver rk4_solver;
+        RungeKutta38OdeSolver rk38_solver;
+        Pair rk4 = SolveCircle(rk4_solver);
+        Pair rk38 = SolveCircle(rk38_solver);
+        TS_ASSERT_DELTA(rk38.x, rk4.x, 1e-13);
+        TS_ASSERT_DELTA(rk38.y, rk4.y, 1e-13);
+        TS_ASSERT_DELTA(rk4.x, 1.0, 1e-7);
+    }
+
+    void TestOtherDimensionsAndFeatures()
+    {
+        // Any state dimension, a lambda right-hand side, dense output and events all work as before
+        SspRungeKutta3OdeSolverT<State<3> > solver;
+        State<3> initial;
+        initial[0] = 1.0;
+        initial[1] = 2.0;
+        initial[2] = 3.0;
+        solver.SetInitialValues(initial);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 1.0);
+        solver.SetDenseOutput(true);
+        int stop = solver.AddEventFunction([](const State<3>& v, double t) { return t - 0.5; }, 1, 1);
+        const double rate = -2.0;
+        solver.Solve([rate](const State<3>& v, double t, State<3>& dvdt) { dvdt = v*rate; });
+        TS_ASSERT(solver.WasStoppedByEvent());
+        TS_ASSERT_DELTA(solver.GetEventTimes(stop)[0], 0.5, 1e-12);
+        for (int j=0; j<3; j++)
+        {
+            TS_ASSERT_DELTA(solver.Evaluate(0.25)[j], initial[j]*exp(-0.5), 1e-8);
+        }
+    }
+    void TestSteppers()
+    {
+        CheckStepperMatchesSolve<ForwardEulerOdeSolver>();
+        CheckStepperMatchesSolve<HigherOrderOdeSolver>();
+        CheckStepperMatchesSolve<RK4Solver>();
+
+        // Setup errors
+        RK4Solver solver;
+        TS_ASSERT_THROWS_ANYTHING( solver.GetStepper() );
+        solver.SetRhsFunction(&RhsCircle);
+        TS_ASSERT_THROWS_ANYTHING( solver.GetStepper() );
+
+        // A lambda right-hand side, any dimension, and leaving a range early
+        RK4SolverT<State<3> > solver_3d;
+        State<3> initial;
+        initial[0] = 1.0;
+        initial[1] = 2.0;
+        initial[2] = 3.0;
+        solver_3d.SetInitialValues(initial);
+        solver_3d.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 1.0);
+        const double rate = -2.0;
+        auto stepper = solver_3d.GetStepper([rate](const State<3>& v, double t, State<3>& dvdt) { dvdt = v*rate; });
+        // Changes to the solver after the stepper is made don't affect it
+        solver_3d.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10, 1.0);
+        TS_ASSERT_EQUALS(stepper.GetNumberOfTimeSteps(), 1000);
+        for (const auto& point : stepper)
+        {
+            if (point.time > 0.4999)
+            {
+                break;
+            }
+        }
+        TS_ASSERT_EQUALS(stepper.GetStepIndex(), 500);
+        TS_ASSERT_DELTA(stepper.GetValues()[2], 3.0*exp(-1.0), 1e-10);
+        stepper.AdvanceToEnd();
+        TS_ASSERT(stepper.IsFinished());
+        TS_ASSERT_DELTA(stepper.GetTime(), 1.0, 1e-12);
+        for (int j=0; j<3; j++)
+        {
+            TS_ASSERT_DELTA(stepper.GetValues()[j], initial[j]*exp(-2.0), 1e-10);
+        }
+    }
+};
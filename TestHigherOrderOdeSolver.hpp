@@ -2,6 +2,7 @@
 #include <fstream>
 
 #include "AbstractOdeSolver.hpp"
+#include "ConvergenceStudy.hpp"
 #include "ForwardEulerOdeSolver.hpp"
 #include "HigherOrderOdeSolver.hpp"
 /**
@@ -41,9 +42,10 @@ private:
 
         pSolver->Solve();
 
-        std::vector<double> times = pSolver->GetTimeTrace();
-        std::vector<double> x = pSolver->GetXTrace();
-        std::vector<double> y = pSolver->GetYTrace();
+        // Views rather than copies of the traces
+        TraceView times = pSolver->GetTimeView();
+        TraceView x = pSolver->GetXView();
+        TraceView y = pSolver->GetYView();
         double sum_square_error = 0.0;
         for (unsigned i=0; i<times.size();i++)
         {
@@ -127,23 +129,28 @@ public:
      }
 
      void TestErrorofSolver() {
-          // Load the solver
-          HigherOrderOdeSolver hi_solver;
-
-          std::ofstream write_output("errors_hi.txt", std::ofstream::out);
-          if (write_output.is_open() == false) {
-              throw Exception("OdePost", "Can't open output file");
-          }
-          write_output.precision(10);
-
-          // For each timestep, output the L2Error for the solver
+          // Refine from one step round the circle to about 4 million, with the refinements run in parallel
+          std::vector<double> step_sizes;
           for (int num_steps=1; num_steps<5e6; num_steps*=2) {
-              hi_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI /* 2*pi is one circuit */);
-              double hi_error = SolveAndCalculateL2ErrorForCircle(&hi_solver);
-
-              write_output << 2*M_PI/num_steps << "\t" << hi_error << std::endl;
+              step_sizes.push_back(2*M_PI/num_steps);
           }
 
-          write_output.close();
-      }
+          ConvergenceStudy<HigherOrderOdeSolver> study;
+          study.SetInitialValues(Pair(1.0, 0.0));  // For a unit circle
+          study.SetInitialAndFinalTime(0.0, 2*M_PI /* 2*pi is one circuit */);
+          study.SetStepSizes(step_sizes);
+          study.SetAnalyticSolution([](double t) { return Pair(cos(t), sin(t)); });
+          study.SetOrder(2);
+          study.Run(&RhsCircle);
+
+          // For each timestep, output the L2Error for the solver (and the observed order and Richardson error)
+          study.WriteErrorTable("errors_hi.txt");
+
+          // Runge-Kutta RK2 has quadratic convergence, and extrapolation removes the leading error term
+          const std::vector<ConvergenceResult>& results = study.GetResults();
+          TS_ASSERT_EQUALS(results.size(), step_sizes.size());
+          TS_ASSERT_DELTA(results[10].stepSize, 2*M_PI/1024, 1e-15);
+          TS_ASSERT_DELTA(results[10].observedOrder, 2.0, 0.01);
+          TS_ASSERT_LESS_THAN(results[10].richardsonError, 0.01*results[10].maxError);
+     }
 };
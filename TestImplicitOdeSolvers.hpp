@@ -0,0 +1,265 @@
+#include <cxxtest/TestSuite.h>
+
+#include "AbstractOdeSolver.hpp"
+#include "RK4Solver.hpp"
+#include "DormandPrinceOdeSolver.hpp"
+#include "BackwardEulerOdeSolver.hpp"
+#include "Bdf2OdeSolver.hpp"
+#include "RosenbrockOdeSolver.hpp"
+
+/*
+ * x' = -y
+ * y' = +x
+ * You can solve this one as: dy/dx = (dy/dt)/(dx/dt) = -x/y.  Separate and integrate to give x^2 + y^2 = 2*c
+ */
+void RhsCircle(const Pair& v, double t, Pair& dvdt)
+{
+    dvdt.x = -v.y;
+    dvdt.y =  v.x;
+}
+
+/*
+ * Van der Pol with mu=1000, which is stiff: the fast eigenvalue of the Jacobian is about -mu*(x^2 - 1).
+ * Starting on the slow manifold y = x - x^3/3 at x=2, x drifts down to 1 (and then jumps) at t=807.
+ * Starting elsewhere there's first a fast layer, of width about 1/mu, which a fixed step can't resolve.
+ */
+const double STIFF_MU = 1000.0;
+const double STIFF_X0 = 2.0;
+const double STIFF_Y0 = -2.0/3.0;
+
+void RhsStiffVanderPol(const Pair& v, double t, Pair& dvdt)
+{
+    dvdt.x = STIFF_MU * (v.x - pow(v.x, 3) / 3.0 - v.y);
+    dvdt.y = v.x / STIFF_MU;
+}
+
+void JacobianStiffVanderPol(const Pair& v, double t, Jacobian& jacobian)
+{
+    jacobian(0, 0) = STIFF_MU * (1.0 - v.x*v.x);
+    jacobian(0, 1) = -STIFF_MU;
+    jacobian(1, 0) = 1.0 / STIFF_MU;
+    jacobian(1, 1) = 0.0;
+}
+
+/*
+ * Three decoupled linear decays, one of them stiff: v = (exp(-t), exp(-1000t), exp(-t/10))
+ */
+void RhsThreeStiffDecays(const State<3>& v, double t, State<3>& dvdt)
+{
+    dvdt[0] = -v[0];
+    dvdt[1] = -1000.0*v[1];
+    dvdt[2] = -0.1*v[2];
+}
+
+/**
+ * This test suite is about the implicit solvers for stiff problems
+ */
+class TestImplicitOdeSolvers : public CxxTest::TestSuite
+{
+private:
+    /** Maximum error over one circuit of the unit circle */
+    double CircleError(AbstractImplicitOdeSolverT<Pair>& rSolver, int numSteps)
+    {
+        rSolver.SetInitialValues(1.0, 0.0);
+        rSolver.SetRhsFunction( &RhsCircle );
+        rSolver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, numSteps, 2*M_PI);
+        rSolver.Solve();
+        std::vector<double> times = rSolver.GetTimeTrace();
+        std::vector<double> x = rSolver.GetXTrace();
+        std::vector<double> y = rSolver.GetYTrace();
+        double max_error = 0.0;
+        for (unsigned i=0; i<times.size(); i++)
+        {
+            max_error = std::max(max_error, fabs(x[i] - cos(times[i])));
+            max_error = std::max(max_error, fabs(y[i] - sin(times[i])));
+        }
+        return max_error;
+    }
+
+public:
+    void TestSetup()
+    {
+        BackwardEulerOdeSolver solver;
+        TS_ASSERT_THROWS_ANYTHING( solver.SetNewtonTolerance(0.0) );
+        TS_ASSERT_THROWS_ANYTHING( solver.SetMaximumNumberOfNewtonIterations(0) );
+        TS_ASSERT_THROWS_ANYTHING( solver.SetMaximumJacobianAge(0) );
+        TS_ASSERT_THROWS_NOTHING( solver.SetMaximumJacobianAge(1) );
+
+        // No right-hand side
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1, 1.0);
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+
+        // No time interval
+        Bdf2OdeSolver no_time_solver;
+        no_time_solver.SetRhsFunction( &RhsCircle );
+        TS_ASSERT_THROWS_ANYTHING( no_time_solver.Solve() );
+    }
+
+    /** The factorisation needs to pivot on this one */
+    void TestLuFactorisation()
+    {
+        JacobianT<State<3> > jacobian;
+        // I - J = [[0, 1, 2], [1, 0, 3], [4, -3, 8]]
+        jacobian(0, 0) = 1.0;  jacobian(0, 1) = -1.0; jacobian(0, 2) = -2.0;
+        jacobian(1, 0) = -1.0; jacobian(1, 1) = 1.0;  jacobian(1, 2) = -3.0;
+        jacobian(2, 0) = -4.0; jacobian(2, 1) = 3.0;  jacobian(2, 2) = -7.0;
+        LuFactorisationT<State<3> > lu;
+        lu.Factorise(jacobian, 1.0);
+
+        // Right-hand side for the solution (1, 2, 3)
+        State<3> x = {{8.0, 10.0, 22.0}};
+        lu.Solve(x);
+        TS_ASSERT_DELTA(x[0], 1.0, 1e-12);
+        TS_ASSERT_DELTA(x[1], 2.0, 1e-12);
+        TS_ASSERT_DELTA(x[2], 3.0, 1e-12);
+
+        // I - 0*J = I is fine, but I - 1*I is singular
+        JacobianT<State<3> > identity;
+        for (int i=0; i<3; i++)
+        {
+            identity(i, i) = 1.0;
+        }
+        TS_ASSERT_THROWS_NOTHING( lu.Factorise(identity, 0.0) );
+        TS_ASSERT_THROWS_ANYTHING( lu.Factorise(identity, 1.0) );
+    }
+
+    /** Backward Euler is first order, BDF2 and Rosenbrock second order */
+    void TestCircleConvergence()
+    {
+        BackwardEulerOdeSolver euler_solver;
+        Bdf2OdeSolver bdf2_solver;
+        RosenbrockOdeSolver rosenbrock_solver;
+        AbstractImplicitOdeSolverT<Pair>* solvers[3] = {&euler_solver, &bdf2_solver, &rosenbrock_solver};
+        double orders[3] = {1.0, 2.0, 2.0};
+        for (int i=0; i<3; i++)
+        {
+            double coarse_error = CircleError(*solvers[i], 1000);
+            double fine_error = CircleError(*solvers[i], 2000);
+            TS_ASSERT_LESS_THAN(fine_error, 0.1);
+            TS_ASSERT_DELTA(log2(coarse_error/fine_error), orders[i], 0.1);
+        }
+    }
+
+    /**
+     * Stiff Van der Pol, up to just before the first relaxation jump: RK4 is unstable at a step of
+     * 1.75, but the implicit solvers are accurate there
+     */
+    void TestStiffVanderPol()
+    {
+        const double end_time = 700.0;
+        const int num_steps = 400;
+        DormandPrinceOdeSolver reference_solver;
+        reference_solver.SetInitialValues(STIFF_X0, STIFF_Y0);
+        reference_solver.SetRhsFunction( &RhsStiffVanderPol );
+        reference_solver.SetTolerances(1e-10, 1e-10);
+        reference_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1, end_time);
+        reference_solver.SetStoreTrace(false);
+        FinalStateObserverT<Pair> reference;
+        reference_solver.AddObserver(&reference);
+        reference_solver.Solve();
+
+        RK4Solver rk4_solver;
+        rk4_solver.SetInitialValues(STIFF_X0, STIFF_Y0);
+        rk4_solver.SetRhsFunction( &RhsStiffVanderPol );
+        rk4_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, end_time);
+        rk4_solver.Solve();
+        TS_ASSERT(!(fabs(rk4_solver.GetXTrace().back() - reference.GetFinalValues().x) < 1.0));
+
+        BackwardEulerOdeSolver euler_solver;
+        Bdf2OdeSolver bdf2_solver;
+        RosenbrockOdeSolver rosenbrock_solver;
+        AbstractImplicitOdeSolverT<Pair>* solvers[3] = {&euler_solver, &bdf2_solver, &rosenbrock_solver};
+        double tolerances[3] = {2e-3, 1e-5, 1e-4};
+        for (int i=0; i<3; i++)
+        {
+            solvers[i]->SetInitialValues(STIFF_X0, STIFF_Y0);
+            solvers[i]->SetRhsFunction( &RhsStiffVanderPol );
+            solvers[i]->SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, end_time);
+            solvers[i]->Solve();
+            TS_ASSERT_DELTA(solvers[i]->GetXTrace().back(), reference.GetFinalValues().x, tolerances[i]);
+            TS_ASSERT_DELTA(solvers[i]->GetYTrace().back(), reference.GetFinalValues().y, tolerances[i]);
+        }
+        // The Newton solvers reuse the Jacobian
+        TS_ASSERT_LESS_THAN(euler_solver.GetNumberOfJacobianEvaluations(), num_steps/4);
+        TS_ASSERT_LESS_THAN(bdf2_solver.GetNumberOfJacobianEvaluations(), num_steps/4);
+        TS_ASSERT_EQUALS(rosenbrock_solver.GetNumberOfJacobianEvaluations(), num_steps);
+    }
+
+    /** An analytic Jacobian gives the same answer with fewer right-hand side evaluations */
+    void TestAnalyticJacobian()
+    {
+        Bdf2OdeSolver solver;
+        solver.SetInitialValues(STIFF_X0, STIFF_Y0);
+        solver.SetRhsFunction( &RhsStiffVanderPol );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 400, 700.0);
+        solver.SetMaximumJacobianAge(1);
+        solver.Solve();
+        std::vector<double> x = solver.GetXTrace();
+        SolverStats finite_difference_stats = solver.GetStats();
+        TS_ASSERT_EQUALS(solver.GetNumberOfJacobianEvaluations(), 400);
+
+        solver.SetJacobianFunction( &JacobianStiffVanderPol );
+        solver.Solve();
+        TS_ASSERT_DELTA(solver.GetXTrace().back(), x.back(), 1e-6);
+        TS_ASSERT_EQUALS(solver.GetNumberOfJacobianEvaluations(), 400);
+#ifndef ODE_DISABLE_STATS
+        // Only the Newton iterations evaluate the right-hand side: each finite difference Jacobian took three more
+        SolverStats stats = solver.GetStats();
+        TS_ASSERT_EQUALS(stats.rhsEvaluations, (unsigned long long) solver.GetNumberOfNewtonIterations());
+        TS_ASSERT_LESS_THAN(stats.rhsEvaluations + 2*400, finite_difference_stats.rhsEvaluations);
+#endif
+
+        // The Jacobian can also be a callable
+        RosenbrockOdeSolver rosenbrock_solver;
+        rosenbrock_solver.SetInitialValues(STIFF_X0, STIFF_Y0);
+        rosenbrock_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 400, 700.0);
+        int jacobian_calls = 0;
+        rosenbrock_solver.Solve(&RhsStiffVanderPol, [&](const Pair& v, double t, Jacobian& jacobian) {
+            jacobian_calls++;
+            JacobianStiffVanderPol(v, t, jacobian);
+        });
+        TS_ASSERT_EQUALS(jacobian_calls, rosenbrock_solver.GetNumberOfJacobianEvaluations());
+        TS_ASSERT_EQUALS(rosenbrock_solver.GetNumberOfNewtonIterations(), 0);
+        TS_ASSERT_DELTA(rosenbrock_solver.GetXTrace().back(), x.back(), 1e-3);
+    }
+
+    /** The Newton iteration can't get across the initial fast layer in one coarse step */
+    void TestNewtonFailure()
+    {
+        BackwardEulerOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetRhsFunction( &RhsStiffVanderPol );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10, 10.0);
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+
+        // But it's fine on the slow manifold
+        solver.SetInitialValues(STIFF_X0, STIFF_Y0);
+        TS_ASSERT_THROWS_NOTHING( solver.Solve() );
+    }
+
+    /** More than two variables, with a stiff component that the step doesn't resolve */
+    void TestThreeVariableSystem()
+    {
+        BackwardEulerOdeSolverT<State<3> > euler_solver;
+        Bdf2OdeSolverT<State<3> > bdf2_solver;
+        RosenbrockOdeSolverT<State<3> > rosenbrock_solver;
+        AbstractImplicitOdeSolverT<State<3> >* solvers[3] = {&euler_solver, &bdf2_solver, &rosenbrock_solver};
+        double tolerances[3] = {1e-2, 1e-3, 1e-3};
+
+        State<3> initial_values = {{1.0, 1.0, 1.0}};
+        for (int i=0; i<3; i++)
+        {
+            solvers[i]->SetInitialValues(initial_values);
+            solvers[i]->SetRhsFunction( &RhsThreeStiffDecays );
+            solvers[i]->SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100, 10.0);
+            solvers[i]->Solve();
+            std::vector<double> times = solvers[i]->GetTimeTrace();
+            std::vector<double> v0 = solvers[i]->GetComponentTrace(0);
+            std::vector<double> v1 = solvers[i]->GetComponentTrace(1);
+            std::vector<double> v2 = solvers[i]->GetComponentTrace(2);
+            TS_ASSERT_DELTA(v0.back(), exp(-times.back()), tolerances[i]);
+            TS_ASSERT_DELTA(v1.back(), 0.0, tolerances[i]);
+            TS_ASSERT_DELTA(v2.back(), exp(-0.1*times.back()), tolerances[i]);
+        }
+    }
+};
@@ -0,0 +1,204 @@
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <vector>
+
+#include "AbstractOdeSolver.hpp"
+#include "RK4Solver.hpp"
+#include "LargeSystemOdeSolver.hpp"
+
+/** The circle in the first two components and z' = -z + sin(t) in the third */
+void RangeRhsCircleAndForcing(const double* v, double t, double* dvdt, std::size_t begin, std::size_t end, std::size_t size)
+{
+    for (std::size_t i=begin; i<end; i++)
+    {
+        if (i == 0)
+        {
+            dvdt[i] = -v[1];
+        }
+        else if (i == 1)
+        {
+            dvdt[i] = v[0];
+        }
+        else
+        {
+            dvdt[i] = -v[i] + sin(t);
+        }
+    }
+}
+
+void RhsCircleAndForcing(const State<3>& v, double t, State<3>& dvdt)
+{
+    RangeRhsCircleAndForcing(&v[0], t, &dvdt[0], 0, 3, 3);
+}
+
+/**
+ * The 1-D heat equation u_t = u_xx on (0, 1) with u = 0 at both ends, by central differences on the
+ * size interior points x_i = (i + 1)/(size + 1)
+ */
+struct HeatEquation
+{
+    void operator()(const double* v, double t, double* dvdt, std::size_t begin, std::size_t end, std::size_t size) const
+    {
+        const double scale = (size + 1.0)*(size + 1.0);
+        for (std::size_t i=begin; i<end; i++)
+        {
+            double left = (i > 0) ? v[i - 1] : 0.0;
+            double right = (i + 1 < size) ? v[i + 1] : 0.0;
+            dvdt[i] = scale*(left - 2.0*v[i] + right);
+        }
+    }
+};
+
+/**
+ * This test suite checks the large system solver against RK4Solver and on the heat equation
+ */
+class TestLargeSystemOdeSolver : public CxxTest::TestSuite
+{
+private:
+    /** sin(pi*x) on the heat equation grid */
+    std::vector<double> HeatInitialValues(std::size_t size)
+    {
+        std::vector<double> values(size);
+        for (std::size_t i=0; i<size; i++)
+        {
+            values[i] = sin(M_PI*(i + 1.0)/(size + 1.0));
+        }
+        return values;
+    }
+
+public:
+    void TestSetup()
+    {
+        LargeSystemOdeSolver solver;
+        TS_ASSERT_EQUALS(solver.GetSolverName(), "LargeSystemRungeKutta4");
+        TS_ASSERT_THROWS_ANYTHING( solver.SetSystemInitialValues(std::vector<double>()) );
+        TS_ASSERT_THROWS_ANYTHING( solver.GetFinalValues() );
+
+        // No initial values, no right-hand side
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10, 1.0);
+        solver.SetSystemRhsFunction(HeatEquation());
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+        LargeSystemOdeSolver no_rhs_solver;
+        no_rhs_solver.SetSystemInitialValues(HeatInitialValues(10));
+        no_rhs_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10, 1.0);
+        TS_ASSERT_THROWS_ANYTHING( no_rhs_solver.Solve() );
+
+        // The traced components must be in the system
+        solver.SetSystemInitialValues(std::vector<double>(1, 1.0));
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+        solver.SetTracedComponents(0, 0);
+        solver.Solve();
+        TS_ASSERT_EQUALS(solver.GetSystemSize(), 1u);
+
+        // No events or checkpoints
+        solver.SetCheckpointing("./tempfile.chk", 5);
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+        solver.SetCheckpointing("./tempfile.chk", 0);
+        solver.AddEventFunction([](const Pair& v, double t) { return v.x - 0.5; }, 0, 1);
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+    }
+
+    /** The same steps as RK4Solver, up to rounding */
+    void TestAgainstRK4()
+    {
+        RK4SolverT<State<3> > rk4_solver;
+        State<3> initial;
+        initial[0] = 1.0;
+        initial[1] = 0.0;
+        initial[2] = 2.0;
+        rk4_solver.SetInitialValues(initial);
+        rk4_solver.SetRhsFunction( &RhsCircleAndForcing );
+        rk4_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100, 2*M_PI);
+        rk4_solver.Solve();
+
+        LargeSystemOdeSolver solver;
+        solver.SetSystemInitialValues(std::vector<double>(&initial[0], &initial[0] + 3));
+        solver.SetSystemRhsFunction( &RangeRhsCircleAndForcing );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100, 2*M_PI);
+        solver.SetTracedComponents(0, 2);
+        solver.Solve();
+
+        std::vector<double> time = solver.GetTimeTrace();
+        std::vector<double> x = solver.GetXTrace();
+        std::vector<double> z = solver.GetYTrace();
+        TS_ASSERT_EQUALS(time.size(), 101u);
+        for (unsigned i=0; i<=100; i++)
+        {
+            TS_ASSERT_EQUALS(time[i], rk4_solver.GetTimeView()[i]);
+            TS_ASSERT_DELTA(x[i], rk4_solver.GetComponentView(0)[i], 1e-13);
+            TS_ASSERT_DELTA(z[i], rk4_solver.GetComponentView(2)[i], 1e-13);
+        }
+        std::vector<double> final_values = solver.GetFinalValues();
+        for (unsigned i=0; i<3; i++)
+        {
+            TS_ASSERT_DELTA(final_values[i], rk4_solver.GetComponentView(i).back(), 1e-13);
+        }
+        if (solver.GetStats().enabled)
+        {
+            TS_ASSERT_EQUALS(solver.GetStats().rhsEvaluations, 400u);
+        }
+    }
+
+    /** Each component is worked out the same way whichever thread does it */
+    void TestThreadsGiveSameResults()
+    {
+        const std::size_t size = 100000;
+        std::vector<double> results[3];
+        const unsigned threads[3] = {1, 3, 4};
+        LargeSystemOdeSolver solver;
+        solver.SetSystemInitialValues(HeatInitialValues(size));
+        solver.SetSystemRhsFunction(HeatEquation());
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 20, 20*0.4/((size + 1.0)*(size + 1.0)));
+        for (unsigned i=0; i<3; i++)
+        {
+            solver.SetNumberOfThreads(threads[i]);
+            solver.Solve();
+            results[i] = solver.GetFinalValues();
+        }
+        TS_ASSERT_EQUALS(solver.GetWorkspaceBytes(), 7*size*sizeof(double));
+        for (unsigned i=1; i<3; i++)
+        {
+            TS_ASSERT_EQUALS(results[i].size(), size);
+            bool same = true;
+            for (std::size_t j=0; j<size; j++)
+            {
+                same = same && (results[i][j] == results[0][j]);
+            }
+            TS_ASSERT(same);
+        }
+    }
+
+    /** The semi-discrete solution is sin(pi*x_i)*exp(-lambda*t), for lambda = 4 (size + 1)^2 sin^2(pi/(2 (size + 1))) */
+    void TestHeatEquation()
+    {
+        const std::size_t size = 199;
+        const double dx = 1.0/(size + 1.0);
+        const double end_time = 0.1;
+        // The explicit stability limit is about dt < 0.7 dx^2
+        const int num_steps = (int) ceil(end_time/(0.5*dx*dx));
+
+        LargeSystemOdeSolver solver;
+        solver.SetSystemInitialValues(HeatInitialValues(size));
+        solver.SetSystemRhsFunction(HeatEquation());
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, end_time);
+        solver.SetTracedComponents(size/2, 0);
+        solver.Solve();
+
+        const double lambda = 4.0/(dx*dx)*pow(sin(M_PI*dx/2.0), 2);
+        std::vector<double> exact = HeatInitialValues(size);
+        std::vector<double> final_values = solver.GetFinalValues();
+        for (std::size_t i=0; i<size; i++)
+        {
+            TS_ASSERT_DELTA(final_values[i], exact[i]*exp(-lambda*end_time), 1e-12);
+            // The PDE's own solution, to within the spatial discretisation error
+            TS_ASSERT_DELTA(final_values[i], exact[i]*exp(-M_PI*M_PI*end_time), 1e-4);
+        }
+        TS_ASSERT_DELTA(solver.GetXTrace().back(), exp(-lambda*end_time), 1e-12);
+
+        // Too big a time step is unstable: rounding errors in the fastest modes grow by about 5 each step
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100, 100*dx*dx);
+        solver.Solve();
+        TS_ASSERT_LESS_THAN(1.0, fabs(solver.GetXTrace().back()));
+    }
+};
@@ -2,7 +2,10 @@
 #include <fstream>
 
 #include "AbstractOdeSolver.hpp"
+#include "ConvergenceStudy.hpp"
 #include "ForwardEulerOdeSolver.hpp"
+#include "HigherOrderOdeSolver.hpp"
+#include "RK4Solver.hpp"
 
 /**
  *
@@ -33,6 +36,19 @@ void RhsCircle(const Pair& v, double t, Pair& dvdt)
     dvdt.y =  v.x;
 }
 
+/*
+ * A three variable system
+ * x' = -x   gives x = exp(-t)
+ * y' = -2y  gives y = exp(-2t)
+ * z' = x    gives z = 1 - exp(-t)  (with z(0) = 0)
+ */
+void RhsThreeDecoupled(const State<3>& v, double t, State<3>& dvdt)
+{
+    dvdt[0] = -v[0];
+    dvdt[1] = -2.0*v[1];
+    dvdt[2] = v[0];
+}
+
 /**
  * For a guide to writing and running CxxTest: http://cxxtest.com/guide.html
  *
@@ -50,9 +66,10 @@ private:
 
         pSolver->Solve();
 
-        std::vector<double> times = pSolver->GetTimeTrace();
-        std::vector<double> x = pSolver->GetXTrace();
-        std::vector<double> y = pSolver->GetYTrace();
+        // Views rather than copies of the traces
+        TraceView times = pSolver->GetTimeView();
+        TraceView x = pSolver->GetXView();
+        TraceView y = pSolver->GetYView();
         double sum_square_error = 0.0;
         for (unsigned i=0; i<times.size();i++)
         {
@@ -308,23 +325,665 @@ public:
     }
 
     void TestErrorofSolver() {
-         // Load the solver
-         ForwardEulerOdeSolver euler_solver;
-
-         std::ofstream write_output("errors_euler.txt", std::ofstream::out);
-         if (write_output.is_open() == false) {
-             throw Exception("OdePost", "Can't open output file");
+         // Refine from one step round the circle to about 4 million, with the refinements run in parallel
+         std::vector<double> step_sizes;
+         for (int num_steps=1; num_steps<5e6; num_steps*=2) {
+             step_sizes.push_back(2*M_PI/num_steps);
          }
-         write_output.precision(10);
 
-         // For each timestep, output the L2Error for the solver
-         for (int num_steps=1; num_steps<5e6; num_steps*=2) {
-             euler_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI /* 2*pi is one circuit */);
-             double euler_error = SolveAndCalculateL2ErrorForCircle(&euler_solver);
+         ConvergenceStudy<ForwardEulerOdeSolver> study;
+         study.SetInitialValues(Pair(1.0, 0.0));  // For a unit circle
+         study.SetInitialAndFinalTime(0.0, 2*M_PI /* 2*pi is one circuit */);
+         study.SetStepSizes(step_sizes);
+         study.SetAnalyticSolution([](double t) { return Pair(cos(t), sin(t)); });
+         study.SetOrder(1);
+         study.Run(&RhsCircle);
+
+         // For each timestep, output the L2Error for the solver (and the observed order and Richardson error)
+         study.WriteErrorTable("errors_euler.txt");
+
+         // Euler has linear convergence, and extrapolation removes the leading error term
+         const std::vector<ConvergenceResult>& results = study.GetResults();
+         TS_ASSERT_EQUALS(results.size(), step_sizes.size());
+         TS_ASSERT_DELTA(results[16].stepSize, 2*M_PI/65536, 1e-15);
+         TS_ASSERT_DELTA(results[16].observedOrder, 1.0, 0.001);
+         TS_ASSERT_LESS_THAN(results[16].richardsonError, 0.001*results[16].maxError);
+    }
 
-             write_output << 2*M_PI/num_steps <<  "\t" << euler_error << std::endl;
-         }
+    /** Arithmetic on the fixed-size state types */
+    void TestStateArithmetic()
+    {
+        Pair a(1.0, 2.0);
+        Pair b = {3.0, 8.0};
+        TS_ASSERT_EQUALS(Pair::DIMENSION, 2);
+        TS_ASSERT_EQUALS(a[0], 1.0);
+        TS_ASSERT_EQUALS(a[1], 2.0);
+        Pair c = a + b*2.0;
+        TS_ASSERT_DELTA(c.x, 7.0, 1e-15);
+        TS_ASSERT_DELTA(c.y, 18.0, 1e-15);
+        c = b/a;
+        TS_ASSERT_DELTA(c.x, 3.0, 1e-15);
+        TS_ASSERT_DELTA(c.y, 4.0, 1e-15);
+        c = b - a/2.0;
+        TS_ASSERT_DELTA(c.x, 2.5, 1e-15);
+        TS_ASSERT_DELTA(c.y, 7.0, 1e-15);
+        c += a;
+        c *= b;
+        TS_ASSERT_DELTA(c.x, 10.5, 1e-15);
+        TS_ASSERT_DELTA(c.y, 72.0, 1e-15);
+
+        State<3> zero;
+        State<3> u = {{1.0, 2.0, 3.0}};
+        TS_ASSERT_EQUALS(State<3>::DIMENSION, 3);
+        TS_ASSERT_EQUALS(zero[2], 0.0);
+        State<3> w = 2.0*u + u*u;
+        TS_ASSERT_DELTA(w[0], 3.0, 1e-15);
+        TS_ASSERT_DELTA(w[1], 8.0, 1e-15);
+        TS_ASSERT_DELTA(w[2], 15.0, 1e-15);
+    }
+
+    /** The same solvers can be used on a system with more than two variables */
+    void TestThreeVariableSystem()
+    {
+        ForwardEulerOdeSolverT<State<3> > euler_solver;
+        HigherOrderOdeSolverT<State<3> > hi_solver;
+        RK4SolverT<State<3> > rk4_solver;
+        AbstractOdeSolverT<State<3> >* solvers[3] = {&euler_solver, &hi_solver, &rk4_solver};
+        double tolerances[3] = {1e-2, 1e-4, 1e-9};
+
+        State<3> initial_values = {{1.0, 1.0, 0.0}};
+        for (int i=0; i<3; i++)
+        {
+            solvers[i]->SetInitialValues(initial_values);
+            solvers[i]->SetRhsFunction( &RhsThreeDecoupled ); // See top of file for definition
+            solvers[i]->SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100, 1.0);
+            solvers[i]->Solve();
+
+            std::vector<double> times = solvers[i]->GetTimeTrace();
+            std::vector<double> z = solvers[i]->GetComponentTrace(2);
+            TS_ASSERT_EQUALS(z.size(), 101u);
+            TS_ASSERT_DELTA(solvers[i]->GetXTrace().back(), exp(-1.0),     tolerances[i]);
+            TS_ASSERT_DELTA(solvers[i]->GetYTrace().back(), exp(-2.0),     tolerances[i]);
+            TS_ASSERT_DELTA(z.back(),                     1.0 - exp(-1.0), tolerances[i]);
+            TS_ASSERT_THROWS_ANYTHING( solvers[i]->GetComponentTrace(3) );
+        }
+        TS_ASSERT_THROWS_NOTHING( rk4_solver.DumpToFile("./tempfile.txt") );
+    }
+
+    /** Observers see every step, and the solve can run without keeping the trace */
+    void TestObservers()
+    {
+        const int num_steps = 1000;
+        ForwardEulerOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);  // For a unit circle
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+        solver.Solve();
+        std::vector<double> times = solver.GetTimeTrace();
+        std::vector<double> x = solver.GetXTrace();
+        std::vector<double> y = solver.GetYTrace();
+
+        TS_ASSERT_THROWS_ANYTHING( solver.AddObserver(NULL) );
+        FinalStateObserverT<Pair> final_observer;
+        TS_ASSERT_THROWS_ANYTHING( final_observer.GetFinalValues() );
+        StrideObserverT<Pair> stride_observer(300);
+        TS_ASSERT_THROWS_ANYTHING( StrideObserverT<Pair>(0) );
+        FileStreamObserverT<Pair> file_observer("./tempfile.txt");
+        solver.AddObserver(&final_observer);
+        solver.AddObserver(&stride_observer);
+        solver.AddObserver(&file_observer);
+        solver.SetStoreTrace(false);
+        solver.Solve();
+
+        // Nothing stored in the solver
+        TS_ASSERT(solver.mTimeTrace.empty());
+        TS_ASSERT(solver.mSolutionTrace.empty());
+        TS_ASSERT_THROWS_ANYTHING( solver.GetTimeTrace() );
+        TS_ASSERT_THROWS_ANYTHING( solver.GetXTrace() );
+        TS_ASSERT_THROWS_ANYTHING( solver.DumpToFile("./tempfile.txt") );
+
+        // Final state
+        TS_ASSERT_EQUALS(final_observer.GetNumberOfObservations(), num_steps + 1);
+        TS_ASSERT_EQUALS(final_observer.GetFinalTime(), times.back());
+        TS_ASSERT_EQUALS(final_observer.GetFinalValues().x, x.back());
+        TS_ASSERT_EQUALS(final_observer.GetFinalValues().y, y.back());
+
+        // Points 0, 300, 600, 900 and then the final one
+        std::vector<double> stride_times = stride_observer.GetTimeTrace();
+        TS_ASSERT_EQUALS(stride_times.size(), 5u);
+        TS_ASSERT_EQUALS(stride_observer.GetSolutionTrace().size(), 5u);
+        TS_ASSERT_EQUALS(stride_times[3], times[900]);
+        TS_ASSERT_EQUALS(stride_observer.GetSolutionTrace()[3].x, x[900]);
+        TS_ASSERT_EQUALS(stride_times.back(), times.back());
+
+        // The streamed file matches the trace
+        std::ifstream read_input("./tempfile.txt");
+        double t, file_x, file_y;
+        int lines = 0;
+        while (read_input >> t >> file_x >> file_y)
+        {
+            TS_ASSERT_DELTA(t, times[lines], 1e-9);
+            TS_ASSERT_DELTA(file_x, x[lines], 1e-9);
+            TS_ASSERT_DELTA(file_y, y[lines], 1e-9);
+            lines++;
+        }
+        TS_ASSERT_EQUALS(lines, num_steps + 1);
+
+        // A second solve starts the observers again
+        solver.RemoveAllObservers();
+        solver.AddObserver(&final_observer);
+        solver.SetStoreTrace(true);
+        solver.Solve();
+        TS_ASSERT_EQUALS(final_observer.GetNumberOfObservations(), num_steps + 1);
+        TS_ASSERT_EQUALS(solver.GetTimeTrace().size(), times.size());
+    }
+
+    /** Zero crossings of x on the circle are at pi/2 + k*pi, found to well within the step size */
+    void TestEventFunctions()
+    {
+        RK4Solver solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100, 4*M_PI);
+        TS_ASSERT_THROWS_ANYTHING( solver.AddEventFunction(std::function<double(const Pair&, double)>()) );
+        TS_ASSERT_THROWS_ANYTHING( solver.AddEventFunction([](const Pair& v, double t) { return v.x; }, 0, -1) );
+        int any_crossing = solver.AddEventFunction([](const Pair& v, double t) { return v.x; });
+        int rising = solver.AddEventFunction([](const Pair& v, double t) { return v.x; }, 1);
+        int time_event = solver.AddEventFunction([](const Pair& v, double t) { return t - 1.0; });
+        solver.Solve();
+
+        // pi/2, 3pi/2, 5pi/2 and 7pi/2, of which 3pi/2 and 7pi/2 are rising
+        std::vector<double> crossings = solver.GetEventTimes(any_crossing);
+        TS_ASSERT_EQUALS(crossings.size(), 4u);
+        for (unsigned k=0; k<crossings.size(); k++)
+        {
+            TS_ASSERT_DELTA(crossings[k], M_PI/2 + k*M_PI, 1e-4);
+        }
+        std::vector<double> rising_crossings = solver.GetEventTimes(rising);
+        TS_ASSERT_EQUALS(rising_crossings.size(), 2u);
+        TS_ASSERT_EQUALS(rising_crossings[0], crossings[1]);
+        TS_ASSERT_EQUALS(rising_crossings[1], crossings[3]);
+        // A root of the interpolant, to rounding error
+        TS_ASSERT_EQUALS(solver.GetEventTimes(time_event).size(), 1u);
+        TS_ASSERT_DELTA(solver.GetEventTimes(time_event)[0], 1.0, 1e-14);
+        TS_ASSERT_THROWS_ANYTHING( solver.GetEventTimes(3) );
+
+        // In time order, with the solution at each
+        const std::vector<EventRecordT<Pair> >& events = solver.GetEvents();
+        TS_ASSERT_EQUALS(events.size(), 7u);
+        for (unsigned k=1; k<events.size(); k++)
+        {
+            TS_ASSERT_LESS_THAN_EQUALS(events[k - 1].time, events[k].time);
+        }
+        TS_ASSERT_EQUALS(events[0].eventIndex, time_event);
+        TS_ASSERT_DELTA(events[0].values.x, cos(1.0), 1e-5);
+        TS_ASSERT_EQUALS(events[1].eventIndex, any_crossing);
+        TS_ASSERT_DELTA(events[1].values.x, 0.0, 1e-12);
+        TS_ASSERT_DELTA(events[1].values.y, 1.0, 1e-5);
+        TS_ASSERT(!solver.WasStoppedByEvent());
+        TS_ASSERT_EQUALS(solver.GetTimeTrace().size(), 101u);
+
+        // Stop at the second rising crossing (the end of the second circuit) instead of running on
+        solver.RemoveAllEventFunctions();
+        solver.AddEventFunction([](const Pair& v, double t) { return v.y; }, 1, 2);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 1000, 100*M_PI);
+        solver.SetDenseOutput(true);
+        solver.Solve();
+        TS_ASSERT(solver.WasStoppedByEvent());
+        std::vector<double> times = solver.GetTimeTrace();
+        TS_ASSERT_LESS_THAN(times.size(), 50u);
+        TS_ASSERT_DELTA(times.back(), 4*M_PI, 1e-3);
+        TS_ASSERT_EQUALS(times.back(), solver.GetEvents().back().time);
+        TS_ASSERT_EQUALS(solver.GetYTrace().back(), solver.GetEvents().back().values.y);
+        TS_ASSERT_THROWS_NOTHING( solver.Evaluate(times.back()) );
+        TS_ASSERT_THROWS_ANYTHING( solver.Evaluate(times.back() + 0.1) );
+
+        // Not with checkpoints
+        solver.SetCheckpointing("./tempfile.chk", 10);
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+    }
+
+    /** Downsampling observers keep plotting-sized traces however many steps are taken */
+    void TestDownsamplingObservers()
+    {
+        const int num_steps = 100000;
+        ForwardEulerOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 20*M_PI);
+        solver.Solve();
+        std::vector<double> times = solver.GetTimeTrace();
+        std::vector<double> x = solver.GetXTrace();
+
+        TS_ASSERT_THROWS_ANYTHING( EnvelopeObserverT<Pair>(1) );
+        TS_ASSERT_THROWS_ANYTHING( LttbObserverT<Pair>(2) );
+        EnvelopeObserverT<Pair> envelope_observer(101);
+        LttbObserverT<Pair> lttb_observer(500);
+        solver.AddObserver(&envelope_observer);
+        solver.AddObserver(&lttb_observer);
+        solver.SetStoreTrace(false);
+        solver.Solve();
+
+        // Between half the maximum and the maximum (rounded down to 100), covering all the points in order
+        std::size_t buckets = envelope_observer.GetNumberOfBuckets();
+        long points_per_bucket = envelope_observer.GetPointsPerBucket();
+        TS_ASSERT_LESS_THAN_EQUALS(50u, buckets);
+        TS_ASSERT_LESS_THAN_EQUALS(buckets, 100u);
+        TS_ASSERT_LESS_THAN(points_per_bucket*(long(buckets) - 1), num_steps + 1);
+        TS_ASSERT_LESS_THAN_EQUALS(num_steps + 1, points_per_bucket*long(buckets));
+        TS_ASSERT_EQUALS(envelope_observer.GetStartTime(0), 0.0);
+        TS_ASSERT_EQUALS(envelope_observer.GetEndTime(buckets - 1), times.back());
+        double minimum_x = x[0], maximum_x = x[0];
+        for (std::size_t i=0; i<buckets; i++)
+        {
+            // The envelope of the trace in the bucket
+            std::size_t start = i*points_per_bucket;
+            std::size_t end = std::min(x.size(), start + points_per_bucket);
+            TS_ASSERT_EQUALS(envelope_observer.GetStartTime(i), times[start]);
+            TS_ASSERT_EQUALS(envelope_observer.GetEndTime(i), times[end - 1]);
+            TS_ASSERT_EQUALS(envelope_observer.GetMinimumValues(i).x, *std::min_element(&x[start], &x[0] + end));
+            TS_ASSERT_EQUALS(envelope_observer.GetMaximumValues(i).x, *std::max_element(&x[start], &x[0] + end));
+            minimum_x = std::min(minimum_x, envelope_observer.GetMinimumValues(i).x);
+            maximum_x = std::max(maximum_x, envelope_observer.GetMaximumValues(i).x);
+        }
+        TS_ASSERT_EQUALS(minimum_x, *std::min_element(x.begin(), x.end()));
+        TS_ASSERT_EQUALS(maximum_x, *std::max_element(x.begin(), x.end()));
+        TS_ASSERT_THROWS_NOTHING( envelope_observer.DumpToFile("./tempfile.txt") );
+
+        // LTTB chooses points from the trace, in order, keeping the ends and the peaks
+        const std::vector<double>& lttb_times = lttb_observer.GetTimeTrace();
+        const std::vector<Pair>& lttb_values = lttb_observer.GetSolutionTrace();
+        TS_ASSERT_EQUALS(lttb_times.size(), 500u);
+        TS_ASSERT_EQUALS(lttb_values.size(), 500u);
+        TS_ASSERT_EQUALS(lttb_times.front(), times.front());
+        TS_ASSERT_EQUALS(lttb_times.back(), times.back());
+        double lttb_maximum_x = x[0];
+        for (std::size_t i=0; i<lttb_times.size(); i++)
+        {
+            std::size_t index = std::lower_bound(times.begin(), times.end(), lttb_times[i]) - times.begin();
+            TS_ASSERT_EQUALS(times[index], lttb_times[i]);
+            TS_ASSERT_EQUALS(x[index], lttb_values[i].x);
+            if (i > 0)
+            {
+                TS_ASSERT_LESS_THAN(lttb_times[i - 1], lttb_times[i]);
+            }
+            lttb_maximum_x = std::max(lttb_maximum_x, lttb_values[i].x);
+        }
+        TS_ASSERT_DELTA(lttb_maximum_x, maximum_x, 1e-3);
+
+        // The chosen points are written like DumpToFile()
+        lttb_observer.DumpToFile("./tempfile.txt");
+        std::ifstream read_input("./tempfile.txt");
+        double t, file_x, file_y;
+        int lines = 0;
+        while (read_input >> t >> file_x >> file_y)
+        {
+            lines++;
+        }
+        TS_ASSERT_EQUALS(lines, 500);
+
+        // Fewer steps than points: all of them are kept
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100, 2*M_PI);
+        solver.Solve();
+        TS_ASSERT_EQUALS(lttb_observer.GetTimeTrace().size(), 101u);
+        TS_ASSERT_EQUALS(envelope_observer.GetNumberOfBuckets(), 51u);
+        TS_ASSERT_EQUALS(envelope_observer.GetPointsPerBucket(), 2);
+    }
+
+    /** Zero-copy access to the traces, in both storage layouts */
+    void TestTraceViewsAndLayouts()
+    {
+        const int num_steps = 100;
+        ForwardEulerOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);  // For a unit circle
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+        TS_ASSERT_THROWS_ANYTHING( solver.GetXView() );
+        solver.Solve();
+
+        // The traces were sized once, up front
+        TS_ASSERT_EQUALS(solver.mTimeTrace.capacity(), num_steps + 1u);
+        TS_ASSERT_EQUALS(solver.mSolutionTrace.capacity(), num_steps + 1u);
+
+        std::vector<double> times = solver.GetTimeTrace();
+        std::vector<double> x = solver.GetXTrace();
+        std::vector<double> y = solver.GetYTrace();
+        TraceView time_view = solver.GetTimeView();
+        TraceView x_view = solver.GetXView();
+        TraceView y_view = solver.GetYView();
+        TS_ASSERT_EQUALS(time_view.size(), times.size());
+        TS_ASSERT_EQUALS(x_view.size(), x.size());
+        TS_ASSERT_EQUALS(time_view.stride(), 1u);
+        TS_ASSERT_EQUALS(x_view.stride(), 2u);
+        TS_ASSERT_EQUALS(&x_view[0], &solver.mSolutionTrace[0].x); // No copy
+        TS_ASSERT_THROWS_ANYTHING( solver.GetComponentView(2) );
+        unsigned i = 0;
+        for (double value : y_view)
+        {
+            TS_ASSERT_EQUALS(value, y[i]);
+            TS_ASSERT_EQUALS(x_view[i], x[i]);
+            TS_ASSERT_EQUALS(time_view[i], times[i]);
+            i++;
+        }
+        TS_ASSERT_EQUALS(i, y.size());
+        TS_ASSERT_EQUALS(y_view.back(), y.back());
+
+        // Hand the buffers over
+        const double* p_time_data = time_view.data();
+        SolutionTraceT<Pair> trace = solver.TakeTrace();
+        TS_ASSERT_EQUALS(trace.times.data(), p_time_data);
+        TS_ASSERT_EQUALS(trace.solution.size(), x.size());
+        TS_ASSERT_EQUALS(trace.solution.back().x, x.back());
+        TS_ASSERT(trace.components[0].empty());
+        TS_ASSERT_THROWS_ANYTHING( solver.GetTimeTrace() );
 
-         write_output.close();
-     }
+        // Structure-of-arrays: the same answers, with contiguous components
+        solver.SetStructureOfArraysTrace(true);
+        solver.Solve();
+        TS_ASSERT(solver.mSolutionTrace.empty());
+        x_view = solver.GetXView();
+        y_view = solver.GetYView();
+        TS_ASSERT_EQUALS(x_view.stride(), 1u);
+        TS_ASSERT_EQUALS(y_view.stride(), 1u);
+        for (unsigned i=0; i<x.size(); i++)
+        {
+            TS_ASSERT_EQUALS(x_view[i], x[i]);
+            TS_ASSERT_EQUALS(y_view[i], y[i]);
+        }
+        TS_ASSERT(solver.GetYTrace() == y);
+        TS_ASSERT_THROWS_NOTHING( solver.DumpToFile("./tempfile.txt") );
+        trace = solver.TakeTrace();
+        TS_ASSERT(trace.solution.empty());
+        TS_ASSERT(trace.components[1] == y);
+    }
+
+    /** Binary trace files keep every bit and map back in without copying */
+    void TestBinaryTrace()
+    {
+        ForwardEulerOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);  // For a unit circle
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100000, 2*M_PI);
+        TS_ASSERT_THROWS_ANYTHING( solver.DumpToBinaryFile("./tempfile.bin") );
+        solver.Solve();
+        TS_ASSERT_THROWS_ANYTHING( solver.DumpToBinaryFile("") );
+        solver.DumpToBinaryFile("./tempfile.bin");
+
+        LoadedTrace trace = LoadTrace("./tempfile.bin");
+        TS_ASSERT_EQUALS(trace.GetSolverName(), "ForwardEuler");
+        TS_ASSERT_EQUALS(trace.GetDimension(), 2u);
+        TS_ASSERT_EQUALS(trace.GetNumberOfTimePoints(), 100001u);
+        TS_ASSERT_EQUALS(trace.GetTimeStepSize(), solver.mTimeStepSize);
+        TS_ASSERT(trace.GetTimeTrace() == solver.GetTimeTrace());
+        TS_ASSERT(trace.GetXTrace() == solver.GetXTrace());
+        TS_ASSERT(trace.GetYTrace() == solver.GetYTrace());
+        TS_ASSERT_EQUALS(trace.GetYView().stride(), 1u);
+        TS_ASSERT_EQUALS(trace.GetYView().back(), solver.GetYView().back());
+        TS_ASSERT_THROWS_ANYTHING( trace.GetComponentView(2) );
+
+        // Structure-of-arrays storage gives an identical file
+        solver.SetStructureOfArraysTrace(true);
+        solver.Solve();
+        solver.DumpToBinaryFile("./tempfile.bin");
+        LoadedTrace soa_trace = LoadTrace("./tempfile.bin");
+        TS_ASSERT(soa_trace.GetXTrace() == trace.GetXTrace());
+        TS_ASSERT(soa_trace.GetYTrace() == trace.GetYTrace());
+
+        // Three components
+        RK4SolverT<State<3> > rk4_solver;
+        State<3> initial_values = {{1.0, 1.0, 0.0}};
+        rk4_solver.SetInitialValues(initial_values);
+        rk4_solver.SetRhsFunction( &RhsThreeDecoupled );
+        rk4_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10, 1.0);
+        rk4_solver.Solve();
+        rk4_solver.DumpToBinaryFile("./tempfile.bin");
+        LoadedTrace trace_3d = LoadTrace("./tempfile.bin");
+        TS_ASSERT_EQUALS(trace_3d.GetSolverName(), "RungeKutta4");
+        TS_ASSERT_EQUALS(trace_3d.GetDimension(), 3u);
+        TS_ASSERT(trace_3d.GetComponentTrace(2) == rk4_solver.GetComponentTrace(2));
+
+        // Not binary traces
+        TS_ASSERT_THROWS_ANYTHING( LoadTrace("./no_such_file.bin") );
+        TS_ASSERT_THROWS_ANYTHING( LoadTrace("./tempfile.txt") );
+    }
+
+    /** Text output round-trips exactly, and the background writer gives the same file */
+    void TestTextOutput()
+    {
+        const int num_steps = 50000; // Enough rows for several background blocks
+        ForwardEulerOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);  // For a unit circle
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+        FileStreamObserverT<Pair> background_observer("./tempfile_background.txt", true);
+        solver.AddObserver(&background_observer);
+        solver.Solve();
+        solver.DumpToFile("./tempfile.txt");
+
+        // Shortest round-trip formatting: reading back gives exactly the same doubles
+        std::vector<double> times = solver.GetTimeTrace();
+        std::vector<double> x = solver.GetXTrace();
+        std::vector<double> y = solver.GetYTrace();
+        std::ifstream read_input("./tempfile.txt");
+        std::string t, file_x, file_y;
+        int lines = 0;
+        while (read_input >> t >> file_x >> file_y)
+        {
+            TS_ASSERT_EQUALS(strtod(t.c_str(), NULL), times[lines]);
+            TS_ASSERT_EQUALS(strtod(file_x.c_str(), NULL), x[lines]);
+            TS_ASSERT_EQUALS(strtod(file_y.c_str(), NULL), y[lines]);
+            lines++;
+        }
+        TS_ASSERT_EQUALS(lines, num_steps + 1);
+
+        // Identical files
+        std::ifstream dump_file("./tempfile.txt");
+        std::ifstream background_file("./tempfile_background.txt");
+        std::string dump_contents((std::istreambuf_iterator<char>(dump_file)), std::istreambuf_iterator<char>());
+        std::string background_contents((std::istreambuf_iterator<char>(background_file)), std::istreambuf_iterator<char>());
+        TS_ASSERT_LESS_THAN(0u, dump_contents.size());
+        TS_ASSERT(dump_contents == background_contents);
+
+        // Writers need somewhere to write
+        TS_ASSERT_THROWS_ANYTHING( TextTraceWriter("", 3) );
+        TS_ASSERT_THROWS_ANYTHING( TextTraceWriter("./tempfile.txt", 0) );
+    }
+
+    /** Paged traces give the same answers as the vectors, with or without pages spilled to disk */
+    void TestPagedTraces()
+    {
+        // The container on its own, with small pages
+        TS_ASSERT_THROWS_ANYTHING( PagedTraceT<double>(6) );
+        PagedTraceT<double> paged(4);
+        for (int i=0; i<10; i++)
+        {
+            paged.push_back(0.5*i);
+        }
+        TS_ASSERT_EQUALS(paged.size(), 10u);
+        TS_ASSERT_EQUALS(paged.GetNumberOfPages(), 3u);
+        TS_ASSERT_EQUALS(paged.GetPageLength(2), 2u);
+        TS_ASSERT_EQUALS(paged[7], 3.5);
+        TS_ASSERT_EQUALS(paged.back(), 4.5);
+        std::vector<double> copied(paged.begin(), paged.end());
+        TS_ASSERT_EQUALS(copied.size(), 10u);
+        TS_ASSERT_EQUALS(copied[9], 4.5);
+        // Clearing keeps the pages for the next trace
+        std::size_t bytes = paged.GetCapacityBytes();
+        paged.Clear();
+        TS_ASSERT(paged.empty());
+        for (int i=0; i<10; i++)
+        {
+            paged.push_back(i);
+        }
+        TS_ASSERT_EQUALS(paged.GetCapacityBytes(), bytes);
+
+        // Full pages go to the spill file, and are read back from it
+        paged.SetSpillFile("./tempfile_pages.bin");
+        TS_ASSERT(paged.empty());
+        for (int i=0; i<10; i++)
+        {
+            paged.push_back(i);
+        }
+        TS_ASSERT_EQUALS(paged.GetNumberOfSpilledPages(), 2u);
+        for (int i=9; i>=0; i--)
+        {
+            TS_ASSERT_EQUALS(paged[i], i);
+        }
+        TS_ASSERT(std::ifstream("./tempfile_pages.bin").good());
+        paged.Clear();
+        TS_ASSERT(!std::ifstream("./tempfile_pages.bin").good());
+
+        // A solve over several pages
+        const int num_steps = 200000;
+        ForwardEulerOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);  // For a unit circle
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+        solver.Solve();
+        std::vector<double> times = solver.GetTimeTrace();
+        std::vector<double> x = solver.GetXTrace();
+        std::vector<double> y = solver.GetYTrace();
+        solver.DumpToFile("./tempfile_background.txt");
+
+        solver.SetPagedTrace(true);
+        TS_ASSERT_THROWS_ANYTHING( solver.SetStructureOfArraysTrace(true) );
+        TS_ASSERT_THROWS_ANYTHING( solver.GetTimeTrace() );
+        solver.Solve();
+        TS_ASSERT(solver.GetTimeTrace() == times);
+        TS_ASSERT(solver.GetXTrace() == x);
+        TS_ASSERT(solver.GetYTrace() == y);
+        TS_ASSERT_THROWS_ANYTHING( solver.GetComponentTrace(2) );
+        // No contiguous views of pages
+        TS_ASSERT_THROWS_ANYTHING( solver.GetTimeView() );
+        TS_ASSERT_THROWS_ANYTHING( solver.GetXView() );
+        TS_ASSERT_THROWS_ANYTHING( solver.TakeTrace() );
+
+        // The same files as from the vectors
+        solver.DumpToFile("./tempfile.txt");
+        std::ifstream vector_file("./tempfile_background.txt");
+        std::ifstream paged_file("./tempfile.txt");
+        std::string vector_contents((std::istreambuf_iterator<char>(vector_file)), std::istreambuf_iterator<char>());
+        std::string paged_contents((std::istreambuf_iterator<char>(paged_file)), std::istreambuf_iterator<char>());
+        TS_ASSERT_LESS_THAN(0u, paged_contents.size());
+        TS_ASSERT(paged_contents == vector_contents);
+        solver.DumpToBinaryFile("./tempfile.bin");
+        LoadedTrace trace = LoadTrace("./tempfile.bin");
+        TS_ASSERT(trace.GetTimeTrace() == times);
+        TS_ASSERT(trace.GetYTrace() == y);
+
+        // Spilled to disk, only a page or so of each trace stays in memory
+        solver.SetPagedTrace(true, "./tempfile_pages.bin");
+        solver.Solve();
+        TS_ASSERT(solver.GetTimeTrace() == times);
+        TS_ASSERT(solver.GetXTrace() == x);
+        TS_ASSERT(solver.GetYTrace() == y);
+        if (solver.GetStats().enabled)
+        {
+            TS_ASSERT_LESS_THAN(solver.GetStats().peakTraceBytes, 3*PagedTraceT<Pair>::DEFAULT_PAGE_SIZE*sizeof(Pair));
+        }
+        solver.SetPagedTrace(false);
+        TS_ASSERT(!std::ifstream("./tempfile_pages.bin").good());
+
+        // Step counts past 2^31
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 3000000000LL, 3.0);
+        TS_ASSERT_EQUALS(solver.mNumberOfTimeSteps, 3000000000LL);
+        TS_ASSERT_DELTA(solver.GetStepTime(2999999999LL), 3.0 - 1e-9, 1e-15);
+        solver.SetInitialTimeDeltaTimeAndFinalTime(0.0, 1e-10, 1.0);
+        TS_ASSERT_EQUALS(solver.mNumberOfTimeSteps, 10000000000LL);
+    }
+
+    /** Per-solve instrumentation */
+    void TestSolverStats()
+    {
+        const int num_steps = 1000;
+        ForwardEulerOdeSolver solver;
+        solver.SetInitialValues(1.0, 0.0);
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+        solver.Solve();
+        solver.DumpToFile("./tempfile.txt");
+        SolverStats stats = solver.GetStats();
+#ifndef ODE_DISABLE_STATS
+        TS_ASSERT(stats.enabled);
+        TS_ASSERT_EQUALS(stats.stepsTaken, (unsigned long long) num_steps);
+        TS_ASSERT_EQUALS(stats.rhsEvaluations, (unsigned long long) num_steps);
+        // The traces were reserved up front
+        TS_ASSERT_EQUALS(stats.traceReallocations, 0ull);
+        TS_ASSERT_EQUALS(stats.peakTraceBytes, (num_steps + 1)*(sizeof(double) + sizeof(Pair)));
+        TS_ASSERT_LESS_THAN(0.0, stats.integrateSeconds);
+        TS_ASSERT_LESS_THAN(0.0, stats.outputSeconds);
+
+        // A callable right-hand side is counted too, and each solve resets the counts
+        solver.SetStoreTrace(false);
+        for (int repeat=0; repeat<2; repeat++)
+        {
+            solver.Solve([](const Pair& v, double t, Pair& dvdt) { RhsCircle(v, t, dvdt); });
+            stats = solver.GetStats();
+            TS_ASSERT_EQUALS(stats.rhsEvaluations, (unsigned long long) num_steps);
+            TS_ASSERT_EQUALS(stats.stepsTaken, (unsigned long long) num_steps);
+            TS_ASSERT_EQUALS(stats.peakTraceBytes, 0u);
+            TS_ASSERT_EQUALS(stats.outputSeconds, 0.0);
+        }
+#else
+        TS_ASSERT(!stats.enabled);
+        TS_ASSERT_EQUALS(stats.rhsEvaluations, 0ull);
+#endif
+    }
+
+    /** Single precision states, with the time accumulated in double (mixed) or in float */
+    void TestPrecisionModes()
+    {
+        TS_ASSERT_EQUALS(sizeof(MixedPair), sizeof(Pair)/2);
+        FloatPair a(1.0f, 2.0f);
+        FloatPair b = a*0.5 + a/2.0; // Double factors are converted once
+        TS_ASSERT_EQUALS(b.x, 1.0f);
+        TS_ASSERT_EQUALS(b.y, 2.0f);
+
+        const int num_steps = 1000;
+        RK4Solver double_solver;
+        RK4SolverT<MixedPair> mixed_solver;
+        RK4SolverT<FloatPair> float_solver;
+        double_solver.SetInitialValues(1.0, 0.0);
+        mixed_solver.SetInitialValues(1.0, 0.0);
+        float_solver.SetInitialValues(1.0, 0.0);
+        double_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+        mixed_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+        float_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+        double_solver.Solve(&RhsCircle);
+        mixed_solver.Solve([](const MixedPair& v, double t, MixedPair& dvdt) { dvdt.x = -v.y; dvdt.y = v.x; });
+        float_solver.Solve([](const FloatPair& v, double t, FloatPair& dvdt) { dvdt.x = -v.y; dvdt.y = v.x; });
+
+        // About six significant digits, in half the memory
+        TraceViewT<float> x_view = mixed_solver.GetXView();
+        std::vector<double> x = double_solver.GetXTrace();
+        for (unsigned i=0; i<x.size(); i++)
+        {
+            TS_ASSERT_DELTA(x_view[i], x[i], 1e-5);
+        }
+        TS_ASSERT_DELTA(float_solver.GetYTrace().back(), double_solver.GetYTrace().back(), 1e-5);
+        TS_ASSERT_EQUALS(mixed_solver.mSolutionTrace.capacity()*sizeof(MixedPair),
+                         (num_steps + 1u)*sizeof(Pair)/2);
+
+        // Only the float solver rounds the time, and only the mixed solver keeps the double times
+        TS_ASSERT(mixed_solver.GetTimeTrace() == double_solver.GetTimeTrace());
+        TS_ASSERT_EQUALS(float_solver.GetTimeTrace().back(), double(float(num_steps)*float(2*M_PI/num_steps)));
+
+        // A long way from the start time, float time steps are visibly coarse
+        mixed_solver.SetInitialTimeNumberOfStepsAndFinalTime(1e5, 100, 1e5 + 0.1);
+        float_solver.SetInitialTimeNumberOfStepsAndFinalTime(1e5, 100, 1e5 + 0.1);
+        mixed_solver.SetRhsFunction([](const MixedPair& v, double t, MixedPair& dvdt) { dvdt.x = -v.y; dvdt.y = v.x; });
+        mixed_solver.Solve();
+        float_solver.Solve([](const FloatPair& v, double t, FloatPair& dvdt) { dvdt.x = -v.y; dvdt.y = v.x; });
+        TS_ASSERT_DELTA(mixed_solver.GetTimeTrace()[1] - 1e5, 1e-3, 1e-9);
+        TS_ASSERT_DELTA(float_solver.GetTimeTrace()[1] - 1e5, 1e-3, 4e-3);
+        TS_ASSERT(float_solver.GetTimeTrace()[1] != mixed_solver.GetTimeTrace()[1]);
+
+        // Files are written in double, as for any other solver
+        mixed_solver.SetStructureOfArraysTrace(true);
+        mixed_solver.Solve();
+        mixed_solver.DumpToBinaryFile("./tempfile.bin");
+        LoadedTrace trace = LoadTrace("./tempfile.bin");
+        TS_ASSERT(trace.GetYTrace() == mixed_solver.GetYTrace());
+        TS_ASSERT(trace.GetTimeTrace() == mixed_solver.GetTimeTrace());
+    }
 };
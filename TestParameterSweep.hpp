@@ -0,0 +1,174 @@
+#include <cxxtest/TestSuite.h>
+
+#include <atomic>
+#include "AbstractOdeSolver.hpp"
+#include "ForwardEulerOdeSolver.hpp"
+#include "RK4Solver.hpp"
+#include "ParameterSweep.hpp"
+
+/* Van der Pol with the damping mu as the sweep parameter */
+void RhsVanderPolMu(double mu, const Pair& v, double t, Pair& dvdt)
+{
+    dvdt.x = mu * (v.x - pow(v.x, 3) / 3.0 - v.y);
+    dvdt.y = v.x / mu;
+}
+
+/**
+ * This test suite checks the thread pool and the parameter sweeps built on it
+ */
+class TestParameterSweep : public CxxTest::TestSuite
+{
+private:
+    /*
+     * Private helper method.
+     * A grid of Van der Pol problems with 4 values of mu and 3 initial conditions
+     */
+    std::vector<SweepPointT<Pair> > MakeVanderPolGrid()
+    {
+        std::vector<double> mu;
+        mu.push_back(0.5);
+        mu.push_back(1.0);
+        mu.push_back(3.0);
+        mu.push_back(7.0);
+        std::vector<Pair> initial_values;
+        initial_values.push_back(Pair(2.0, 0.0));
+        initial_values.push_back(Pair(0.1, 0.1));
+        initial_values.push_back(Pair(-1.0, 0.5));
+        return MakeSweepGrid(mu, initial_values);
+    }
+
+public:
+    void TestThreadPool()
+    {
+        WorkStealingThreadPool pool(4);
+        TS_ASSERT_EQUALS(pool.GetNumberOfThreads(), 4u);
+
+        // Every index is run exactly once, however uneven the work
+        std::vector<int> counts(1000, 0);
+        std::atomic<long> sum(0);
+        pool.ParallelFor(counts.size(), [&](std::size_t i)
+        {
+            counts[i]++;
+            volatile double busy = 0.0;
+            for (std::size_t j=0; j<(i%7)*1000; j++)
+            {
+                busy += j;
+            }
+            sum += i;
+        });
+        TS_ASSERT_EQUALS(sum.load(), 999*1000/2);
+        TS_ASSERT(counts == std::vector<int>(1000, 1));
+
+        // The pool can be reused, and an empty loop does nothing
+        pool.ParallelFor(0, [&](std::size_t i) { sum += 1; });
+        pool.ParallelFor(10, [&](std::size_t i) { sum += 1; });
+        TS_ASSERT_EQUALS(sum.load(), 999*1000/2 + 10);
+
+        // Exceptions from tasks reach the caller, and the pool still works afterwards
+        TS_ASSERT_THROWS_ANYTHING(pool.ParallelFor(100, [](std::size_t i)
+        {
+            if (i == 42)
+            {
+                throw Exception("Test", "Task failed");
+            }
+        }));
+        pool.ParallelFor(10, [&](std::size_t i) { sum += 1; });
+        TS_ASSERT_EQUALS(sum.load(), 999*1000/2 + 20);
+
+        // Zero threads means one per core
+        WorkStealingThreadPool default_pool;
+        TS_ASSERT_LESS_THAN(0u, default_pool.GetNumberOfThreads());
+    }
+
+    void TestSweepSetup()
+    {
+        ParameterSweep<RK4Solver> sweep;
+        auto rhs = [](double mu, const Pair& v, double t, Pair& dvdt) { RhsVanderPolMu(mu, v, t, dvdt); };
+        // No grid
+        sweep.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10, 1.0);
+        TS_ASSERT_THROWS_ANYTHING(sweep.Run(rhs));
+        // No time interval
+        ParameterSweep<RK4Solver> no_time_sweep;
+        no_time_sweep.SetGrid(MakeVanderPolGrid());
+        TS_ASSERT_THROWS_ANYTHING(no_time_sweep.Run(rhs));
+        TS_ASSERT_THROWS_ANYTHING(sweep.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 0, 1.0));
+
+        std::vector<SweepPointT<Pair> > grid = MakeVanderPolGrid();
+        TS_ASSERT_EQUALS(grid.size(), 12u);
+        TS_ASSERT_EQUALS(grid[4].parameter, 1.0);
+        TS_ASSERT_EQUALS(grid[4].initialValues.x, 0.1);
+    }
+
+    /** Each point of a sweep should be exactly what a serial solve gives, with any number of threads */
+    void TestVanderPolSweep()
+    {
+        std::vector<SweepPointT<Pair> > grid = MakeVanderPolGrid();
+        auto rhs = [](double mu, const Pair& v, double t, Pair& dvdt) { RhsVanderPolMu(mu, v, t, dvdt); };
+
+        const unsigned threads[] = {1, 2, 4};
+        for (unsigned k=0; k<3; k++)
+        {
+            ParameterSweep<RK4Solver> sweep;
+            sweep.SetGrid(grid);
+            sweep.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 2000, 20.0);
+            sweep.SetNumberOfThreads(threads[k]);
+            sweep.Run(rhs);
+
+            const std::vector<SweepResultT<Pair> >& results = sweep.GetResults();
+            TS_ASSERT_EQUALS(results.size(), grid.size());
+            for (unsigned i=0; i<grid.size(); i++)
+            {
+                const double mu = grid[i].parameter;
+                RK4Solver solver;
+                solver.SetInitialValues(grid[i].initialValues);
+                solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 2000, 20.0);
+                solver.Solve([mu](const Pair& v, double t, Pair& dvdt) { RhsVanderPolMu(mu, v, t, dvdt); });
+
+                TS_ASSERT_EQUALS(results[i].point.parameter, mu);
+                TS_ASSERT_EQUALS(results[i].numberOfTimePoints, 2001);
+                TS_ASSERT_DELTA(results[i].finalTime, 20.0, 1e-12);
+                TS_ASSERT_EQUALS(results[i].finalValues.x, solver.GetXTrace().back());
+                TS_ASSERT_EQUALS(results[i].finalValues.y, solver.GetYTrace().back());
+                std::vector<double> x = solver.GetXTrace();
+                TS_ASSERT_EQUALS(results[i].minimumValues.x, *std::min_element(x.begin(), x.end()));
+                TS_ASSERT_EQUALS(results[i].maximumValues.x, *std::max_element(x.begin(), x.end()));
+                // No traces unless asked for
+                TS_ASSERT(results[i].trace.times.empty());
+            }
+            // All of the solutions settle onto the limit cycle, which reaches |x| = 2 (approximately)
+            TS_ASSERT_DELTA(results[11].maximumValues.x, 2.0, 0.1);
+        }
+    }
+
+    void TestSweepWithTraces()
+    {
+        std::vector<double> rates;
+        rates.push_back(-1.0);
+        rates.push_back(-2.0);
+        std::vector<Pair> initial_values(1, Pair(1.0, 2.0));
+
+        ParameterSweep<ForwardEulerOdeSolver> sweep;
+        sweep.SetGrid(MakeSweepGrid(rates, initial_values));
+        sweep.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100, 1.0);
+        sweep.SetKeepTraces(true);
+        sweep.SetNumberOfThreads(2);
+        sweep.Run([](double rate, const Pair& v, double t, Pair& dvdt)
+        {
+            dvdt.x = rate*v.x;
+            dvdt.y = rate*v.y;
+        });
+
+        const std::vector<SweepResultT<Pair> >& results = sweep.GetResults();
+        for (unsigned i=0; i<results.size(); i++)
+        {
+            const SolutionTraceT<Pair>& r_trace = results[i].trace;
+            TS_ASSERT_EQUALS(r_trace.times.size(), 101u);
+            TS_ASSERT_EQUALS(r_trace.solution.size(), 101u);
+            TS_ASSERT_DELTA(r_trace.solution.back().x, pow(1.0 + 0.01*rates[i], 100), 1e-12);
+            TS_ASSERT_DELTA(r_trace.solution.back().y, 2.0*pow(1.0 + 0.01*rates[i], 100), 1e-12);
+            // Decaying, so the first values are the largest
+            TS_ASSERT_EQUALS(results[i].maximumValues.y, 2.0);
+            TS_ASSERT_EQUALS(results[i].minimumValues.y, r_trace.solution.back().y);
+        }
+    }
+};
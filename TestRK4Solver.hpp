@@ -1,7 +1,12 @@
 #include <cxxtest/TestSuite.h>
+#include <cstdio>
 #include <fstream>
+#include <functional>
+#include <sstream>
 
 #include "AbstractOdeSolver.hpp"
+#include "ConvergenceStudy.hpp"
+#include "ForwardEulerOdeSolver.hpp"
 #include "RK4Solver.hpp"
 
 /**
@@ -29,6 +34,47 @@ void RhsVanderPol(const Pair& v, double t, Pair& dvdt) {
     dvdt.y = v.x / mu;
 }
 
+/*
+ * Van der Pol as a stateful functor: the parameter is a member and it counts its own evaluations
+ */
+struct VanderPolFunctor
+{
+    double mu;
+    int evaluations;
+
+    void operator()(const Pair& v, double t, Pair& dvdt)
+    {
+        evaluations++;
+        dvdt.x = mu * (v.x - pow(v.x, 3) / 3.0 - v.y);
+        dvdt.y = v.x / mu;
+    }
+};
+
+/** Stops a solve part way through (by throwing), like a crash */
+struct CrashObserver: public AbstractOdeObserverT<Pair>
+{
+    int stepsLeft;
+
+    CrashObserver(int steps) : stepsLeft(steps) {}
+
+    void ObserveStep(double t, const Pair& rValues)
+    {
+        if (stepsLeft-- == 0)
+        {
+            throw Exception("OdeSolve", "Crashed");
+        }
+    }
+};
+
+/** The whole of a file */
+std::string ReadFile(const std::string& fileName)
+{
+    std::ifstream read_input(fileName.c_str());
+    std::stringstream contents;
+    contents << read_input.rdbuf();
+    return contents.str();
+}
+
 /**
  * This test suite is about testing a higher-order ODE solver (Runge-Kutta, Adams-Bashforth etc.)
  */
@@ -47,9 +93,10 @@ private:
 
         pSolver->Solve();
 
-        std::vector<double> times = pSolver->GetTimeTrace();
-        std::vector<double> x = pSolver->GetXTrace();
-        std::vector<double> y = pSolver->GetYTrace();
+        // Views rather than copies of the traces
+        TraceView times = pSolver->GetTimeView();
+        TraceView x = pSolver->GetXView();
+        TraceView y = pSolver->GetYView();
         double sum_square_error = 0.0;
         for (unsigned i=0; i<times.size();i++)
         {
@@ -126,24 +173,59 @@ public:
      }
 
      void TestErrorofSolver() {
-          // Load the solver
-          RK4Solver rk4_solver;
-
-          std::ofstream write_output("errors_rk4.txt", std::ofstream::out);
-          if (write_output.is_open() == false) {
-              throw Exception("OdePost", "Can't open output file");
+          // Refine from one step round the circle to about 4 million, with the refinements run in parallel
+          std::vector<double> step_sizes;
+          for (int num_steps=1; num_steps<5e6; num_steps*=2) {
+              step_sizes.push_back(2*M_PI/num_steps);
           }
-          write_output.precision(10);
 
-          // For each timestep, output the L2Error for the solver
-          for (int num_steps=1; num_steps<5e6; num_steps*=2) {
-              rk4_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI /* 2*pi is one circuit */);
-              double rk4_error = SolveAndCalculateL2ErrorForCircle(&rk4_solver);
+          ConvergenceStudy<RK4Solver> study;
+          study.SetInitialValues(Pair(1.0, 0.0));  // For a unit circle
+          study.SetInitialAndFinalTime(0.0, 2*M_PI /* 2*pi is one circuit */);
+          study.SetStepSizes(step_sizes);
+          study.SetAnalyticSolution([](double t) { return Pair(cos(t), sin(t)); });
+          study.SetOrder(4);
+          study.Run(&RhsCircle);
 
-              write_output << 2*M_PI/num_steps <<  "\t" << rk4_error << std::endl;
-          }
+          // For each timestep, output the L2Error for the solver (and the observed order and Richardson error)
+          study.WriteErrorTable("errors_rk4.txt");
+
+          // RK4 has fourth order convergence, and extrapolation removes the leading error term
+          const std::vector<ConvergenceResult>& results = study.GetResults();
+          TS_ASSERT_EQUALS(results.size(), step_sizes.size());
+          TS_ASSERT_DELTA(results[10].stepSize, 2*M_PI/1024, 1e-15);
+          TS_ASSERT_DELTA(results[10].observedOrder, 4.0, 0.05);
+          TS_ASSERT_LESS_THAN(results[10].richardsonError, 0.1*results[10].maxError);
+     }
+
+     /** Van der Pol has no analytic solution, so measure convergence against a finer run instead */
+     void TestVanderPolConvergenceAgainstReferenceRun() {
+         std::vector<double> step_sizes;
+         for (int num_steps=256; num_steps<=4096; num_steps*=2) {
+             step_sizes.push_back(10.0/num_steps);
+         }
+
+         ConvergenceStudy<RK4Solver> study;
+         study.SetInitialValues(Pair(1.0, 0.0));
+         study.SetInitialAndFinalTime(0.0, 10.0);
+         study.SetStepSizes(step_sizes);
+         study.SetNumberOfThreads(2);
+         TS_ASSERT_THROWS_ANYTHING(study.Run(&RhsVanderPol)); // No reference yet
+         study.SetReferenceRun(10000);
+         TS_ASSERT_THROWS_ANYTHING(study.Run(&RhsVanderPol)); // 256 steps don't divide 10000
+         study.SetReferenceRun(16*4096);
+         study.Run(&RhsVanderPol);
 
-          write_output.close();
+         // Without a formal order the observed one is used for extrapolation
+         const std::vector<ConvergenceResult>& results = study.GetResults();
+         TS_ASSERT_EQUALS(results.size(), 5u);
+         TS_ASSERT(std::isnan(results[0].observedOrder));
+         TS_ASSERT(std::isnan(results[0].richardsonError));
+         for (unsigned i=2; i<results.size(); i++) {
+             TS_ASSERT_EQUALS(results[i].numberOfSteps, 2*results[i-1].numberOfSteps);
+             TS_ASSERT_DELTA(results[i].observedOrder, 4.0, 0.2);
+             TS_ASSERT_LESS_THAN(results[i].richardsonError, results[i].maxError);
+         }
      }
 
      void TestVanderPol() {
@@ -155,4 +237,174 @@ public:
          solver.Solve();
          solver.DumpToFile("rk4_vanderpol.txt");
      }
+
+     /** Dense output: a few large steps still give 4th order accurate output anywhere */
+     void TestDenseOutput() {
+         RK4Solver solver;
+         solver.SetInitialValues(1.0, 0.0);
+         solver.SetRhsFunction( &RhsCircle );
+         solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 20, 2*M_PI);
+         solver.Solve();
+         // Not asked for
+         TS_ASSERT_THROWS_ANYTHING( solver.Evaluate(1.0) );
+
+         std::vector<double> output_times;
+         for (int i=0; i<=1000; i++) {
+             output_times.push_back(2*M_PI*i/1000.0);
+         }
+         double errors[2];
+         for (int refinement=0; refinement<2; refinement++) {
+             solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 20 << refinement, 2*M_PI);
+             solver.SetDenseOutput(true);
+             solver.Solve();
+             std::vector<Pair> values = solver.Evaluate(output_times);
+             TS_ASSERT_EQUALS(values.size(), output_times.size());
+             errors[refinement] = 0.0;
+             for (unsigned i=0; i<output_times.size(); i++) {
+                 errors[refinement] = std::max(errors[refinement], fabs(values[i].x - cos(output_times[i])));
+                 errors[refinement] = std::max(errors[refinement], fabs(values[i].y - sin(output_times[i])));
+                 // Unsorted look-ups give the same answers
+                 TS_ASSERT_EQUALS(solver.Evaluate(output_times[i]).x, values[i].x);
+             }
+         }
+         TS_ASSERT_LESS_THAN(errors[0], 1e-3);
+         TS_ASSERT_DELTA(log2(errors[0]/errors[1]), 4.0, 0.3);
+
+         // The interpolant goes through the steps
+         std::vector<double> times = solver.GetTimeTrace();
+         std::vector<double> x = solver.GetXTrace();
+         for (unsigned i=0; i<times.size(); i++) {
+             TS_ASSERT_DELTA(solver.Evaluate(times[i]).x, x[i], 1e-14);
+         }
+         // Outside the solved interval
+         TS_ASSERT_THROWS_ANYTHING( solver.Evaluate(-0.1) );
+         TS_ASSERT_THROWS_ANYTHING( solver.Evaluate(7.0) );
+
+#ifndef ODE_DISABLE_STATS
+         // One more right-hand side evaluation a step for the end derivatives
+         TS_ASSERT_EQUALS(solver.GetStats().rhsEvaluations, 5ull*40 + 1);
+#endif
+     }
+
+     /** A crashed run carries on from its last checkpoint, giving exactly the same answers and trace file */
+     void TestCheckpointRestart() {
+         const int num_steps = 1000;
+         RK4Solver solver;
+         solver.SetInitialValues(1.0, 0.0);
+         solver.SetRhsFunction(&RhsVanderPol);
+         solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 10.0);
+         FileStreamObserverT<Pair> file_observer("./tempfile.txt");
+         StrideObserverT<Pair> stride_observer(7);
+         solver.AddObserver(&file_observer);
+         solver.AddObserver(&stride_observer);
+         solver.Solve();
+         std::vector<double> times = solver.GetTimeTrace();
+         std::vector<double> x = solver.GetXTrace();
+         std::vector<double> y = solver.GetYTrace();
+         std::string file_contents = ReadFile("./tempfile.txt");
+
+         TS_ASSERT_THROWS_ANYTHING( solver.SetCheckpointing("./tempfile.chk", -1) );
+         TS_ASSERT_THROWS_ANYTHING( solver.SetCheckpointing("", 10) );
+         StrideObserverT<Pair> resumed_stride_observer(7); // Sees the crash and the resumed solve
+         {
+             // Checkpoints every 128 steps, streaming in the background, and a crash after 700 steps
+             RK4Solver crashing_solver;
+             crashing_solver.SetInitialValues(1.0, 0.0);
+             crashing_solver.SetRhsFunction(&RhsVanderPol);
+             crashing_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 10.0);
+             FileStreamObserverT<Pair> crashing_file_observer("./tempfile_background.txt", true);
+             CrashObserver crash(700);
+             crashing_solver.AddObserver(&crashing_file_observer);
+             crashing_solver.AddObserver(&resumed_stride_observer);
+             crashing_solver.AddObserver(&crash);
+             crashing_solver.SetCheckpointing("./tempfile.chk", 128);
+             TS_ASSERT_THROWS_ANYTHING( crashing_solver.Solve() );
+         }
+
+         // A new solver with no time set-up carries on from step 640
+         RK4Solver resumed_solver;
+         resumed_solver.SetRhsFunction(&RhsVanderPol);
+         FileStreamObserverT<Pair> resumed_file_observer("./tempfile_background.txt", true);
+         CrashObserver no_crash(-1);
+         TS_ASSERT_THROWS_ANYTHING( resumed_solver.Resume("./tempfile.chk") ); // Not the same observers
+         resumed_solver.AddObserver(&resumed_file_observer);
+         resumed_solver.AddObserver(&resumed_stride_observer);
+         resumed_solver.AddObserver(&no_crash);
+         resumed_solver.Resume("./tempfile.chk");
+         std::vector<double> resumed_times = resumed_solver.GetTimeTrace();
+         std::vector<double> resumed_x = resumed_solver.GetXTrace();
+         std::vector<double> resumed_y = resumed_solver.GetYTrace();
+         TS_ASSERT_EQUALS(resumed_times.size(), std::size_t(num_steps - 640 + 1));
+         for (unsigned i=0; i<resumed_times.size(); i++) {
+             TS_ASSERT_EQUALS(resumed_times[i], times[640 + i]);
+             TS_ASSERT_EQUALS(resumed_x[i], x[640 + i]);
+             TS_ASSERT_EQUALS(resumed_y[i], y[640 + i]);
+         }
+         TS_ASSERT_EQUALS(ReadFile("./tempfile_background.txt"), file_contents);
+         // The stride observer keeps the same points, dropping those it saw after the checkpoint
+         TS_ASSERT_EQUALS(resumed_stride_observer.GetTimeTrace().size(), stride_observer.GetTimeTrace().size());
+         for (unsigned i=0; i<stride_observer.GetTimeTrace().size(); i++) {
+             TS_ASSERT_EQUALS(resumed_stride_observer.GetTimeTrace()[i], stride_observer.GetTimeTrace()[i]);
+             TS_ASSERT_EQUALS(resumed_stride_observer.GetSolutionTrace()[i][0], stride_observer.GetSolutionTrace()[i][0]);
+             TS_ASSERT_EQUALS(resumed_stride_observer.GetSolutionTrace()[i][1], stride_observer.GetSolutionTrace()[i][1]);
+         }
+
+         // The next solve starts from the initial values again
+         resumed_solver.SetInitialValues(1.0, 0.0);
+         resumed_solver.Solve();
+         TS_ASSERT_EQUALS(resumed_solver.GetXTrace().size(), x.size());
+
+         // Wrong solver, or not a checkpoint
+         ForwardEulerOdeSolver euler_solver;
+         TS_ASSERT_THROWS_ANYTHING( euler_solver.LoadCheckpoint("./tempfile.chk") );
+         TS_ASSERT_THROWS_ANYTHING( resumed_solver.LoadCheckpoint("./tempfile.txt") );
+         TS_ASSERT_THROWS_ANYTHING( resumed_solver.LoadCheckpoint("./no_such_file.chk") );
+         std::remove("./tempfile.chk");
+
+         // An interval past 2^32 is kept whole (cut to 32 bits it would be 5), so there's no checkpoint
+         solver.SetCheckpointing("./tempfile.chk", (int64_t(1) << 32) + 5);
+         solver.Solve();
+         TS_ASSERT(!std::ifstream("./tempfile.chk").good());
+         std::remove("./tempfile.chk");
+     }
+
+     /** Lambdas and functors give the same answers as the function pointer */
+     void TestCallableRhs() {
+         const int num_steps = 1000;
+         RK4Solver pointer_solver;
+         pointer_solver.SetInitialValues(1.0, 0.0);
+         pointer_solver.SetRhsFunction(&RhsVanderPol);
+         pointer_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 10.0);
+         pointer_solver.Solve();
+         std::vector<double> x = pointer_solver.GetXTrace();
+         std::vector<double> y = pointer_solver.GetYTrace();
+
+         // A lambda capturing mu (no function pointer set at all)
+         double mu = 7;
+         RK4Solver lambda_solver;
+         lambda_solver.SetInitialValues(1.0, 0.0);
+         lambda_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 10.0);
+         TS_ASSERT_THROWS_ANYTHING( lambda_solver.Solve() );
+         lambda_solver.Solve([mu](const Pair& v, double t, Pair& dvdt) {
+             dvdt.x = mu * (v.x - pow(v.x, 3) / 3.0 - v.y);
+             dvdt.y = v.x / mu;
+         });
+         TS_ASSERT_EQUALS(lambda_solver.GetXTrace().size(), x.size());
+         TS_ASSERT_DELTA(lambda_solver.GetXTrace().back(), x.back(), 1e-12);
+         TS_ASSERT_DELTA(lambda_solver.GetYTrace().back(), y.back(), 1e-12);
+
+         // A functor: state is kept between calls so RK4 should make 4 evaluations per step
+         VanderPolFunctor functor = {7, 0};
+         RK4Solver functor_solver;
+         functor_solver.SetInitialValues(1.0, 0.0);
+         functor_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 10.0);
+         functor_solver.Solve(std::ref(functor));
+         TS_ASSERT_EQUALS(functor.evaluations, 4*num_steps);
+         TS_ASSERT_DELTA(functor_solver.GetXTrace().back(), x.back(), 1e-12);
+
+         // A different mu without recompiling
+         functor.mu = 0.88;
+         functor_solver.Solve(std::ref(functor));
+         TS_ASSERT(fabs(functor_solver.GetXTrace().back() - x.back()) > 1e-3);
+     }
 };
@@ -0,0 +1,185 @@
+#include <cxxtest/TestSuite.h>
+
+#include <functional>
+
+#include "AbstractOdeSolver.hpp"
+#include "RK4Solver.hpp"
+#include "StormerVerletOdeSolver.hpp"
+#include "Yoshida4OdeSolver.hpp"
+
+/*
+ * x' = -y
+ * y' = +x
+ * You can solve this one as: dy/dx = (dy/dt)/(dx/dt) = -x/y.  Separate and integrate to give x^2 + y^2 = 2*c
+ */
+void RhsCircle(const Pair& v, double t, Pair& dvdt)
+{
+    dvdt.x = -v.y;
+    dvdt.y =  v.x;
+}
+
+/*
+ * Kepler orbit: positions (v[0], v[1]) and velocities (v[2], v[3]) around a unit mass at the origin
+ */
+void KeplerPositionRhs(const State<4>& v, double t, State<4>& dvdt)
+{
+    dvdt[0] = v[2];
+    dvdt[1] = v[3];
+}
+
+void KeplerForce(const State<4>& v, double t, State<4>& dvdt)
+{
+    double r = sqrt(v[0]*v[0] + v[1]*v[1]);
+    dvdt[2] = -v[0]/(r*r*r);
+    dvdt[3] = -v[1]/(r*r*r);
+}
+
+double KeplerEnergy(const State<4>& v)
+{
+    return 0.5*(v[2]*v[2] + v[3]*v[3]) - 1.0/sqrt(v[0]*v[0] + v[1]*v[1]);
+}
+
+/** Counts the force evaluations for the circle */
+struct CountingCircleForce
+{
+    int evaluations;
+
+    void operator()(const Pair& v, double t, Pair& dvdt)
+    {
+        evaluations++;
+        dvdt.y = v.x;
+    }
+};
+
+/**
+ * This test suite is about the symplectic solvers for Hamiltonian systems
+ */
+class TestSymplecticOdeSolvers : public CxxTest::TestSuite
+{
+private:
+    /** Largest change in x^2 + y^2 over the run */
+    double CircleEnergyError(AbstractOdeSolver& rSolver, int stepsPerCircuit, int circuits)
+    {
+        rSolver.SetInitialValues(1.0, 0.0);
+        rSolver.SetRhsFunction( &RhsCircle );
+        rSolver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, stepsPerCircuit*circuits, 2*M_PI*circuits);
+        rSolver.Solve();
+        std::vector<double> x = rSolver.GetXTrace();
+        std::vector<double> y = rSolver.GetYTrace();
+        double max_error = 0.0;
+        for (unsigned i=0; i<x.size(); i++)
+        {
+            max_error = std::max(max_error, fabs(x[i]*x[i] + y[i]*y[i] - 1.0));
+        }
+        return max_error;
+    }
+
+public:
+    void TestSetup()
+    {
+        StormerVerletOdeSolver solver;
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 10, 1.0);
+        // No right-hand side
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+        TS_ASSERT_THROWS_ANYTHING( solver.SetSplitRhsFunctions(&RhsCircle, NULL) );
+        // No dense output
+        solver.SetRhsFunction( &RhsCircle );
+        solver.SetDenseOutput(true);
+        TS_ASSERT_THROWS_ANYTHING( solver.Solve() );
+    }
+
+    /** Over many circuits the energy error stays bounded for the symplectic solvers, but RK4 drifts */
+    void TestCircleEnergy()
+    {
+        StormerVerletOdeSolver verlet_solver;
+        Yoshida4OdeSolver yoshida_solver;
+        RK4Solver rk4_solver;
+        double verlet_short = CircleEnergyError(verlet_solver, 20, 10);
+        double verlet_long = CircleEnergyError(verlet_solver, 20, 1000);
+        double yoshida_short = CircleEnergyError(yoshida_solver, 20, 10);
+        double yoshida_long = CircleEnergyError(yoshida_solver, 20, 1000);
+        double rk4_short = CircleEnergyError(rk4_solver, 20, 10);
+        double rk4_long = CircleEnergyError(rk4_solver, 20, 1000);
+
+        TS_ASSERT_DELTA(verlet_long, verlet_short, 1e-3*verlet_short);
+        TS_ASSERT_DELTA(yoshida_long, yoshida_short, 1e-3*yoshida_short);
+        TS_ASSERT_LESS_THAN(50*rk4_short, rk4_long);
+        TS_ASSERT_LESS_THAN(yoshida_long, rk4_long);
+    }
+
+    /** Stormer-Verlet is second order and Yoshida fourth order */
+    void TestCircleConvergence()
+    {
+        StormerVerletOdeSolver verlet_solver;
+        Yoshida4OdeSolver yoshida_solver;
+        AbstractOdeSolver* solvers[2] = {&verlet_solver, &yoshida_solver};
+        double orders[2] = {2.0, 4.0};
+        for (int i=0; i<2; i++)
+        {
+            double errors[2];
+            for (int refinement=0; refinement<2; refinement++)
+            {
+                solvers[i]->SetInitialValues(1.0, 0.0);
+                solvers[i]->SetRhsFunction( &RhsCircle );
+                solvers[i]->SetInitialTimeNumberOfStepsAndFinalTime(0.0, 100 << refinement, 2*M_PI);
+                solvers[i]->Solve();
+                errors[refinement] = std::max(fabs(solvers[i]->GetXTrace().back() - 1.0),
+                                              fabs(solvers[i]->GetYTrace().back()));
+            }
+            TS_ASSERT_DELTA(log2(errors[0]/errors[1]), orders[i], 0.1);
+        }
+    }
+
+    /** One force evaluation per drift, with the last one of a step reused by the next */
+    void TestForceEvaluations()
+    {
+        const int num_steps = 100;
+        CountingCircleForce force = {0};
+        StormerVerletOdeSolver verlet_solver;
+        verlet_solver.SetInitialValues(1.0, 0.0);
+        verlet_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+        verlet_solver.Solve(&RhsCircle, std::ref(force));
+        TS_ASSERT_EQUALS(force.evaluations, num_steps + 1);
+
+        force.evaluations = 0;
+        Yoshida4OdeSolver yoshida_solver;
+        yoshida_solver.SetInitialValues(1.0, 0.0);
+        yoshida_solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, num_steps, 2*M_PI);
+        yoshida_solver.Solve(&RhsCircle, std::ref(force));
+        TS_ASSERT_EQUALS(force.evaluations, 3*num_steps + 1);
+#ifndef ODE_DISABLE_STATS
+        TS_ASSERT_EQUALS(yoshida_solver.GetStats().rhsEvaluations, 3ull*num_steps + 1);
+#endif
+        // Same answer as with the whole right-hand side
+        double x = yoshida_solver.GetXTrace().back();
+        yoshida_solver.Solve(&RhsCircle);
+        TS_ASSERT_EQUALS(yoshida_solver.GetXTrace().back(), x);
+    }
+
+    /** An eccentric Kepler orbit, with split right-hand sides: the energy doesn't drift */
+    void TestKeplerOrbit()
+    {
+        // Eccentricity 0.5, starting at perihelion; the period is 2*pi for the semi-major axis of 1
+        State<4> initial_values = {{0.5, 0.0, 0.0, sqrt(3.0)}};
+        const double energy = KeplerEnergy(initial_values);
+        TS_ASSERT_DELTA(energy, -0.5, 1e-12);
+
+        Yoshida4OdeSolverT<State<4> > solver;
+        solver.SetInitialValues(initial_values);
+        solver.SetSplitRhsFunctions(&KeplerPositionRhs, &KeplerForce);
+        solver.SetInitialTimeNumberOfStepsAndFinalTime(0.0, 200*100, 2*M_PI*100);
+        solver.SetStructureOfArraysTrace(true);
+        solver.Solve();
+        SolutionTraceT<State<4> > trace = solver.TakeTrace();
+        double max_energy_error = 0.0;
+        for (unsigned i=0; i<trace.times.size(); i++)
+        {
+            State<4> v = {{trace.components[0][i], trace.components[1][i], trace.components[2][i], trace.components[3][i]}};
+            max_energy_error = std::max(max_energy_error, fabs(KeplerEnergy(v) - energy));
+        }
+        TS_ASSERT_LESS_THAN(max_energy_error, 1e-4);
+        // Back at perihelion after 100 orbits
+        TS_ASSERT_DELTA(trace.components[0].back(), 0.5, 1e-2);
+        TS_ASSERT_DELTA(trace.components[1].back(), 0.0, 1e-1);
+    }
+};
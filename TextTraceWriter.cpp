@@ -0,0 +1,219 @@
+/*
+ * TextTraceWriter.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include <charconv>
+#include <unistd.h>
+#include "Exception.hpp"
+#include "TextTraceWriter.hpp"
+
+/** Size of the formatted text buffer */
+static const std::size_t TEXT_BUFFER_SIZE = 1 << 20;
+/** Room for one formatted number and its separator: the shortest round-trip form of a double is at most 24 characters */
+static const std::size_t MAX_NUMBER_LENGTH = 32;
+/** Rows per block handed to the background thread, and the most blocks that can be queued */
+static const std::size_t ROWS_PER_BLOCK = 16384;
+static const std::size_t MAX_QUEUED_BLOCKS = 2;
+
+TextTraceWriter::TextTraceWriter(const std::string& fileName, unsigned columns, bool background, int64_t appendAt)
+    : mColumns(columns),
+      mpFile(NULL),
+      mTextBuffer(TEXT_BUFFER_SIZE),
+      mTextUsed(0),
+      mBackground(background),
+      mFinished(false),
+      mFlushRequested(false),
+      mWriteFailed(false)
+{
+    if (columns == 0)
+    {
+        throw Exception("OdePost", "A trace needs at least one column");
+    }
+    if (appendAt < 0)
+    {
+        mpFile = std::fopen(fileName.c_str(), "w");
+    }
+    else
+    {
+        mpFile = std::fopen(fileName.c_str(), "r+");
+        if (mpFile != NULL && (ftruncate(fileno(mpFile), appendAt) != 0 || std::fseek(mpFile, 0, SEEK_END) != 0))
+        {
+            std::fclose(mpFile);
+            mpFile = NULL;
+        }
+    }
+    if (mpFile == NULL)
+    {
+        throw Exception("OdePost", "Can't open output file");
+    }
+    if (mBackground)
+    {
+        mBlock.reserve(ROWS_PER_BLOCK*mColumns);
+        mWriterThread = std::thread(&TextTraceWriter::BackgroundLoop, this);
+    }
+}
+
+TextTraceWriter::~TextTraceWriter()
+{
+    try
+    {
+        Close();
+    }
+    catch (Exception&)
+    {
+        // Nothing can be done about it here
+    }
+}
+
+void TextTraceWriter::FormatRow(const double* pValues)
+{
+    if (mTextUsed + mColumns*MAX_NUMBER_LENGTH > mTextBuffer.size())
+    {
+        FlushText();
+    }
+    char* p_text = &mTextBuffer[mTextUsed];
+    for (unsigned i=0; i<mColumns; i++)
+    {
+        p_text = std::to_chars(p_text, p_text + MAX_NUMBER_LENGTH, pValues[i]).ptr;
+        *p_text++ = (i + 1 < mColumns) ? '\t' : '\n';
+    }
+    mTextUsed = p_text - &mTextBuffer[0];
+}
+
+void TextTraceWriter::FlushText()
+{
+    if (mTextUsed > 0 && std::fwrite(&mTextBuffer[0], 1, mTextUsed, mpFile) != mTextUsed)
+    {
+        mWriteFailed = true;
+    }
+    mTextUsed = 0;
+}
+
+void TextTraceWriter::WriteRow(const double* pValues)
+{
+    if (mpFile == NULL)
+    {
+        throw Exception("OdePost", "Output file has been closed");
+    }
+    if (!mBackground)
+    {
+        FormatRow(pValues);
+        return;
+    }
+    mBlock.insert(mBlock.end(), pValues, pValues + mColumns);
+    if (mBlock.size() == ROWS_PER_BLOCK*mColumns)
+    {
+        QueueBlock();
+    }
+}
+
+void TextTraceWriter::QueueBlock()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mQueueChanged.wait(lock, [this]() { return mQueue.size() < MAX_QUEUED_BLOCKS; });
+    mQueue.push_back(std::vector<double>());
+    mQueue.back().swap(mBlock);
+    lock.unlock();
+    mQueueChanged.notify_all();
+    mBlock.reserve(ROWS_PER_BLOCK*mColumns);
+}
+
+void TextTraceWriter::BackgroundLoop()
+{
+    std::vector<double> block;
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mQueueChanged.wait(lock, [this]() { return !mQueue.empty() || mFinished || mFlushRequested; });
+        if (mQueue.empty() && mFlushRequested)
+        {
+            // Everything queued has been formatted
+            FlushText();
+            mFlushRequested = false;
+            lock.unlock();
+            mQueueChanged.notify_all();
+            continue;
+        }
+        if (mQueue.empty())
+        {
+            break; // Finished, and nothing left to write
+        }
+        block.swap(mQueue.front());
+        mQueue.pop_front();
+        lock.unlock();
+        mQueueChanged.notify_all();
+
+        for (std::size_t i=0; i<block.size(); i+=mColumns)
+        {
+            FormatRow(&block[i]);
+        }
+        block.clear();
+    }
+    FlushText();
+}
+
+uint64_t TextTraceWriter::Flush()
+{
+    if (mpFile == NULL)
+    {
+        throw Exception("OdePost", "Output file has been closed");
+    }
+    if (mBackground)
+    {
+        if (!mBlock.empty())
+        {
+            QueueBlock();
+        }
+        std::unique_lock<std::mutex> lock(mMutex);
+        mFlushRequested = true;
+        mQueueChanged.notify_all();
+        mQueueChanged.wait(lock, [this]() { return !mFlushRequested; });
+    }
+    else
+    {
+        FlushText();
+    }
+    if (std::fflush(mpFile) != 0 || fsync(fileno(mpFile)) != 0)
+    {
+        mWriteFailed = true;
+    }
+    if (mWriteFailed)
+    {
+        throw Exception("OdePost", "Failed writing output file");
+    }
+    return std::ftell(mpFile);
+}
+
+void TextTraceWriter::Close()
+{
+    if (mpFile == NULL)
+    {
+        return;
+    }
+    if (mBackground)
+    {
+        if (!mBlock.empty())
+        {
+            QueueBlock();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mFinished = true;
+        }
+        mQueueChanged.notify_all();
+        mWriterThread.join();
+    }
+    else
+    {
+        FlushText();
+    }
+    bool close_failed = (std::fclose(mpFile) != 0);
+    mpFile = NULL;
+    if (mWriteFailed || close_failed)
+    {
+        throw Exception("OdePost", "Failed writing output file");
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * TextTraceWriter.hpp
+ *
+ * Fast writer for the tab-separated text traces
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef TEXTTRACEWRITER_HPP_
+#define TEXTTRACEWRITER_HPP_
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Writes rows of column data
+ * time     x-value     y-value ...
+ * with each number in its shortest form that reads back to exactly the same double (std::to_chars).
+ * Rows are formatted into a large buffer which is written out when full.
+ *
+ * In background mode WriteRow() just copies the numbers into a block; full blocks are formatted and
+ * written by a separate thread, so the caller (usually a solver) can carry on integrating.  At most
+ * a couple of blocks are queued, so memory use stays bounded if the disk can't keep up.
+ */
+class TextTraceWriter
+{
+private:
+    /** Number of values in each row */
+    unsigned mColumns;
+    std::FILE* mpFile;
+
+    /** Formatted text waiting to be written (foreground mode, and inside the background thread) */
+    std::vector<char> mTextBuffer;
+    std::size_t mTextUsed;
+
+    bool mBackground;
+    /** Rows collected by WriteRow() in background mode */
+    std::vector<double> mBlock;
+    /** Full blocks waiting for the background thread */
+    std::deque<std::vector<double> > mQueue;
+    std::mutex mMutex;
+    std::condition_variable mQueueChanged;
+    bool mFinished;
+    /** Set by Flush() in background mode until the background thread has written everything queued */
+    bool mFlushRequested;
+    bool mWriteFailed;
+    std::thread mWriterThread;
+
+    /** Formats one row onto the end of the text buffer, writing the buffer out first if it is nearly full */
+    void FormatRow(const double* pValues);
+    void FlushText();
+    void QueueBlock();
+    void BackgroundLoop();
+
+    // Not copyable: owns a file and a thread
+    TextTraceWriter(const TextTraceWriter&);
+    TextTraceWriter& operator=(const TextTraceWriter&);
+
+public:
+    /**
+     * Opens (and truncates) the file.  With a non-negative appendAt the existing file is cut back to
+     * that many bytes instead and written on the end of (to carry on from a checkpoint).  Throws if
+     * it can't be opened.
+     */
+    TextTraceWriter(const std::string& fileName, unsigned columns, bool background=false, int64_t appendAt=-1);
+
+    /** Closes the file if Close() hasn't been called (errors are lost: call Close() to see them) */
+    ~TextTraceWriter();
+
+    /** Adds a row of GetNumberOfColumns() values */
+    void WriteRow(const double* pValues);
+
+    /**
+     * Writes everything so far out to the file and syncs it to disk, returning the length of the
+     * file in bytes.  Throws if anything failed to write.
+     */
+    uint64_t Flush();
+
+    /** Writes everything out and closes the file.  Throws if anything failed to write */
+    void Close();
+
+    unsigned GetNumberOfColumns() const
+    {
+        return mColumns;
+    }
+};
+
+#endif /* TEXTTRACEWRITER_HPP_ */
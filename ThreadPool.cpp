@@ -0,0 +1,149 @@
+/*
+ * ThreadPool.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include <algorithm>
+#include "ThreadPool.hpp"
+
+WorkStealingThreadPool::WorkStealingThreadPool(unsigned numberOfThreads)
+    : mpTask(NULL),
+      mRemaining(0),
+      mGeneration(0),
+      mShutdown(false)
+{
+    if (numberOfThreads == 0)
+    {
+        numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i=0; i<numberOfThreads; i++)
+    {
+        mQueues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue));
+    }
+    for (unsigned i=0; i<numberOfThreads; i++)
+    {
+        mWorkers.push_back(std::thread(&WorkStealingThreadPool::WorkerLoop, this, i));
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShutdown = true;
+    }
+    mWorkAvailable.notify_all();
+    for (unsigned i=0; i<mWorkers.size(); i++)
+    {
+        mWorkers[i].join();
+    }
+}
+
+unsigned WorkStealingThreadPool::GetNumberOfThreads() const
+{
+    return mWorkers.size();
+}
+
+bool WorkStealingThreadPool::TakeTask(unsigned worker, std::size_t& rIndex)
+{
+    // Own queue first, newest task first
+    {
+        WorkQueue& r_own = *mQueues[worker];
+        std::lock_guard<std::mutex> lock(r_own.mutex);
+        if (!r_own.tasks.empty())
+        {
+            rIndex = r_own.tasks.back();
+            r_own.tasks.pop_back();
+            return true;
+        }
+    }
+    // Then steal the oldest task from someone else
+    for (unsigned offset=1; offset<mQueues.size(); offset++)
+    {
+        WorkQueue& r_victim = *mQueues[(worker + offset) % mQueues.size()];
+        std::lock_guard<std::mutex> lock(r_victim.mutex);
+        if (!r_victim.tasks.empty())
+        {
+            rIndex = r_victim.tasks.front();
+            r_victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::WorkerLoop(unsigned worker)
+{
+    unsigned long seen_generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkAvailable.wait(lock, [&]() { return mShutdown || mGeneration != seen_generation; });
+            if (mShutdown)
+            {
+                return;
+            }
+            seen_generation = mGeneration;
+        }
+
+        std::size_t index;
+        while (TakeTask(worker, index))
+        {
+            try
+            {
+                (*mpTask)(index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mFirstException)
+                {
+                    mFirstException = std::current_exception();
+                }
+            }
+            if (--mRemaining == 0)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mWorkFinished.notify_all();
+            }
+        }
+    }
+}
+
+void WorkStealingThreadPool::ParallelFor(std::size_t count, const std::function<void(std::size_t)>& rTask)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mMutex);
+    mpTask = &rTask;
+    mFirstException = std::exception_ptr();
+    mRemaining = count;
+
+    // Deal the tasks out in contiguous blocks, one per worker
+    const std::size_t workers = mQueues.size();
+    for (std::size_t w=0; w<workers; w++)
+    {
+        WorkQueue& r_queue = *mQueues[w];
+        std::lock_guard<std::mutex> queue_lock(r_queue.mutex);
+        for (std::size_t i=(count*w)/workers; i<(count*(w + 1))/workers; i++)
+        {
+            r_queue.tasks.push_back(i);
+        }
+    }
+    mGeneration++;
+    mWorkAvailable.notify_all();
+
+    mWorkFinished.wait(lock, [this]() { return mRemaining == 0; });
+    mpTask = NULL;
+    if (mFirstException)
+    {
+        std::exception_ptr exception = mFirstException;
+        mFirstException = std::exception_ptr();
+        std::rethrow_exception(exception);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * ThreadPool.hpp
+ *
+ * Work-stealing pool of threads for running many independent solves at once
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef THREADPOOL_HPP_
+#define THREADPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of worker threads.  ParallelFor() deals the task indices out to the workers in
+ * contiguous blocks; each worker takes tasks from the back of its own queue and, when that is
+ * empty, steals from the front of the others' queues.  Uneven task costs (e.g. solves that need
+ * very different numbers of steps) are therefore balanced without any central queue.
+ */
+class WorkStealingThreadPool
+{
+private:
+    /** One worker's tasks */
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    std::vector<std::thread> mWorkers;
+    std::vector<std::unique_ptr<WorkQueue> > mQueues;
+
+    /** The task being run by ParallelFor() */
+    const std::function<void(std::size_t)>* mpTask;
+    /** Number of tasks not yet finished */
+    std::atomic<std::size_t> mRemaining;
+    /** First exception thrown by a task, rethrown by ParallelFor() */
+    std::exception_ptr mFirstException;
+
+    std::mutex mMutex;
+    std::condition_variable mWorkAvailable;
+    std::condition_variable mWorkFinished;
+    /** Incremented for every ParallelFor(), so that the workers know there is new work */
+    unsigned long mGeneration;
+    bool mShutdown;
+
+    bool TakeTask(unsigned worker, std::size_t& rIndex);
+    void WorkerLoop(unsigned worker);
+
+    // Not copyable: owns threads
+    WorkStealingThreadPool(const WorkStealingThreadPool&);
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&);
+
+public:
+    /** Starts the workers.  Zero means one per core */
+    WorkStealingThreadPool(unsigned numberOfThreads=0);
+    ~WorkStealingThreadPool();
+
+    unsigned GetNumberOfThreads() const;
+
+    /**
+     * Calls rTask(i) for i = 0, ..., count-1 on the workers, and returns when they have all finished.
+     * If any task throws then the first exception is rethrown here (after the other tasks finish).
+     * Only one ParallelFor() can run on a pool at a time.
+     */
+    void ParallelFor(std::size_t count, const std::function<void(std::size_t)>& rTask);
+};
+
+#endif /* THREADPOOL_HPP_ */
@@ -0,0 +1,169 @@
+/*
+ * TraceFile.cpp
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Exception.hpp"
+#include "TraceFile.hpp"
+
+static_assert(sizeof(BinaryTraceHeader) == 64, "Binary trace header should be 64 bytes");
+
+BinaryTraceHeader MakeBinaryTraceHeader(unsigned dimension, std::size_t numberOfPoints, double timeStepSize,
+                                        const std::string& solverName)
+{
+    const uint32_t one = 1;
+    if (*reinterpret_cast<const unsigned char*>(&one) != 1)
+    {
+        throw Exception("OdePost", "Binary traces can only be written on little-endian machines");
+    }
+
+    BinaryTraceHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "ODETRACE", 8);
+    header.version = BINARY_TRACE_VERSION;
+    header.dimension = dimension;
+    header.numberOfPoints = numberOfPoints;
+    header.timeStepSize = timeStepSize;
+    std::strncpy(header.solverName, solverName.c_str(), sizeof(header.solverName) - 1);
+    return header;
+}
+
+LoadedTrace::LoadedTrace(const std::string& fileName)
+    : mpMapping(NULL),
+      mMappingSize(0),
+      mpData(NULL)
+{
+    int file = open(fileName.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        throw Exception("OdeLoad", "Can't open trace file");
+    }
+    struct stat file_status;
+    if (fstat(file, &file_status) != 0 || std::size_t(file_status.st_size) < sizeof(BinaryTraceHeader))
+    {
+        close(file);
+        throw Exception("OdeLoad", "Trace file is too short");
+    }
+    mMappingSize = file_status.st_size;
+    mpMapping = mmap(NULL, mMappingSize, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file); // The mapping keeps the file open
+    if (mpMapping == MAP_FAILED)
+    {
+        mpMapping = NULL;
+        throw Exception("OdeLoad", "Can't map trace file");
+    }
+
+    std::memcpy(&mHeader, mpMapping, sizeof(mHeader));
+    mHeader.solverName[sizeof(mHeader.solverName) - 1] = '\0';
+    std::size_t expected_size = sizeof(BinaryTraceHeader)
+            + sizeof(double)*(std::size_t(mHeader.dimension) + 1)*mHeader.numberOfPoints;
+    if (std::memcmp(mHeader.magic, "ODETRACE", 8) != 0 || mHeader.version != BINARY_TRACE_VERSION
+        || mMappingSize != expected_size)
+    {
+        Unmap();
+        throw Exception("OdeLoad", "Not a binary trace file (or it is truncated)");
+    }
+    mpData = reinterpret_cast<const double*>(static_cast<const char*>(mpMapping) + sizeof(BinaryTraceHeader));
+}
+
+LoadedTrace::LoadedTrace(LoadedTrace&& rOther)
+    : mpMapping(rOther.mpMapping),
+      mMappingSize(rOther.mMappingSize),
+      mHeader(rOther.mHeader),
+      mpData(rOther.mpData)
+{
+    rOther.mpMapping = NULL;
+    rOther.mpData = NULL;
+}
+
+LoadedTrace::~LoadedTrace()
+{
+    Unmap();
+}
+
+void LoadedTrace::Unmap()
+{
+    if (mpMapping != NULL)
+    {
+        munmap(mpMapping, mMappingSize);
+        mpMapping = NULL;
+    }
+}
+
+unsigned LoadedTrace::GetDimension() const
+{
+    return mHeader.dimension;
+}
+
+std::size_t LoadedTrace::GetNumberOfTimePoints() const
+{
+    return mHeader.numberOfPoints;
+}
+
+double LoadedTrace::GetTimeStepSize() const
+{
+    return mHeader.timeStepSize;
+}
+
+std::string LoadedTrace::GetSolverName() const
+{
+    return std::string(mHeader.solverName);
+}
+
+TraceView LoadedTrace::GetTimeView() const
+{
+    return TraceView(mpData, mHeader.numberOfPoints);
+}
+
+TraceView LoadedTrace::GetComponentView(int component) const
+{
+    if (component < 0 || unsigned(component) >= mHeader.dimension)
+    {
+        throw Exception("OdePost", "No such component in the state");
+    }
+    return TraceView(mpData + (std::size_t(component) + 1)*mHeader.numberOfPoints, mHeader.numberOfPoints);
+}
+
+TraceView LoadedTrace::GetXView() const
+{
+    return GetComponentView(0);
+}
+
+TraceView LoadedTrace::GetYView() const
+{
+    return GetComponentView(1);
+}
+
+std::vector<double> LoadedTrace::GetTimeTrace() const
+{
+    TraceView times = GetTimeView();
+    return std::vector<double>(times.data(), times.data() + times.size());
+}
+
+std::vector<double> LoadedTrace::GetComponentTrace(int component) const
+{
+    TraceView values = GetComponentView(component);
+    return std::vector<double>(values.data(), values.data() + values.size());
+}
+
+std::vector<double> LoadedTrace::GetXTrace() const
+{
+    return GetComponentTrace(0);
+}
+
+std::vector<double> LoadedTrace::GetYTrace() const
+{
+    return GetComponentTrace(1);
+}
+
+LoadedTrace LoadTrace(const std::string& fileName)
+{
+    return LoadedTrace(fileName);
+}
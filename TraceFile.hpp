@@ -0,0 +1,90 @@
+/*
+ * TraceFile.hpp
+ *
+ * Binary trace files: written by AbstractOdeSolverT::DumpToBinaryFile() and memory-mapped by LoadTrace()
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef TRACEFILE_HPP_
+#define TRACEFILE_HPP_
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "TraceView.hpp"
+
+/**
+ * The file starts with this 64 byte header.  All numbers are little-endian.  It is followed by the
+ * number-of-points times as doubles, then the values of component 0 at those times, then
+ * component 1, and so on.  With numpy:
+ *      data = numpy.memmap(name, dtype='<f8', mode='r', offset=64, shape=(dimension+1, number_of_points))
+ * gives the times as data[0] and component j as data[j+1].
+ */
+struct BinaryTraceHeader
+{
+    char magic[8];               ///< "ODETRACE"
+    uint32_t version;            ///< Format version (1)
+    uint32_t dimension;          ///< Number of components in the state
+    uint64_t numberOfPoints;     ///< Number of time-points
+    double timeStepSize;         ///< The solver's (first) time-step
+    char solverName[32];         ///< Name of the solver that made the trace (null-terminated)
+};
+
+/** Version of the format written by this code */
+const uint32_t BINARY_TRACE_VERSION = 1;
+
+/** Fills in a header, checking that the host is little-endian so that the data can be written directly */
+BinaryTraceHeader MakeBinaryTraceHeader(unsigned dimension, std::size_t numberOfPoints, double timeStepSize,
+                                        const std::string& solverName);
+
+/**
+ * A binary trace file mapped into memory.  The accessors match those of a solver, and the views
+ * point straight into the mapped file (with stride 1) so no data is copied.  Views are only valid
+ * while this object exists.
+ */
+class LoadedTrace
+{
+private:
+    /** The mapped file (or NULL) and its length in bytes */
+    void* mpMapping;
+    std::size_t mMappingSize;
+
+    BinaryTraceHeader mHeader;
+    /** Start of the times; the components follow */
+    const double* mpData;
+
+    void Unmap();
+
+    // Not copyable: the mapping is owned
+    LoadedTrace(const LoadedTrace&);
+    LoadedTrace& operator=(const LoadedTrace&);
+
+public:
+    /** Maps the file.  Throws if it can't be read or isn't a binary trace */
+    LoadedTrace(const std::string& fileName);
+    LoadedTrace(LoadedTrace&& rOther);
+    ~LoadedTrace();
+
+    unsigned GetDimension() const;
+    std::size_t GetNumberOfTimePoints() const;
+    double GetTimeStepSize() const;
+    std::string GetSolverName() const;
+
+    TraceView GetTimeView() const;
+    TraceView GetComponentView(int component) const;
+    TraceView GetXView() const;
+    TraceView GetYView() const;
+
+    std::vector<double> GetTimeTrace() const;
+    std::vector<double> GetComponentTrace(int component) const;
+    std::vector<double> GetXTrace() const;
+    std::vector<double> GetYTrace() const;
+};
+
+/** Maps a binary trace file written by DumpToBinaryFile() */
+LoadedTrace LoadTrace(const std::string& fileName);
+
+#endif /* TRACEFILE_HPP_ */
@@ -0,0 +1,64 @@
+/*
+ * TraceView.hpp
+ *
+ * Non-owning, read-only views of the stored traces
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef TRACEVIEW_HPP_
+#define TRACEVIEW_HPP_
+
+#include <cstddef>
+
+/**
+ * A read-only view of a sequence of numbers (of type T) that are evenly spaced in memory (stride 1
+ * for a plain array, or the state dimension for one component of an array of states).  It doesn't
+ * own or copy the data, so it is only valid until the solver that made it is solved again or destroyed.
+ */
+template<class T>
+class TraceViewT
+{
+private:
+    const T* mpData;
+    std::size_t mSize;
+    std::size_t mStride;
+
+public:
+    /** Random-access style iterator, enough for range-based for loops and standard algorithms */
+    class const_iterator
+    {
+    private:
+        const T* mpCurrent;
+        std::size_t mStride;
+    public:
+        const_iterator(const T* pCurrent, std::size_t stride) : mpCurrent(pCurrent), mStride(stride) {}
+        const T& operator*() const { return *mpCurrent; }
+        const_iterator& operator++() { mpCurrent += mStride; return *this; }
+        bool operator==(const const_iterator& rOther) const { return mpCurrent == rOther.mpCurrent; }
+        bool operator!=(const const_iterator& rOther) const { return mpCurrent != rOther.mpCurrent; }
+    };
+
+    TraceViewT() : mpData(NULL), mSize(0), mStride(1) {}
+    TraceViewT(const T* pData, std::size_t size, std::size_t stride=1) : mpData(pData), mSize(size), mStride(stride) {}
+
+    const T& operator[](std::size_t i) const { return mpData[i*mStride]; }
+    std::size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+    const T& front() const { return mpData[0]; }
+    const T& back() const { return mpData[(mSize-1)*mStride]; }
+
+    /** Distance in numbers between neighbouring entries: 1 means the data are contiguous */
+    std::size_t stride() const { return mStride; }
+    /** The first entry, for passing contiguous (stride 1) data straight to other code */
+    const T* data() const { return mpData; }
+
+    const_iterator begin() const { return const_iterator(mpData, mStride); }
+    const_iterator end() const { return const_iterator(mpData + mSize*mStride, mStride); }
+};
+
+/** A view of doubles: the time trace, and the solution of double precision states */
+typedef TraceViewT<double> TraceView;
+
+#endif /* TRACEVIEW_HPP_ */
@@ -0,0 +1,13 @@
+/*
+ * Yoshida4OdeSolver.cpp
+ *
+ * Implements the fourth order Forest-Ruth/Yoshida symplectic solver
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#include "Yoshida4OdeSolver.hpp"
+
+// The methods are templates defined in the header.  The 2-D (Pair) version is compiled here once.
+template class Yoshida4OdeSolverT<Pair>;
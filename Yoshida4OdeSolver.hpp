@@ -0,0 +1,97 @@
+/*
+ * Yoshida4OdeSolver.hpp
+ *
+ * Implements the fourth order Forest-Ruth/Yoshida symplectic solver
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: adathy
+ */
+
+#ifndef YOSHIDA4ODESOLVER_HPP_
+#define YOSHIDA4ODESOLVER_HPP_
+
+#include "AbstractSymplecticOdeSolver.hpp"
+
+/**
+ * Fourth order symplectic method of Forest & Ruth (1990) and Yoshida (1990): three Stormer-Verlet
+ * steps of dt*w1, dt*w0, dt*w1 with
+ *     w1 = 1/(2 - 2^(1/3)),  w0 = -2^(1/3)/(2 - 2^(1/3))
+ * (the middle one is backwards in time).  The merged kicks leave three force evaluations per step.
+ */
+template<class STATE>
+class Yoshida4OdeSolverT: public AbstractSymplecticOdeSolverT<STATE> {
+public:
+	Yoshida4OdeSolverT();
+	virtual ~Yoshida4OdeSolverT();
+
+	std::string GetSolverName() const {
+		return "Yoshida4";
+	}
+
+	/**
+	 * Solve with the function pointers set by SetSplitRhsFunctions() or, if that wasn't called,
+	 * with the one set by SetRhsFunction() for both halves
+	 */
+	void Solve();
+
+	/** Solve with any callable right-hand side rhs(v, t, dvdt) for a separable system */
+	template<class RHS>
+	void Solve(RHS rhs);
+
+	/** Solve with any callable position right-hand side and force */
+	template<class POSITION_RHS, class FORCE>
+	void Solve(POSITION_RHS positionRhs, FORCE force);
+
+	/** Advance v over one time step from time t to t+dt */
+	template<class POSITION_RHS, class FORCE>
+	void TakeStep(POSITION_RHS& rPositionRhs, FORCE& rForce, double t, double dt, STATE& v);
+};
+
+template<class STATE>
+Yoshida4OdeSolverT<STATE>::Yoshida4OdeSolverT() {
+}
+
+template<class STATE>
+Yoshida4OdeSolverT<STATE>::~Yoshida4OdeSolverT() {
+}
+
+template<class STATE>
+void Yoshida4OdeSolverT<STATE>::Solve() {
+	if (this->mpPositionRhsFunction != NULL) {
+		Solve(this->mpPositionRhsFunction, this->mpForceFunction);
+		return;
+	}
+	if (this->mpRhsFunction == NULL) {
+		throw Exception("OdeSolve", "Please define the right hand side function");
+	}
+	Solve(this->mpRhsFunction);
+}
+
+template<class STATE>
+template<class RHS>
+void Yoshida4OdeSolverT<STATE>::Solve(RHS rhs) {
+	Solve(rhs, rhs);
+}
+
+template<class STATE>
+template<class POSITION_RHS, class FORCE>
+void Yoshida4OdeSolverT<STATE>::Solve(POSITION_RHS positionRhs, FORCE force) {
+	this->RunSymplecticTimeSteps(*this, positionRhs, force);
+}
+
+template<class STATE>
+template<class POSITION_RHS, class FORCE>
+void Yoshida4OdeSolverT<STATE>::TakeStep(POSITION_RHS& rPositionRhs, FORCE& rForce, double t, double dt, STATE& v) {
+	const double w1 = 1.0/(2.0 - cbrt(2.0));
+	const double w0 = 1.0 - 2.0*w1;
+	const double kicks[4] = {0.5*w1, 0.5*(w1 + w0), 0.5*(w0 + w1), 0.5*w1};
+	const double drifts[3] = {w1, w0, w1};
+	this->TakeCompositionStep(rPositionRhs, rForce, t, dt, v, kicks, drifts, 3);
+}
+
+/** The 2-D solver: x is the position and y the velocity */
+typedef Yoshida4OdeSolverT<Pair> Yoshida4OdeSolver;
+// Compiled once in Yoshida4OdeSolver.cpp
+extern template class Yoshida4OdeSolverT<Pair>;
+
+#endif /* YOSHIDA4ODESOLVER_HPP_ */
@@ -0,0 +1,22 @@
+import struct
+
+import numpy as np
+
+
+def load_trace(file_name):
+    """Map a binary trace written by DumpToBinaryFile() without copying it.
+
+    Returns (header, data) where data[0] is the times and data[j+1] is component j.
+    """
+    with open(file_name, 'rb') as trace_file:
+        magic, version, dimension, number_of_points, time_step_size, solver_name = \
+            struct.unpack('<8sIIQd32s', trace_file.read(64))
+    if magic != b'ODETRACE' or version != 1:
+        raise ValueError("%s is not a binary trace file" % file_name)
+
+    header = {"dimension": dimension,
+              "number_of_points": number_of_points,
+              "time_step_size": time_step_size,
+              "solver": solver_name.split(b'\0', 1)[0].decode()}
+    data = np.memmap(file_name, dtype='<f8', mode='r', offset=64, shape=(dimension + 1, number_of_points))
+    return header, data